@@ -133,19 +133,21 @@ static FP_INT FP64_RoundToInt(FP_LONG v) {
     return (FP_INT) ((v + Half) >> FP64_Shift);
 }
 
+#ifndef __KERNEL__ // No floating point in the kernel, these are for the userspace builds (see lib/)
 /// <summary>
 /// Converts a fixed-point value into a double.
 /// </summary>
-// static double FP64_ToDouble(FP_LONG v) {
-//     return (double) v * (1.0 / 4294967296.0);
-// }
+static double FP64_ToDouble(FP_LONG v) {
+    return (double) v * (1.0 / 4294967296.0);
+}
 
 /// <summary>
 /// Converts a FP value into a float.
 /// </summary>
-// static float FP64_ToFloat(FP_LONG v) {
-//     return (float) v * (1.0f / 4294967296.0f);
-// }
+static float FP64_ToFloat(FP_LONG v) {
+    return (float) v * (1.0f / 4294967296.0f);
+}
+#endif
 
 /// <summary>
 /// Converts the value to a human readable string.
@@ -823,7 +825,7 @@ static FP_LONG FP64_RcpFastest(FP_LONG x) {
 /// </summary>
 static FP_LONG FP64_Exp2(FP_LONG x) {
     // Handle values that would under or overflow.
-    if (x >= 32 * One) return MaxValue;
+    if (x >= 31 * One) return MaxValue; // 2^31 is already past the integer part
     if (x <= -32 * One) return 0;
 
     // Compute exp2 for fractional part.
@@ -840,7 +842,7 @@ static FP_LONG FP64_Exp2(FP_LONG x) {
 /// </summary>
 static FP_LONG FP64_Exp2Fast(FP_LONG x) {
     // Handle values that would under or overflow.
-    if (x >= 32 * One) return MaxValue;
+    if (x >= 31 * One) return MaxValue; // 2^31 is already past the integer part
     if (x <= -32 * One) return 0;
 
     // Compute exp2 for fractional part.
@@ -857,7 +859,7 @@ static FP_LONG FP64_Exp2Fast(FP_LONG x) {
 /// </summary>
 static FP_LONG Exp2Fastest(FP_LONG x) {
     // Handle values that would under or overflow.
-    if (x >= 32 * One) return MaxValue;
+    if (x >= 31 * One) return MaxValue; // 2^31 is already past the integer part
     if (x <= -32 * One) return 0;
 
     // Compute exp2 for fractional part.
@@ -1384,6 +1386,12 @@ static FP_LONG FP64_AtanFastest(FP_LONG x) {
 }
 
 static FP_LONG FP64_Tanh(FP_LONG x) {
+    // Saturated (to the last bit) long before doubling x can overflow
+    if (x > (16ll << FP64_Shift))
+        return One;
+    if (x < -(16ll << FP64_Shift))
+        return Neg1;
+
     // tanh(x) = 1 - 2 / (1 + exp(2x))
     FP_LONG two_x = x << 1;
     // This is safe for big x values because FP64_Exp 'clamps'
@@ -1574,6 +1582,36 @@ static int FP64_FromString(const char *buf, FP_LONG *val) {
     return buf - start_pos;
 }
 
+// Like FP64_ToString(), with the fewest decimals (10 at most) that FP64_FromString() reads back as exactly 'value'
+static void FP64_ToStringExact(FP_LONG value, char *buf) {
+    uint64_t uvalue = (value >= 0) ? (uint64_t)value : 0 - (uint64_t)value; // No overflow for INT64_MIN
+    if (value < 0)
+        *buf++ = '-';
+
+    uint64_t intpart = uvalue >> 32;
+    uint64_t fracpart = uvalue & 0xFFFFFFFF;
+    uint64_t digits = 0;
+    int decimals;
+
+    /* Rounded up, as FP64_FromString() truncates */
+    for (decimals = 1; decimals < 10; decimals++) {
+        digits = (fracpart * FP_64_scales[decimals] + 0xFFFFFFFF) >> 32;
+        if ((uint64_t)FP64_DivPrecise(digits, FP_64_scales[decimals]) == fracpart)
+            break;
+    }
+
+    /* 10 decimals always read back exactly (10^10 > 2^32), the product is split to fit in 64 bits */
+    if (decimals == 10) {
+        uint64_t high = fracpart * 100000;
+        digits = (high >> 32) * 100000 + (((high & 0xFFFFFFFF) * 100000 + 0xFFFFFFFF) >> 32);
+    }
+
+    buf = FP_64_itoa_loop(buf, 1000000000, intpart, 1);
+    *buf++ = '.';
+    buf = FP_64_itoa_loop(buf, FP_64_scales[decimals - 1], digits, 0);
+    *buf = '\0';
+}
+
 
 #undef FP_ASSERT
 
@@ -7,11 +7,23 @@
 #include <linux/module.h>
 #include <linux/time.h>
 #include <linux/string.h>   //strlen
+#include <linux/slab.h>
+#include <linux/preempt.h>
+#include <linux/rcupdate.h>
+#include <linux/mutex.h>
 #include "FixedMath/Fixed64.h"
 #include "../shared_definitions.h"
 #include "accel_modes.h"
+#include "accel_pipeline.h"
 #include "defaults.h"
 
+#ifdef FIXED_PROFILE
+// Built for the profile in config.h only ('make driver_fixed'). The modes are compiled in here, next to the constant
+// profile, so that the compiler can specialize them for it.
+#include "accel_modes.c"
+#include "fixed_profile.h"
+#endif
+
 MODULE_AUTHOR("Christopher Williams <chilliams (at) gmail (dot) com>"); //Original idea of this module
 MODULE_AUTHOR("Klaus Zipfel <klaus (at) zipfel (dot) family>");         //Current maintainer
 MODULE_AUTHOR("Maciej Grzęda <gmaciejg525 (at) gmail (dot) com>");      // Current maintainer
@@ -23,7 +35,6 @@ MODULE_AUTHOR("Maciej Grzęda <gmaciejg525 (at) gmail (dot) com>");      // Curr
 
 //Convenient helper for float based parameters, which are passed via a string to this module (must be individually parsed via atof() - available in util.c)
 #define PARAM_F(param, default, desc)                           \
-    FP_LONG g_##param = C0NST_FP64_FromDouble(default);                     \
     char* g_param_##param = s(default);                  \
     module_param_named(param, g_param_##param, charp, 0644);    \
     MODULE_PARM_DESC(param, desc);
@@ -44,11 +55,30 @@ MODULE_AUTHOR("Maciej Grzęda <gmaciejg525 (at) gmail (dot) com>");      // Curr
     module_param_named(param, g_##param, ulong, 0644);           \
     MODULE_PARM_DESC(param, desc);
 
+// Parameters with custom handling, the callbacks are called in process context (and serialized by the kernel)
+#define PARAM_CB(param, ops, arg, perm, desc)                   \
+    module_param_cb(param, ops, arg, perm);                     \
+    MODULE_PARM_DESC(param, desc);
+
+static int update_set(const char *val, const struct kernel_param *kp);
+static int profile_set(const char *val, const struct kernel_param *kp);
+static int profile_get(char *buffer, const struct kernel_param *kp);
+static int profile_version_get(char *buffer, const struct kernel_param *kp);
+static int active_profile_set(const char *val, const struct kernel_param *kp);
+static int active_profile_get(char *buffer, const struct kernel_param *kp);
+static int profile_print(char *buf, size_t size, const struct accel_profile *profile, unsigned int slot);
+
+static const struct kernel_param_ops update_ops = { .set = update_set, .get = param_get_byte };
+static const struct kernel_param_ops profile_ops = { .set = profile_set, .get = profile_get };
+static const struct kernel_param_ops profile_version_ops = { .get = profile_version_get };
+static const struct kernel_param_ops active_profile_ops = { .set = active_profile_set, .get = active_profile_get };
+
 // ########## Kernel module parameters
 
 // Simple module parameters (instant update)
 //PARAM(no_bind,          0,                  "This will disable binding to this driver via 'yeetmouse_bind' by udev.");
-PARAM(update,           1,                  "Triggers an update of the acceleration parameters below");
+static char g_update = 0;
+PARAM_CB(update, &update_ops, &g_update,    0644, "Triggers an update of the acceleration parameters below");
 PARAM(AccelerationMode, ACCELERATION_MODE,  "Sets the algorithm to be used for acceleration");
 
 // Acceleration parameters (type pchar. Converted to float via "update_params" triggered by /sys/module/yeetmouse/parameters/update)
@@ -76,44 +106,232 @@ PARAM_F(RotationAngle, ROTATION_ANGLE,      "Amount of clockwise rotation (in ra
 PARAM_F(AngleSnap_Threshold, ANGLE_SNAPPING_THRESHOLD,      "Rotation value at which angle snapping is triggered (in radians)");
 PARAM_F(AngleSnap_Angle, ANGLE_SNAPPING_ANGLE,      "Amount of clockwise rotation for angle snapping (in radians)");
 
-FP_LONG g_LutData_x[MAX_LUT_ARRAY_SIZE]; // Array to store the x-values of the LUT data
-FP_LONG g_LutData_y[MAX_LUT_ARRAY_SIZE]; // Array to store the y-values of the LUT data
+// Atomic interface, replaces all the parameters above (and 'update') with a single write
+PARAM_CB(profile, &profile_ops, NULL,       0644, "The whole acceleration profile as 'Name=Value' lines, applied atomically on write");
+PARAM_CB(profile_version, &profile_version_ops, NULL, 0444, "Version of the profile currently in use");
+PARAM_CB(active_profile, &active_profile_ops, NULL, 0644, "Slot of the profile in use, switching only swaps a pointer");
+
+// ########## Acceleration profile
 
-// Converts given string to a unsigned long
-unsigned long atoul(const char *str) {
-    unsigned long result = 0;
-    int i = 0;
+// The profile used by accelerate(). Published with RCU, so a new one can be swapped in at any time without stalling the irq.
+static struct accel_profile __rcu *g_profile;
+static DEFINE_MUTEX(g_profile_lock); // Serializes the writers, protects the slots below
 
-    // Iterate through the string, converting each digit to an integer
-    while (str[i] >= '0' && str[i] <= '9') {
-        result = result * 10 + (str[i] - '0');
-        i++;
+// Compiled profiles, g_profile always points to g_slots[g_active_slot]. Empty slots are NULL.
+// Also published with RCU, as devices can be bound to a specific slot (see accelerate()).
+static struct accel_profile __rcu *g_slots[PROFILE_SLOTS];
+static unsigned int g_active_slot;
+
+#define slot_profile(slot) rcu_dereference_protected(g_slots[slot], lockdep_is_held(&g_profile_lock))
+
+// Parses 'buf' ("x,y;x,y;...") into the LUT of the profile, reading at most 'max_points' points.
+// Returns the number of points read, or -EINVAL if the data is malformed.
+static int parse_lut_data(const char *buf, unsigned long max_points, struct accel_profile *profile)
+{
+    const char *p = buf;
+    unsigned long i = 0;
+
+    if (max_points > MAX_LUT_ARRAY_SIZE)
+        max_points = MAX_LUT_ARRAY_SIZE;
+
+    for (; i < max_points * 2 && *p; i++) {
+        FP_LONG val;
+        int len = FP64_FromString(p, &val);
+
+        if (len == 0) {
+            // Trailing white space is fine, anything else is not
+            while (*p == ' ' || *p == '\t' || *p == '\n')
+                p++;
+            if (*p)
+                return -EINVAL;
+            break;
+        }
+
+        p += len;
+        if (*p) // Skip the ';' or ','
+            p++;
+        // The format for the driver side is very strict tho, so don't edit it by hand pls.
+        ((i % 2 == 0) ? profile->LutData_x : profile->LutData_y)[i/2] = val;
     }
 
-    return result;
+    // Did not work correctly
+    if(i % 2 == 1)
+        return -EINVAL;
+
+    return i / 2;
 }
 
-// Updates the acceleration parameters. This is purposely done with a delay!
-// First, to not hammer too much the logic in "accelerate()", which is called VERY OFTEN!
-// Second, to fight possible cheating. However, this can be OFC changed, since we are OSS...
-#define PARAM_UPDATE(param) (FP64_FromString(g_param_##param, &g_##param))
-#define PARAM_UPDATE_UL(param) (atoul(g_param_##param))
+// Writes the LUT of the profile in the "x,y;x,y;" format, returns the number of characters written,
+// or -E2BIG if it doesn't fit (then 'buf' holds a cut off text)
+static int print_lut_data(char *buf, size_t size, const struct accel_profile *profile)
+{
+    char num[24];
+    int len = 0;
+    unsigned long i;
+
+    for (i = 0; i < profile->LutSize; i++) {
+        FP64_ToStringExact(profile->LutData_x[i], num);
+        len += scnprintf(buf + len, size - len, "%s,", num);
+        FP64_ToStringExact(profile->LutData_y[i], num);
+        len += scnprintf(buf + len, size - len, "%s;", num);
+    }
 
-// Aggregate values that don't change with speed to save on calculations done every irq
-struct ModesConstants modesConst = {
-    .is_init = false, .C0 = 0, .r = 0, .auxiliar_accel = 0, .auxiliar_constant = 0, .accel_sub_1 = 0, .exp_sub_1 = 0,
-    .sin_a = 0, .cos_a = 0, .as_cos = 0, .as_sin = 0, .as_half_threshold = 0, .current_func_at_0 = FP64_1
-};
+    return (size_t)len < size - 1 ? len : -E2BIG;
+}
+
+// Validates and compiles the profile, then stores it in the slot (and swaps it in, if the slot is active).
+// ACCEL_SLOT_ACTIVE stores it in the slot active at that moment, resolved under the lock. Takes the ownership of 'profile'.
+// In strict mode invalid parameters reject the whole profile, otherwise they fall back to AccelMode_Current (legacy behaviour).
+static int accel_profile_commit(struct accel_profile *profile, int slot, bool strict)
+{
+    struct accel_profile *old;
+    char *text;
+    int error;
+
+    // Angle snap threshold should be in range [0, PI)
+    if(profile->AngleSnap_Threshold >= FP64_PI || profile->AngleSnap_Threshold < 0) {
+        if (strict) {
+            printk("YeetMouse: Error: Angle snapping threshold has to be in range [0, PI).\n");
+            kfree(profile);
+            return -EINVAL;
+        }
+        profile->AngleSnap_Threshold = 0;
+    }
+
+    if ((unsigned char)profile->AccelerationMode >= AccelMode_Count) {
+        printk("YeetMouse: Error: Unknown acceleration mode %d.\n", profile->AccelerationMode);
+        if (strict) {
+            kfree(profile);
+            return -EINVAL;
+        }
+        profile->AccelerationMode = AccelMode_Current;
+    }
+
+    error = update_constants(profile);
+    if (error && strict) {
+        kfree(profile);
+        return error;
+    }
+
+    text = kmalloc(PAGE_SIZE, GFP_KERNEL);
+    if (!text) {
+        kfree(profile);
+        return -ENOMEM;
+    }
+
+    mutex_lock(&g_profile_lock);
+    if (slot == ACCEL_SLOT_ACTIVE)
+        slot = g_active_slot;
+    old = slot_profile(slot);
+
+    if (profile->version == 0) {
+        profile->version = old ? old->version + 1 : 1;
+    } else if (old && profile->version <= old->version) {
+        mutex_unlock(&g_profile_lock);
+        printk("YeetMouse: Error: Profile version %llu is not newer than the one in use (%llu).\n",
+               profile->version, old->version);
+        kfree(text);
+        kfree(profile);
+        return -EINVAL;
+    }
+
+    // The numbers are printed exactly (up to 22 characters each), so a profile that was short enough to write
+    // can still be too long to read back from 'profile' (or the LUT from 'LutDataBuf')
+    error = profile_print(text, PAGE_SIZE, profile, slot);
+    kfree(text);
+    if (error < 0) {
+        mutex_unlock(&g_profile_lock);
+        printk("YeetMouse: Error: The profile doesn't fit in a page once printed, use fewer LUT points.\n");
+        kfree(profile);
+        return error;
+    }
+
+    rcu_assign_pointer(g_slots[slot], profile);
+    if (slot == g_active_slot)
+        rcu_assign_pointer(g_profile, profile);
+    mutex_unlock(&g_profile_lock);
+
+    // Wait for the irqs still using the old profile (it could have been active just before a switch)
+    if (old) {
+        synchronize_rcu();
+        kfree(old);
+    }
+
+    return 0;
+}
+
+// Returns a private copy of the profile in use, or NULL. The caller has to kfree() it.
+static struct accel_profile *accel_profile_dup(void)
+{
+    struct accel_profile *copy = kmalloc(sizeof(*copy), GFP_KERNEL);
+    const struct accel_profile *profile;
+
+    if (!copy)
+        return NULL;
+
+    rcu_read_lock();
+    profile = rcu_dereference(g_profile);
+    if (profile)
+        memcpy(copy, profile, sizeof(*copy));
+    rcu_read_unlock();
+
+    if (!profile) {
+        kfree(copy);
+        return NULL;
+    }
+
+    return copy;
+}
 
-static ktime_t g_next_update = 0;
-INLINE void update_params(ktime_t now)
+// Returns a private copy of the profile in the slot (of the active one if the slot is empty or ACCEL_SLOT_ACTIVE),
+// or NULL. The caller has to kfree() it.
+static struct accel_profile *accel_slot_dup(int slot)
 {
-    if(!g_update) return;
-    if(now < g_next_update) return;
-    g_update = 0;
-    g_next_update = now + 1000000000ll;    //Next update is allowed after 1s of delay
+    struct accel_profile *copy = kmalloc(sizeof(*copy), GFP_KERNEL);
+    const struct accel_profile *profile;
+
+    if (!copy)
+        return NULL;
+
+    mutex_lock(&g_profile_lock);
+    profile = slot != ACCEL_SLOT_ACTIVE ? slot_profile(slot) : NULL;
+    if (!profile)
+        profile = slot_profile(g_active_slot);
+    if (profile)
+        memcpy(copy, profile, sizeof(*copy));
+    mutex_unlock(&g_profile_lock);
+
+    if (!profile) {
+        kfree(copy);
+        return NULL;
+    }
+
+    return copy;
+}
 
-    modesConst.is_init = false;
+// The fixed profile build can't change the profile, only read it
+static int profile_check_writable(void)
+{
+#ifdef FIXED_PROFILE
+    printk("YeetMouse: Error: This build is fixed to the profile in its config.h, rebuild it to change the profile.\n");
+    return -EPERM;
+#else
+    return 0;
+#endif
+}
+
+// ########## Legacy interface (one parameter per file + 'update')
+
+#define PARAM_UPDATE(param) (FP64_FromString(g_param_##param, &profile->param))
+
+// Builds a new profile from the individual module parameters and applies it to the active slot
+static int update_params(void)
+{
+    struct accel_profile *profile = kzalloc(sizeof(*profile), GFP_KERNEL);
+    int lut_size, error;
+
+    if (!profile)
+        return -ENOMEM;
 
     PARAM_UPDATE(InputCap);
     PARAM_UPDATE(Sensitivity);
@@ -129,231 +347,578 @@ INLINE void update_params(ktime_t now)
     PARAM_UPDATE(RotationAngle);
     PARAM_UPDATE(AngleSnap_Threshold);
     PARAM_UPDATE(AngleSnap_Angle);
-    PARAM_UPDATE_UL(LutSize);
-    //PARAM_UPDATE(LutStride);
-    if(g_LutSize > MAX_LUT_ARRAY_SIZE)
-        g_LutSize = MAX_LUT_ARRAY_SIZE;
+    profile->AccelerationMode = g_AccelerationMode;
+    profile->UseSmoothing = g_UseSmoothing;
+
     // LutDataBuf get auto updated, we don't need to do anything, just extract the data
-    // Populate the g_LutData with the data in the buffer
-    char* p = g_param_LutDataBuf;
-    int i = 0;
-    for(; i < g_LutSize*2 && *p; i++) {
-        FP_LONG val;
-        p += FP64_FromString(p, &val) + 1; // + 1 to skip the ';' or ','
-        // The format for the driver side is very strict tho, so don't edit it by hand pls.
-        ((i % 2 == 0) ? g_LutData_x : g_LutData_y)[i/2] = val;
+    lut_size = parse_lut_data(g_param_LutDataBuf, g_LutSize, profile);
+    profile->LutSize = lut_size > 0 ? lut_size : 0;
 
-        // Debug stuff (you know it didn't work the first time (nor the 10th time... (that's at least 10 'blue screens')))
-        //char buf[25];
-        //FP64_ToString(val, buf, 4);
-        //printk("YeetMouse: Converted %s, next char is: %i\n", buf, *p);
-    }
+    error = accel_profile_commit(profile, ACCEL_SLOT_ACTIVE, false);
+    if (error)
+        return error;
 
-    // Did not work correctly
-    if(i % 2 == 1)
-        g_LutSize = 0;
+    // Let userspace know, if the parameters were invalid
+    rcu_read_lock();
+    g_AccelerationMode = rcu_dereference(g_profile)->AccelerationMode;
+    rcu_read_unlock();
 
-    // Sanity check
-    if(g_LutSize <= 1 && (g_AccelerationMode == AccelMode_Lut || g_AccelerationMode == AccelMode_CustomCurve))
-        g_AccelerationMode = AccelMode_Current;
+    return 0;
+}
 
-    if ((g_AccelerationMode == AccelMode_Lut || g_AccelerationMode == AccelMode_CustomCurve) &&
-        (g_LutData_x[g_LutSize-1] == g_LutData_x[g_LutSize-2] && g_LutData_y[g_LutSize-1] == g_LutData_y[g_LutSize-2]))
-        g_AccelerationMode = AccelMode_Current;
+static int update_set(const char *val, const struct kernel_param *kp)
+{
+    bool update;
+    int error = kstrtobool(val, &update);
 
-    // Angle snap threshold should be in range [0, PI)
-    if(g_AngleSnap_Threshold >= FP64_PI || g_AngleSnap_Threshold < 0) {
-        g_AngleSnap_Threshold = 0;
-    }
+    if (error)
+        return error;
+
+    if (update && (error = profile_check_writable()) != 0)
+        return error;
 
-    update_constants();
+    return update ? update_params() : 0;
 }
 
-// Acceleration happens here
-int accelerate(int *x, int *y)
+// ########## Atomic interface ('profile', 'profile_version' and 'active_profile')
+
+enum ProfileKeyType {
+    ProfileKey_Fixed,
+    ProfileKey_Byte,
+    ProfileKey_LutSize,
+    ProfileKey_LutData,
+    ProfileKey_Version,
+};
+
+struct profile_key {
+    const char *name;
+    size_t offset;
+    enum ProfileKeyType type;
+};
+
+#define PROFILE_KEY(param, type) { #param, offsetof(struct accel_profile, param), type }
+
+// Same names as the module parameters
+static const struct profile_key profile_keys[] = {
+    { "Version", offsetof(struct accel_profile, version), ProfileKey_Version },
+    PROFILE_KEY(AccelerationMode, ProfileKey_Byte),
+    PROFILE_KEY(UseSmoothing, ProfileKey_Byte),
+    PROFILE_KEY(Sensitivity, ProfileKey_Fixed),
+    PROFILE_KEY(SensitivityY, ProfileKey_Fixed),
+    PROFILE_KEY(OutputCap, ProfileKey_Fixed),
+    PROFILE_KEY(InputCap, ProfileKey_Fixed),
+    PROFILE_KEY(Offset, ProfileKey_Fixed),
+    PROFILE_KEY(PreScale, ProfileKey_Fixed),
+    PROFILE_KEY(Acceleration, ProfileKey_Fixed),
+    PROFILE_KEY(Exponent, ProfileKey_Fixed),
+    PROFILE_KEY(Midpoint, ProfileKey_Fixed),
+    PROFILE_KEY(Motivity, ProfileKey_Fixed),
+    PROFILE_KEY(RotationAngle, ProfileKey_Fixed),
+    PROFILE_KEY(AngleSnap_Threshold, ProfileKey_Fixed),
+    PROFILE_KEY(AngleSnap_Angle, ProfileKey_Fixed),
+    PROFILE_KEY(LutSize, ProfileKey_LutSize),
+    { "LutDataBuf", offsetof(struct accel_profile, LutData_x), ProfileKey_LutData },
+};
+
+// Parses a single 'Name=Value' line into the profile
+static int parse_profile_line(char *line, struct accel_profile *profile, long *lut_size)
 {
-    FP_LONG delta_x, delta_y, ms, speed;
-    //static long buffer_x = 0;
-    //static long buffer_y = 0;
-    //Static float assignment should happen at compile-time and thus should be safe here. However, avoid non-static assignment of floats outside kernel_fpu_begin()/kernel_fpu_end()
-    static FP_LONG carry_x = 0;
-    static FP_LONG carry_y = 0;
-    //static FP_LONG carry_whl = 0;
-    static FP_LONG last_ms = One;
-    static ktime_t last;
-    ktime_t now;
-    int status = 0;
+    char *name = strim(strsep(&line, "="));
+    char *value;
+    int i;
 
-    delta_x = FP64_FromInt(*x);
-    delta_y = FP64_FromInt(*y);
-    //delta_whl = FP64_FromInt(*wheel);
-
-    //Add buffer values, if present, and reset buffer
-    //delta_x = FP64_Add(delta_x, FP64_FromInt((int) buffer_x)); buffer_x = 0;
-    //delta_y = FP64_Add(delta_y, FP64_FromInt((int) buffer_y)); buffer_y = 0;
-
-    //Calculate frametime
-    now = ktime_get(); // ns
-    long long dt = (now - last);
-    //int frac = dt % 10000;
-    // We can't just store milliseconds as this would lose a lot of precision (nano -> mili, that's 10^-6 difference).
-    // But we have only Q16.16 bits of precision, meaning 16 bits for the fractional part of the number (it's constant!).
-    // So it would be wasteful to store a millisecond in a fixed point format, because the integral part would be at max like 100
-    // and we would lose all the precision on the fractional part, so we move everything storing millis * 100.
-    // Now we have at max 10000 to store in the integral part (technically 0xFFFF) and a bit less information in the fractional part
-    // that would be lost either way.
-    /// THE ABOVE NO LONGER HOLDS, AS I'VE MOVED (AGAIN), THIS TIME TO 64bit FIXED POINT MATH
-    //ms = FP64_FromInt(dt / 10000ll) + FP64_Div(FP64_FromInt(frac), fp64_10000); // NOT MILLISECONDS, its ms * 100
-    ms = FP64_DivPrecise(FP64_FromInt(dt), FP64_FromInt(1000000));
-    last = now;
-    //if(ms < 1) ms = last_ms;    //Sometimes, urbs appear bunched -> Beyond µs resolution so the timing reading is plain wrong. Fallback to last known valid frametime
-    // Editor node: I have no idea, what this line above really does, but commenting it out solves all my problems
-    // with incorrect data. It seems that it tries to fix a problem that doesn't exist, or doesn't exist on my
-    // specific setup (PC / System / Mice)
-    if(ms > FP64_100) ms = FP64_100;
-
-    //if(ms > 100) ms = 100;      //Original InterAccel has 200 here. RawAccel rounds to 100. So do we.
-    last_ms = ms;
-
-    //Update acceleration parameters periodically
-    update_params(now);
-
-    //Calculate velocity (one step before rate, which divides rate by the last frametime)
-    speed = FP64_Sqrt(FP64_Add(FP64_Mul(delta_x, delta_x), FP64_Mul(delta_y, delta_y)));
-
-    // Apply Pre-Scale
-    if(g_PreScale != FP64_1)
-        speed = FP64_Mul(speed, g_PreScale);
-
-    //Apply speedcap
-    if(g_InputCap > 0){
-        //if(speed >= g_InputCap) {
-        if(FP64_Sub(speed, g_InputCap) > 0) {
-            speed = g_InputCap;
-        }
+    if (!line) {
+        printk("YeetMouse: Error: Expected 'Name=Value' in the profile, got '%s'.\n", name);
+        return -EINVAL;
     }
+    value = strim(line);
+
+    for (i = 0; i < ARRAY_SIZE(profile_keys); i++) {
+        const struct profile_key *key = &profile_keys[i];
+        void *field = (char *)profile + key->offset;
+        unsigned long long num;
+        int error = 0;
 
-    //Calculate rate from traveled overall distance and add possible rate offsets
-    speed = FP64_DivPrecise(speed, ms);
-    speed = FP64_Sub(speed, g_Offset);
+        if (strcmp(name, key->name) != 0)
+            continue;
 
-    static_assert(AccelMode_Count == 10, "Wrong AccelMode count!");
-    // Apply acceleration if movement is over offset
-    if (speed > 0) {
-        switch (g_AccelerationMode) {
-            case AccelMode_Linear:
-                speed = accel_linear(speed);
+        switch (key->type) {
+            case ProfileKey_Fixed:
+                if (!FP64_FromString(value, field))
+                    error = -EINVAL;
+                break;
+            case ProfileKey_Byte:
+                error = kstrtou8(value, 0, field);
                 break;
-            case AccelMode_Power:
-                speed = accel_power(speed);
+            case ProfileKey_LutSize:
+                error = kstrtoull(value, 0, &num);
+                if (!error)
+                    *lut_size = num > MAX_LUT_ARRAY_SIZE ? -1 : num;
                 break;
-            case AccelMode_Classic:
-                speed = accel_classic(speed);
+            case ProfileKey_LutData:
+                error = parse_lut_data(value, MAX_LUT_ARRAY_SIZE, profile);
+                if (error >= 0) {
+                    profile->LutSize = error;
+                    error = 0;
+                }
                 break;
-            case AccelMode_Motivity:
-                speed = accel_motivity(speed);
+            case ProfileKey_Version:
+                error = kstrtoull(value, 0, field);
+                break;
+        }
+
+        if (error)
+            printk("YeetMouse: Error: Invalid value of '%s' in the profile.\n", name);
+        return error;
+    }
+
+    printk("YeetMouse: Error: Unknown parameter '%s' in the profile.\n", name);
+    return -EINVAL;
+}
+
+// Mirrors the profile in the individual parameters, so that the legacy interface doesn't go out of sync
+static void profile_sync_params(const struct accel_profile *profile)
+{
+    char num[24];
+
+#define PARAM_SYNC(param) do {                                      \
+        struct kernel_param kp = { .arg = &g_param_##param };       \
+        FP64_ToStringExact(profile->param, num);                     \
+        param_set_charp(num, &kp);                                  \
+    } while (0)
+
+    PARAM_SYNC(InputCap);
+    PARAM_SYNC(Sensitivity);
+    PARAM_SYNC(SensitivityY);
+    PARAM_SYNC(Acceleration);
+    PARAM_SYNC(OutputCap);
+    PARAM_SYNC(Offset);
+    PARAM_SYNC(Exponent);
+    PARAM_SYNC(Midpoint);
+    PARAM_SYNC(PreScale);
+    PARAM_SYNC(Motivity);
+    PARAM_SYNC(RotationAngle);
+    PARAM_SYNC(AngleSnap_Threshold);
+    PARAM_SYNC(AngleSnap_Angle);
+#undef PARAM_SYNC
+
+    g_AccelerationMode = profile->AccelerationMode;
+    g_UseSmoothing = profile->UseSmoothing;
+    g_LutSize = profile->LutSize;
+    // Can't fail, accel_profile_commit() made sure the whole profile fits in a page
+    print_lut_data(g_param_LutDataBuf, sizeof(g_param_LutDataBuf), profile);
+}
+
+// Parameters that are not given keep their current values (of the target slot, or of the active one if it's empty).
+// An optional 'Slot=N' (first key only) selects the slot to write to, otherwise the active one is used (the one active
+// when the profile gets stored, see accel_profile_commit()).
+static int profile_set(const char *val, const struct kernel_param *kp)
+{
+    struct accel_profile *profile = NULL;
+    int slot = ACCEL_SLOT_ACTIVE;
+    char *buf, *cur, *line;
+    long lut_size = -2; // Not given
+    int error = profile_check_writable();
+
+    if (error)
+        return error;
+
+    // sysfs cuts longer writes at PAGE_SIZE - 1 and passes the rest as another write, which would be taken as a profile of its own
+    if (strlen(val) >= PAGE_SIZE - 1) {
+        printk("YeetMouse: Error: The profile has to be shorter than %lu characters.\n", PAGE_SIZE - 1);
+        return -E2BIG;
+    }
+
+    buf = kstrdup(val, GFP_KERNEL);
+    if (!buf)
+        return -ENOMEM;
+
+    cur = buf;
+    while (!error && (line = strsep(&cur, "\n")) != NULL) {
+        line = strim(line);
+        if (*line == '\0' || *line == '#')
+            continue;
+
+        if (strncmp(line, "Slot", 4) == 0 && (line[4] == '=' || line[4] == ' ')) {
+            char *value = strchr(line, '=');
+            unsigned int given;
+
+            // The slot decides where the missing keys come from, so it has to come before them
+            if (profile) {
+                printk("YeetMouse: Error: Slot has to be the first key in the profile.\n");
+                error = -EINVAL;
+            } else if (!value || kstrtouint(strim(value + 1), 0, &given) || given >= PROFILE_SLOTS) {
+                printk("YeetMouse: Error: Invalid profile slot, there are %d of them.\n", PROFILE_SLOTS);
+                error = -EINVAL;
+            } else
+                slot = given;
+            continue;
+        }
+
+        if (!profile) {
+            profile = accel_slot_dup(slot);
+            if (!profile) {
+                error = -ENOMEM;
                 break;
-            case AccelMode_Synchronous:
-                speed = accel_synchronous(speed);
+            }
+            profile->version = 0;
+        }
+
+        error = parse_profile_line(line, profile, &lut_size);
+    }
+    kfree(buf);
+
+    // Nothing but the slot given, store a copy of the active profile there
+    if (!error && !profile) {
+        profile = accel_slot_dup(slot);
+        if (!profile)
+            return -ENOMEM;
+        profile->version = 0;
+    }
+
+    // LutSize is optional, but has to agree with the data
+    if (!error && lut_size != -2 && lut_size != profile->LutSize) {
+        printk("YeetMouse: Error: LutSize doesn't match the number of points in LutDataBuf.\n");
+        error = -EINVAL;
+    }
+
+    if (error) {
+        kfree(profile);
+        return error;
+    }
+
+    error = accel_profile_commit(profile, slot, true);
+    if (error)
+        return error;
+
+    // param_set_charp() may sleep, so hold the lock instead of an RCU read section
+    mutex_lock(&g_profile_lock);
+    if (slot == ACCEL_SLOT_ACTIVE || slot == g_active_slot)
+        profile_sync_params(slot_profile(g_active_slot));
+    mutex_unlock(&g_profile_lock);
+
+    return 0;
+}
+
+// Prints the profile the way 'profile' reads, returns the length or -E2BIG if it doesn't fit
+static int profile_print(char *buf, size_t size, const struct accel_profile *profile, unsigned int slot)
+{
+    char num[24];
+    int i, len = 0, lut_len;
+
+    len += scnprintf(buf + len, size - len, "Slot=%u\n", slot);
+    for (i = 0; i < ARRAY_SIZE(profile_keys); i++) {
+        const struct profile_key *key = &profile_keys[i];
+        const void *field = (const char *)profile + key->offset;
+
+        len += scnprintf(buf + len, size - len, "%s=", key->name);
+        switch (key->type) {
+            case ProfileKey_Fixed:
+                FP64_ToStringExact(*(const FP_LONG *)field, num);
+                len += scnprintf(buf + len, size - len, "%s", num);
                 break;
-            case AccelMode_Natural:
-                speed = accel_natural(speed);
+            case ProfileKey_Byte:
+                len += scnprintf(buf + len, size - len, "%d", *(const char *)field);
                 break;
-            case AccelMode_Jump:
-                speed = accel_jump(speed);
+            case ProfileKey_LutSize:
+                len += scnprintf(buf + len, size - len, "%lu", profile->LutSize);
                 break;
-            case AccelMode_Lut: case AccelMode_CustomCurve:
-                speed = accel_lut(speed);
+            case ProfileKey_LutData:
+                lut_len = print_lut_data(buf + len, size - len, profile);
+                if (lut_len < 0)
+                    return lut_len;
+                len += lut_len;
                 break;
-            default:
-                speed = FP64_1;
+            case ProfileKey_Version:
+                len += scnprintf(buf + len, size - len, "%llu", profile->version);
                 break;
         }
-    } else {
-        speed = modesConst.current_func_at_0;
+        len += scnprintf(buf + len, size - len, "\n");
     }
 
-    // Actually apply accelerated sensitivity, allow post-scaling and apply carry from previous round
-    // Like RawAccel, sensitivity will be a final multiplier:
-    if (g_SensitivityY == FP64_1) {
-        if(g_Sensitivity != FP64_1)
-            speed = FP64_Mul(speed, g_Sensitivity);
-
-        // Apply Output Limit
-        if(g_OutputCap > 0)
-            speed = FP64_Min(g_OutputCap, speed);
-
-        // Apply acceleration
-        delta_x = FP64_Mul(delta_x, speed);
-        delta_y = FP64_Mul(delta_y, speed);
-    } else {
-        speed = FP64_Mul(speed, g_Sensitivity);
-        FP_LONG speed_Y = FP64_Mul(speed, g_SensitivityY);
-
-        // Apply Output Limit
-        if(g_OutputCap > 0) {
-            speed = FP64_Min(g_OutputCap, speed);
-            speed_Y = FP64_Min(g_OutputCap, speed_Y);
-        }
+    return (size_t)len < size - 1 ? len : -E2BIG;
+}
 
-        // Apply acceleration
-        delta_x = FP64_Mul(delta_x, speed);
-        delta_y = FP64_Mul(delta_y, speed_Y);
-    }
+static int profile_get(char *buffer, const struct kernel_param *kp)
+{
+    const struct accel_profile *profile;
+    int len;
 
-    // Angle Snapping
-    if(modesConst.as_half_threshold != 0) {
-        FP_LONG delta_mag = FP64_Sqrt(FP64_Add(FP64_Mul(delta_x, delta_x), FP64_Mul(delta_y, delta_y)));
-        if (delta_mag != 0) {
-            FP_LONG current_angle = FP64_Atan2(delta_y, delta_x);
-            FP_LONG angle_diff = FP64_Sub(g_AngleSnap_Angle, current_angle);
-            FP_LONG angle_diff_quarter = FP64_PI_2 - FP64_Abs(angle_diff);
+    mutex_lock(&g_profile_lock);
+    profile = slot_profile(g_active_slot);
+    len = profile ? profile_print(buffer, PAGE_SIZE, profile, g_active_slot) : -ENODEV;
+    mutex_unlock(&g_profile_lock);
 
-            int sign = FP64_Sign(angle_diff_quarter);
-            angle_diff_quarter = FP64_Abs(angle_diff_quarter) - FP64_PI_2;
+    return len;
+}
 
-            if (FP64_Abs(angle_diff_quarter) <= modesConst.as_half_threshold) {
-                delta_x = FP64_Mul(modesConst.as_cos, delta_mag) * sign;
-                delta_y = FP64_Mul(modesConst.as_sin, delta_mag) * sign;
-            }
-        }
+static int profile_version_get(char *buffer, const struct kernel_param *kp)
+{
+    unsigned long long version = 0;
+
+    rcu_read_lock();
+    if (rcu_access_pointer(g_profile))
+        version = rcu_dereference(g_profile)->version;
+    rcu_read_unlock();
+
+    return scnprintf(buffer, PAGE_SIZE, "%llu\n", version);
+}
+
+static int active_profile_set(const char *val, const struct kernel_param *kp)
+{
+    unsigned int slot;
+    int error = kstrtouint(val, 0, &slot);
+
+    if (error)
+        return error;
+
+    if ((error = profile_check_writable()) != 0)
+        return error;
+
+    if (slot >= PROFILE_SLOTS) {
+        printk("YeetMouse: Error: Invalid profile slot, there are %d of them.\n", PROFILE_SLOTS);
+        return -EINVAL;
+    }
+
+    mutex_lock(&g_profile_lock);
+    if (!slot_profile(slot)) {
+        mutex_unlock(&g_profile_lock);
+        printk("YeetMouse: Error: Profile slot %u is empty.\n", slot);
+        return -ENOENT;
     }
 
-    delta_x = FP64_Add(delta_x, carry_x);
-    delta_y = FP64_Add(delta_y, carry_y);
+    // Already compiled, so switching is just a pointer swap. The old profile stays in its slot.
+    WRITE_ONCE(g_active_slot, slot);
+    rcu_assign_pointer(g_profile, slot_profile(slot));
+    profile_sync_params(slot_profile(slot));
+    mutex_unlock(&g_profile_lock);
+
+    return 0;
+}
+
+static int active_profile_get(char *buffer, const struct kernel_param *kp)
+{
+    return scnprintf(buffer, PAGE_SIZE, "%u\n", READ_ONCE(g_active_slot));
+}
+
+int accel_init(void)
+{
+    // Initial profile (in the first slot), from the defaults in config.h
+    return update_params();
+}
+
+void accel_exit(void)
+{
+    int i;
 
-    // I don't do wheel, sorry
-    //delta_whl *= g_ScrollsPerTick/3.0f;
+    RCU_INIT_POINTER(g_profile, NULL);
+    synchronize_rcu();
 
-    // Apply Rotation after everything else to keep the precision
-    if(g_RotationAngle != 0) {
-        FP_LONG new_delta_x = FP64_Mul(delta_x, modesConst.cos_a) - FP64_Mul(delta_y, modesConst.sin_a);
-        delta_y = FP64_Mul(delta_x, modesConst.sin_a) + FP64_Mul(delta_y, modesConst.cos_a);
-        delta_x = new_delta_x;
+    for (i = 0; i < PROFILE_SLOTS; i++) {
+        kfree(rcu_dereference_protected(g_slots[i], 1));
+        RCU_INIT_POINTER(g_slots[i], NULL);
     }
+}
 
-    //Cast back to int
-    *x = FP64_RoundToInt(delta_x);
-    *y = FP64_RoundToInt(delta_y);
-
-    //Save carry for next round
-    carry_x = FP64_Sub(delta_x, FP64_FromInt(*x));
-    carry_y = FP64_Sub(delta_y, FP64_FromInt(*y));
-    //carry_whl = delta_whl - *wheel;
-
-    // Used to very roughly estimate the performance, and 0.1% lows
-    // ktime_t iter_time = ktime_sub(ktime_get(), now);
-    // static ktime_t elapsed_time, highest_elapsed_time;
-    // static int iter = 0;
-    // elapsed_time += iter_time;
-    // if(iter_time > highest_elapsed_time)
-    //     highest_elapsed_time = iter_time;
-    // if(++iter == 1000) {
-    //     iter = 0;
-    //     pr_info("YeetMouse: Sum of 1000 iters: %lldns, low 0.1%%: %lldns\n", ktime_to_ns(elapsed_time), highest_elapsed_time);
-    //     elapsed_time = 0;
-    //     highest_elapsed_time = 0;
-    // }
+// Acceleration happens here
+#ifdef FIXED_PROFILE
+int accelerate(int slot, struct accel_state *state, int *x, int *y)
+{
+    // Every device gets the fixed profile, so there are no slots to look up and nothing to protect with RCU.
+    // All that the stages check (the mode, disabled caps, rotation, ...) is a constant, only the math is left.
+    accel_pipeline(&g_fixed_profile, state, ktime_get(), x, y);
+    return 0;
+}
+#else
+int accelerate(int slot, struct accel_state *state, int *x, int *y)
+{
+    const struct accel_profile *profile;
+    int status = 0;
+
+    rcu_read_lock();
+    // Devices bound to an empty slot use the active profile, until the slot gets loaded
+    profile = slot != ACCEL_SLOT_ACTIVE ? rcu_dereference(g_slots[slot]) : NULL;
+    if (!profile)
+        profile = rcu_dereference(g_profile);
+    if (likely(profile))
+        accel_pipeline(profile, state, ktime_get(), x, y);
+    rcu_read_unlock();
 
     return status;
 }
+#endif
+
+// ########## Batch evaluation
+
+// Evaluates the multipliers (X axis) accelerate() applies at the given input speeds (counts/ms, 1ms frames) using the
+// profile in use. Speeds are taken as the raw input, so pre-scale, caps and offset are applied like for real input.
+int accel_eval(const FP_LONG *speeds, FP_LONG *out, unsigned int count)
+{
+    struct accel_profile *profile = accel_profile_dup();
+    unsigned int i;
+
+    if (!profile)
+        return -ENOMEM;
+
+    for (i = 0; i < count; i++) {
+        // Movement purely along the X axis of one count, so the accelerated delta is the multiplier itself
+        FP_LONG delta_x = FP64_1, delta_y = FP64_1;
+        FP_LONG speed = accel_stage_speed(profile, speeds[i], 0, FP64_1);
+
+        accel_stage_sensitivity(profile, accel_stage_curve(profile, speed), &delta_x, &delta_y);
+        out[i] = delta_x;
+    }
+
+    kfree(profile);
+    return 0;
+}
+
+// ########## Self-benchmark
+
+#define BENCH_SWEEP_POINTS 256
+#define BENCH_SWEEP_MAX_COUNTS 160 // Largest synthetic delta (counts per 1ms frame) of the sweep
+
+// Report intervals of the sweep (8 kHz to 125 Hz polling), each one for a run of consecutive points
+static const long long bench_frame_ns[] = { 125000, 250000, 500000, 1000000, 2000000, 8000000 };
+#define BENCH_FRAME_RUN 16
+
+// Keeps the compiler from optimizing the benchmarked math away
+static volatile FP_LONG bench_sink;
+
+// Runs the math of accelerate() using (a copy of) the profile in use over a synthetic speed sweep, 'passes' times.
+// Has to be called from process context, the calling task is kept on its current CPU for the duration of each pass.
+// The whole pipeline runs on an accel_state of its own, with synthetic report timestamps, so no device is affected.
+int accel_benchmark(unsigned int passes, struct accel_bench_result *res)
+{
+    struct accel_profile *profile;
+    const struct accel_profile *bench; // Runs the math
+    struct accel_state state = {0};
+    long long now_ns = 0;
+    FP_LONG *in_x, *in_y, *frame_ms, *speeds, *mults, *out_x, *out_y;
+    u64 overhead = U64_MAX;
+    unsigned int pass, i, stage;
+
+    if (passes == 0 || !res)
+        return -EINVAL;
+
+    profile = accel_profile_dup();
+    if (!profile)
+        return -ENOMEM;
+#ifdef FIXED_PROFILE
+    bench = &g_fixed_profile; // What accelerate() runs, with the profile folded in
+#else
+    bench = profile;
+#endif
+
+    in_x = kmalloc_array(BENCH_SWEEP_POINTS * 7, sizeof(FP_LONG), GFP_KERNEL);
+    if (!in_x) {
+        kfree(profile);
+        return -ENOMEM;
+    }
+    in_y = in_x + BENCH_SWEEP_POINTS;
+    frame_ms = in_y + BENCH_SWEEP_POINTS;
+    speeds = frame_ms + BENCH_SWEEP_POINTS;
+    mults = speeds + BENCH_SWEEP_POINTS;
+    out_x = mults + BENCH_SWEEP_POINTS;
+    out_y = out_x + BENCH_SWEEP_POINTS;
+
+    memset(res, 0, sizeof(*res));
+    res->passes = passes;
+    res->points = BENCH_SWEEP_POINTS;
+    res->op_min_ns = U64_MAX;
+    res->mode = profile->AccelerationMode;
+    res->smoothing = profile->UseSmoothing;
+    res->version = profile->version;
+
+    // Sweep from standstill to a fast flick, alternating the direction so angle snapping and rotation get some work too
+    for (i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        int counts = (int)(i * BENCH_SWEEP_MAX_COUNTS / (BENCH_SWEEP_POINTS - 1));
+        in_x[i] = FP64_FromInt((i & 1) ? -counts : counts);
+        in_y[i] = FP64_FromInt((i & 2) ? -(counts / 3) : counts / 3);
+        // Same conversion as accel_pipeline()
+        frame_ms[i] = (bench_frame_ns[(i / BENCH_FRAME_RUN) % ARRAY_SIZE(bench_frame_ns)] << FP64_Shift) / 1000000;
+    }
+
+    // Inputs for the isolated stages, exactly as the pipeline would produce them
+    for (i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        speeds[i] = accel_stage_speed(bench, in_x[i], in_y[i], frame_ms[i]);
+        mults[i] = accel_stage_curve(bench, speeds[i]);
+        out_x[i] = in_x[i];
+        out_y[i] = in_y[i];
+        accel_stage_sensitivity(bench, mults[i], &out_x[i], &out_y[i]);
+    }
+
+    // The cost of reading the clock itself, subtracted from the per-op timings
+    for (i = 0; i < 64; i++) {
+        u64 t0 = ktime_get_ns();
+        u64 t1 = ktime_get_ns();
+        if (t1 - t0 < overhead)
+            overhead = t1 - t0;
+    }
+
+    for (pass = 0; pass < passes; pass++) {
+        u64 t0, t1;
+
+        preempt_disable();
+        if (pass == 0)
+            res->cpu = smp_processor_id();
+
+        // Whole pipeline (frametime and carry included), op by op for the min/max latency
+        for (i = 0; i < BENCH_SWEEP_POINTS; i++) {
+            int x = FP64_RoundToInt(in_x[i]), y = FP64_RoundToInt(in_y[i]);
+            u64 op_ns;
+
+            now_ns += bench_frame_ns[(i / BENCH_FRAME_RUN) % ARRAY_SIZE(bench_frame_ns)];
+            t0 = ktime_get_ns();
+            accel_pipeline(bench, &state, now_ns, &x, &y);
+            t1 = ktime_get_ns();
+
+            op_ns = (t1 - t0 > overhead) ? (t1 - t0 - overhead) : 0;
+            res->total_ns += op_ns;
+            if (op_ns < res->op_min_ns)
+                res->op_min_ns = op_ns;
+            if (op_ns > res->op_max_ns)
+                res->op_max_ns = op_ns;
+            bench_sink = x ^ y;
+        }
+
+        // Every stage on its own, timed over the whole sweep to keep the clock overhead out of it
+        for (stage = 0; stage < AccelBenchStage_Count; stage++) {
+            t0 = ktime_get_ns();
+            for (i = 0; i < BENCH_SWEEP_POINTS; i++) {
+                FP_LONG dx = out_x[i], dy = out_y[i];
+                switch (stage) {
+                    case AccelBenchStage_Speed:
+                        bench_sink = accel_stage_speed(bench, in_x[i], in_y[i], frame_ms[i]);
+                        break;
+                    case AccelBenchStage_Curve:
+                        bench_sink = accel_stage_curve(bench, speeds[i]);
+                        break;
+                    case AccelBenchStage_Sensitivity:
+                        dx = in_x[i];
+                        dy = in_y[i];
+                        accel_stage_sensitivity(bench, mults[i], &dx, &dy);
+                        bench_sink = dx ^ dy;
+                        break;
+                    case AccelBenchStage_Snapping:
+                        accel_stage_snapping(bench, &dx, &dy);
+                        bench_sink = dx ^ dy;
+                        break;
+                    case AccelBenchStage_Rotation:
+                        accel_stage_rotation(bench, &dx, &dy);
+                        bench_sink = dx ^ dy;
+                        break;
+                }
+            }
+            t1 = ktime_get_ns();
+            res->stage_ns[stage] += t1 - t0;
+        }
+        preempt_enable();
+
+        cond_resched();
+    }
+
+    kfree(in_x);
+    kfree(profile);
+    return 0;
+}
@@ -1,6 +1,57 @@
 #ifndef _ACCEL_H
 #define _ACCEL_H
 
-int accelerate(int *x, int *y);
+#include <linux/types.h>
+
+#ifdef __cplusplus // Also built for userspace, see lib/
+extern "C" {
+#endif
+
+int accel_init(void);
+void accel_exit(void);
+
+#define PROFILE_SLOTS 8 // Number of profiles the driver keeps compiled and ready to be switched to
+#define ACCEL_SLOT_ACTIVE (-1) // Use whatever profile is active ('active_profile')
+
+// Carried over between the reports of a device, starts zeroed
+struct accel_state {
+    s64 carry_x; // Q32.32 fixed point (FP_LONG)
+    s64 carry_y;
+    long long last_ns; // Timestamp of the previous report
+};
+
+// 'slot' is the profile slot the device is bound to, or ACCEL_SLOT_ACTIVE, 'state' is the device's own
+int accelerate(int slot, struct accel_state *state, int *x, int *y);
+
+// Stages of accelerate(), in the order they are applied
+enum AccelBenchStage {
+    AccelBenchStage_Speed,
+    AccelBenchStage_Curve,
+    AccelBenchStage_Sensitivity,
+    AccelBenchStage_Snapping,
+    AccelBenchStage_Rotation,
+    AccelBenchStage_Count
+};
+
+struct accel_bench_result {
+    unsigned int passes;
+    unsigned int points;    // Synthetic speeds evaluated per pass
+    int cpu;                // CPU the benchmark started on
+    int mode, smoothing;    // Of the benchmarked profile
+    unsigned long long version;
+    u64 total_ns;           // Whole pipeline, summed over all ops
+    u64 op_min_ns;
+    u64 op_max_ns;
+    u64 stage_ns[AccelBenchStage_Count]; // Every stage on its own, summed over all ops
+};
+
+int accel_benchmark(unsigned int passes, struct accel_bench_result *res);
+
+// Speeds and multipliers are Q32.32 fixed point numbers (FP_LONG)
+int accel_eval(const s64 *speeds, s64 *out, unsigned int count);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* _ACCEL_H */
@@ -6,51 +6,106 @@
 
 #define EXP_ARG_THRESHOLD 16ll
 
+// Narrow kernels: the widest speed range tried (2^N counts/ms), and how close they have to stay to the Q32.32 math
+// (relative error below 2^-N of the smallest multiplier the curve gives)
+#define NARROW_MAX_SPEED_LOG2 12
+#define NARROW_PRECISION_BITS 24
+
+// Largest distance (in counts) a report can have: the square root of the largest Q32.32 number, that's where
+// FP64_Sqrt() of any deltas ends up
+#define ACCEL_MAX_DISTANCE (46341ll << FP64_Shift)
+
+static void synchronous_build_lut(struct accel_profile *profile);
+static void linear_select_kernel(struct accel_profile *profile);
+static bool verify_profile(const struct accel_profile *profile);
+
+static int bit_length(FP_ULONG value) {
+    return value ? 64 - FP64_Nlz(value) : 0;
+}
+
+// Magnitude, also of the most negative value
+static FP_ULONG fp_abs(FP_LONG value) {
+    return value < 0 ? -(FP_ULONG)value : (FP_ULONG)value;
+}
+
+// Whether FP64_Mul(a, b) fits in Q32.32 (conservatively, by the bits of the two)
+static bool mul_fits(FP_LONG a, FP_LONG b) {
+    return bit_length(fp_abs(a)) + bit_length(fp_abs(b)) <= 63 + FP64_Shift;
+}
+
+// Whether FP64_DivPrecise(a, b) is defined: the quotient has to fit, otherwise it's a divide error (an oops in the
+// kernel), not just an overflow. Leaves a bit of headroom, |a / b| < 2^30.
+static bool div_fits(FP_LONG a, FP_LONG b) {
+    return b != 0 && (fp_abs(a) >> 30) < fp_abs(b);
+}
+
+static FP_LONG checked_div(FP_LONG a, FP_LONG b, bool *out_of_range) {
+    if (!div_fits(a, b)) {
+        *out_of_range = true;
+        return 0;
+    }
+    return FP64_DivPrecise(a, b);
+}
+
+// The parameters can be anything, so the divisions of update_constants() are checked. A profile that would divide
+// out of range gets rejected instead.
+#define CONST_DIV(a, b) checked_div(a, b, &out_of_range)
+
 // Recalculate new modes constants
-void update_constants(void) {
+int update_constants(struct accel_profile *profile) {
+    struct ModesConstants *modesConst = &profile->consts;
+    bool out_of_range = false;
+    int status = 0;
+
     // General
-    modesConst.accel_sub_1 = FP64_Sub(g_Acceleration, FP64_1);
-    modesConst.exp_sub_1 = FP64_Sub(g_Exponent, FP64_1);
-    modesConst.cap_x = 0;
-    modesConst.cap_y = 0;
-    modesConst.gain_constant = 0;
-    modesConst.sign = FP64_1;
+    modesConst->accel_sub_1 = FP64_Sub(profile->Acceleration, FP64_1);
+    modesConst->exp_sub_1 = FP64_Sub(profile->Exponent, FP64_1);
+    modesConst->cap_x = 0;
+    modesConst->cap_y = 0;
+    modesConst->gain_constant = 0;
+    modesConst->sign = FP64_1;
+    modesConst->narrow_limit = 0;
 
     // Synchronous
-    if (g_AccelerationMode == AccelMode_Synchronous) {
-        if (g_Motivity <= FP64_1) {
+    if (profile->AccelerationMode == AccelMode_Synchronous) {
+        if (profile->Motivity <= FP64_1) {
             printk("YeetMouse: Error: Acceleration mode 'Synchronous' is not supported for motivity 1.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
         else {
-            modesConst.logMot = FP64_Log(g_Motivity);
-            modesConst.gammaConst = FP64_DivPrecise(g_Exponent, modesConst.logMot);
-            modesConst.logSync = FP64_Log(g_Acceleration);
+            modesConst->logMot = FP64_Log(profile->Motivity);
+            modesConst->gammaConst = CONST_DIV(profile->Exponent, modesConst->logMot);
+            modesConst->logSync = FP64_Log(profile->Acceleration);
 
             // sharpness = (midpoint == 0) ? 16.0 : (0.5 / midpoint)
-            modesConst.sharpness = (g_Midpoint == 0)
+            modesConst->sharpness = (profile->Midpoint == 0)
                 ? FP64_FromInt(16)
-                : FP64_DivPrecise(FP64_0_5, g_Midpoint);
+                : CONST_DIV(FP64_0_5, profile->Midpoint);
+
+            modesConst->sharpnessRecip = CONST_DIV(FP64_1, modesConst->sharpness);
+            modesConst->useClamp = (modesConst->sharpness >= FP64_FromInt(16));
 
-            modesConst.sharpnessRecip = FP64_DivPrecise(FP64_1, modesConst.sharpness);
-            modesConst.useClamp = (modesConst.sharpness >= FP64_FromInt(16));
+            modesConst->minSens = CONST_DIV(FP64_1, profile->Motivity);
+            modesConst->maxSens = profile->Motivity;
 
-            modesConst.minSens = FP64_DivPrecise(FP64_1, g_Motivity);
-            modesConst.maxSens = g_Motivity;
+            if (profile->UseSmoothing)
+                synchronous_build_lut(profile);
         }
     }
 
     // Linear
-    if (g_AccelerationMode == AccelMode_Linear) {
-        if (g_Acceleration == 0) {
+    if (profile->AccelerationMode == AccelMode_Linear) {
+        if (profile->Acceleration == 0) {
             printk("YeetMouse: Error: Acceleration mode 'Linear' is not supported for acceleration 0.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
-        else if (g_UseSmoothing) {
+        else if (profile->UseSmoothing) {
             FP_LONG sign = FP64_1;
-            FP_LONG cap_y = FP64_Sub(g_Midpoint, FP64_1);
+            FP_LONG cap_y = FP64_Sub(profile->Midpoint, FP64_1);
             FP_LONG cap_x = FP64_FromInt(0);
             FP_LONG constant = FP64_FromInt(0);
             if (cap_y != 0) {
@@ -58,26 +113,30 @@ void update_constants(void) {
                     cap_y = FP64_Mul(cap_y, Neg1);
                     sign = Neg1;
                 }
-                cap_x = FP64_DivPrecise(FP64_DivPrecise(cap_y, FP64_FromInt(2)), g_Acceleration);
+                cap_x = CONST_DIV(CONST_DIV(cap_y, FP64_FromInt(2)), profile->Acceleration);
             }
-            constant = FP64_DivPrecise(FP64_Mul(FP64_Mul(cap_y, Neg1), cap_x), FP64_FromInt(2));
-            modesConst.cap_x = cap_x;
-            modesConst.cap_y = cap_y;
-            modesConst.gain_constant = constant;
-            modesConst.sign = sign;
+            constant = CONST_DIV(FP64_Mul(FP64_Mul(cap_y, Neg1), cap_x), FP64_FromInt(2));
+            modesConst->cap_x = cap_x;
+            modesConst->cap_y = cap_y;
+            modesConst->gain_constant = constant;
+            modesConst->sign = sign;
         }
+
+        if (profile->AccelerationMode == AccelMode_Linear)
+            linear_select_kernel(profile);
     }
 
     // Classic
-    if (g_AccelerationMode == AccelMode_Classic) {
-        if (g_UseSmoothing && (g_Exponent == 0 || modesConst.exp_sub_1 == 0)) {
+    if (profile->AccelerationMode == AccelMode_Classic) {
+        if (profile->UseSmoothing && (profile->Exponent == 0 || modesConst->exp_sub_1 == 0)) {
             printk("YeetMouse: Error: Acceleration mode 'Classic' is not supported for exponent 0 or 1 while using the the smooth cap.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         } else {
-            if (g_UseSmoothing) {
+            if (profile->UseSmoothing) {
                 FP_LONG sign = FP64_1;
-                FP_LONG cap_y = FP64_Sub(g_Midpoint, FP64_1);
+                FP_LONG cap_y = FP64_Sub(profile->Midpoint, FP64_1);
                 FP_LONG cap_x = FP64_FromInt(0);
                 FP_LONG constant = FP64_FromInt(0);
                 if (cap_y != 0) {
@@ -85,227 +144,388 @@ void update_constants(void) {
                         cap_y = FP64_Mul(cap_y, Neg1);
                         sign = Neg1;
                     }
-                    cap_x = FP64_DivPrecise(FP64_Pow(FP64_DivPrecise(cap_y, g_Exponent),
-                                                     FP64_DivPrecise(FP64_1, modesConst.exp_sub_1)), g_Acceleration);
+                    cap_x = CONST_DIV(FP64_Pow(CONST_DIV(cap_y, profile->Exponent),
+                                                     CONST_DIV(FP64_1, modesConst->exp_sub_1)), profile->Acceleration);
                 }
-                FP_LONG factor = FP64_DivPrecise(FP64_Sub(g_Exponent, FP64_1), g_Exponent);
+                FP_LONG factor = CONST_DIV(FP64_Sub(profile->Exponent, FP64_1), profile->Exponent);
                 constant = FP64_Mul(cap_y, cap_x);
                 constant = FP64_Mul(factor, constant);
                 constant = FP64_Mul(constant, Neg1);
-                modesConst.cap_x = cap_x;
-                modesConst.cap_y = cap_y;
-                modesConst.gain_constant = constant;
-                modesConst.sign = sign;
+                modesConst->cap_x = cap_x;
+                modesConst->cap_y = cap_y;
+                modesConst->gain_constant = constant;
+                modesConst->sign = sign;
             }
         }
     }
 
     // Natural
-    if (g_AccelerationMode == AccelMode_Natural) {
-        if (modesConst.exp_sub_1 == 0 || g_Exponent == FP64_1) {
+    if (profile->AccelerationMode == AccelMode_Natural) {
+        if (modesConst->exp_sub_1 == 0 || profile->Exponent == FP64_1) {
             printk("YeetMouse: Error: Acceleration mode 'Natural' is not supported for exponent 1.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
-        if (g_Acceleration == 0) {
+        if (profile->Acceleration == 0) {
             printk("YeetMouse: Error: Acceleration mode 'Natural' is not supported for acceleration 0.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
         else {
-            modesConst.auxiliar_accel = FP64_DivPrecise(g_Acceleration, FP64_Abs(modesConst.exp_sub_1));
-            modesConst.auxiliar_constant = FP64_DivPrecise(-modesConst.exp_sub_1, modesConst.auxiliar_accel);
+            modesConst->auxiliar_accel = CONST_DIV(profile->Acceleration, FP64_Abs(modesConst->exp_sub_1));
+            modesConst->auxiliar_constant = CONST_DIV(-modesConst->exp_sub_1, modesConst->auxiliar_accel);
         }
     }
 
     // Jump
-    if (g_AccelerationMode == AccelMode_Jump) {
-        if (g_Midpoint == 0) {
+    if (profile->AccelerationMode == AccelMode_Jump) {
+        if (profile->Midpoint == 0) {
             printk("YeetMouse: Error: Acceleration mode 'Jump' is not supported for midpoint 0.\n");
-            g_Midpoint = FP64_1;
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Midpoint = FP64_1;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
         else {
-            FP_LONG smooth_inv = FP64_Mul(g_Exponent, g_Midpoint);
+            FP_LONG smooth_inv = FP64_Mul(profile->Exponent, profile->Midpoint);
             if (smooth_inv < FP64_1)
-                modesConst.r = 0;
+                modesConst->r = 0;
             else
-                modesConst.r = FP64_DivPrecise(Pi2, smooth_inv);
+                modesConst->r = CONST_DIV(Pi2, smooth_inv);
 
-            FP_LONG r_times_m = FP64_Mul(modesConst.r, g_Midpoint);
+            FP_LONG r_times_m = FP64_Mul(modesConst->r, profile->Midpoint);
 
-            if (modesConst.r == 0) {
-                modesConst.C0 = FP64_1;
+            if (modesConst->r == 0) {
+                modesConst->C0 = FP64_1;
             }
             // Safely exponentiate without overflow (ln(1+exp(x)) when x -> 'inf' = ln(exp(x)) = x. (in practice works for x >= 8))
             else if (r_times_m < (EXP_ARG_THRESHOLD << FP64_Shift))
-                modesConst.C0 = FP64_Mul(modesConst.accel_sub_1, FP64_DivPrecise(FP64_Log(FP64_Add(FP64_1, FP64_Exp(r_times_m))), modesConst.r));
+                modesConst->C0 = FP64_Mul(modesConst->accel_sub_1, CONST_DIV(FP64_Log(FP64_Add(FP64_1, FP64_Exp(r_times_m))), modesConst->r));
             else
-                modesConst.C0 = FP64_Mul(modesConst.accel_sub_1, FP64_DivPrecise(r_times_m, modesConst.r));
+                modesConst->C0 = FP64_Mul(modesConst->accel_sub_1, CONST_DIV(r_times_m, modesConst->r));
         }
     }
 
     // Power
-    if (g_AccelerationMode == AccelMode_Power) {
-        if (g_Exponent == 0 || g_Exponent == -FP64_1 || g_Acceleration == 0) {
+    if (profile->AccelerationMode == AccelMode_Power) {
+        if (profile->Exponent == 0 || profile->Exponent == -FP64_1 || profile->Acceleration == 0) {
             printk("YeetMouse: Error: Acceleration mode 'Power' is not supported for exponent 0 or -1 or acceleration 0.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
-        else if (g_Midpoint == 0 && !g_UseSmoothing) {
-            modesConst.offset_x = 0;
-            modesConst.power_constant = 0;
+        else if (profile->Midpoint == 0 && !profile->UseSmoothing) {
+            modesConst->offset_x = 0;
+            modesConst->power_constant = 0;
         }
-        else if ((g_Midpoint >= g_Motivity) && g_UseSmoothing) {
+        else if ((profile->Midpoint >= profile->Motivity) && profile->UseSmoothing) {
             printk("YeetMouse: Error: Acceleration mode 'Power' is not supported for output offsets higher than the smooth cap.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
-        else if (FP64_DivPrecise(g_Midpoint, FP64_Mul(g_Acceleration, g_Exponent)) > FP64_100) { // 100 here is completely arbitrary
+        else if (CONST_DIV(profile->Midpoint, FP64_Mul(profile->Acceleration, profile->Exponent)) > FP64_100) { // 100 here is completely arbitrary
             printk("YeetMouse: Error: Invalid parameters for the 'Power' mode.\n");
-            g_Acceleration = 0;
-            g_AccelerationMode = AccelMode_Current;
+            profile->Acceleration = 0;
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
         }
         else {
-            // modesConst.offset_x = FP64_DivPrecise(FP64_Pow(FP64_DivPrecise(g_Midpoint, FP64_Add(g_Exponent, FP64_ONE)),
-            //     FP64_DivPrecise(FP64_ONE, g_Exponent)), g_Acceleration);
-            // modesConst.power_constant = FP64_DivPrecise(FP64_Mul(modesConst.offset_x, FP64_Mul(g_Midpoint, g_Exponent)), FP64_Add(g_Exponent, FP64_ONE));
-
-            FP_LONG exponent_plus_one = FP64_Add(g_Exponent, FP64_1);
-            if (g_Midpoint == 0) {
-                modesConst.offset_x = 0;
-                modesConst.power_constant = 0;
+            // modesConst->offset_x = FP64_DivPrecise(FP64_Pow(FP64_DivPrecise(profile->Midpoint, FP64_Add(profile->Exponent, FP64_ONE)),
+            //     FP64_DivPrecise(FP64_ONE, profile->Exponent)), profile->Acceleration);
+            // modesConst->power_constant = FP64_DivPrecise(FP64_Mul(modesConst->offset_x, FP64_Mul(profile->Midpoint, profile->Exponent)), FP64_Add(profile->Exponent, FP64_ONE));
+
+            FP_LONG exponent_plus_one = FP64_Add(profile->Exponent, FP64_1);
+            if (profile->Midpoint == 0) {
+                modesConst->offset_x = 0;
+                modesConst->power_constant = 0;
             } else {
-                FP_LONG one_over_exponent = FP64_DivPrecise(FP64_1, g_Exponent);
-                FP_LONG base_value = FP64_DivPrecise(g_Midpoint, exponent_plus_one);
+                FP_LONG one_over_exponent = CONST_DIV(FP64_1, profile->Exponent);
+                FP_LONG base_value = CONST_DIV(profile->Midpoint, exponent_plus_one);
 
                 FP_LONG pow_result = FP64_Pow(base_value, one_over_exponent);
-                modesConst.offset_x = FP64_DivPrecise(pow_result, g_Acceleration);
+                modesConst->offset_x = CONST_DIV(pow_result, profile->Acceleration);
 
-                FP_LONG intermediate = FP64_Mul(modesConst.offset_x, FP64_Mul(g_Midpoint, g_Exponent));
-                modesConst.power_constant = FP64_DivPrecise(intermediate, exponent_plus_one);
+                FP_LONG intermediate = FP64_Mul(modesConst->offset_x, FP64_Mul(profile->Midpoint, profile->Exponent));
+                modesConst->power_constant = CONST_DIV(intermediate, exponent_plus_one);
             }
 
-            if (g_UseSmoothing) {
-                FP_LONG cap_y = g_Motivity;
+            if (profile->UseSmoothing) {
+                FP_LONG cap_y = profile->Motivity;
                 FP_LONG cap_x = FP64_FromInt(0);
                 if (cap_y > FP64_FromInt(0)) {
-                  cap_x = FP64_DivPrecise(
+                  cap_x = CONST_DIV(
                       FP64_Pow(
-                          FP64_DivPrecise(cap_y, exponent_plus_one),
-                          FP64_DivPrecise(FP64_1, g_Exponent)),
-                                          g_Acceleration);
+                          CONST_DIV(cap_y, exponent_plus_one),
+                          CONST_DIV(FP64_1, profile->Exponent)),
+                                          profile->Acceleration);
                 }
-                FP_LONG constant = FP64_Mul(g_Acceleration, cap_x);
-                constant = FP64_Pow(constant, g_Exponent);
+                FP_LONG constant = FP64_Mul(profile->Acceleration, cap_x);
+                constant = FP64_Pow(constant, profile->Exponent);
                 constant = FP64_Mul(constant, cap_x);
-                constant = FP64_Add(constant, modesConst.power_constant);
+                constant = FP64_Add(constant, modesConst->power_constant);
                 constant = FP64_Sub(constant, FP64_Mul(cap_x, cap_y));
 
-                modesConst.cap_x = cap_x;
-                modesConst.cap_y = cap_y;
-                modesConst.gain_constant = constant;
+                modesConst->cap_x = cap_x;
+                modesConst->cap_y = cap_y;
+                modesConst->gain_constant = constant;
             }
         }
     }
 
     // Lut (Validation)
-    if (g_AccelerationMode == AccelMode_Lut || g_AccelerationMode == AccelMode_CustomCurve) {
-        if (g_LutSize <= 1 || g_LutData_x[g_LutSize-1] == g_LutData_x[g_LutSize-2])
-            g_AccelerationMode = AccelMode_Current;
+    if (profile->AccelerationMode == AccelMode_Lut || profile->AccelerationMode == AccelMode_CustomCurve) {
+        if (profile->LutSize <= 1 || profile->LutData_x[profile->LutSize-1] == profile->LutData_x[profile->LutSize-2]) {
+            profile->AccelerationMode = AccelMode_Current;
+            status = -EINVAL;
+        }
 
         // Check if LUT_x is sorted
-        for (int i = 1; i < g_LutSize; i++) {
-            if (g_LutData_x[i - 1] > g_LutData_x[i]) {
-                g_AccelerationMode = AccelMode_Current;
+        for (int i = 1; i < profile->LutSize; i++) {
+            if (profile->LutData_x[i - 1] > profile->LutData_x[i]) {
+                profile->AccelerationMode = AccelMode_Current;
+                status = -EINVAL;
                 printk("YeetMouse: Error: Acceleration mode 'LUT' is not supported for unsorted LUT_x.\n");
                 break;
             }
         }
     }
 
+    if (out_of_range) {
+        printk("YeetMouse: Error: The parameters are out of the range of the fixed point math.\n");
+        profile->Acceleration = 0;
+        profile->AccelerationMode = AccelMode_Current;
+        status = -EINVAL;
+    }
+    else if (profile->AccelerationMode != AccelMode_Current && !verify_profile(profile)) {
+        printk("YeetMouse: Error: The parameters would overflow the fixed point math at some speeds.\n");
+        profile->Acceleration = 0;
+        profile->AccelerationMode = AccelMode_Current;
+        status = -EINVAL;
+    }
+
     static_assert(AccelMode_Count == 10, "Wrong AccelMode count!");
-    switch (g_AccelerationMode) {
+    switch (profile->AccelerationMode) {
         case AccelMode_Linear:
-            modesConst.current_func_at_0 = accel_linear(FP64_0_01);
+            modesConst->current_func_at_0 = accel_linear(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Power:
-            modesConst.current_func_at_0 = accel_power(FP64_0_01);
+            modesConst->current_func_at_0 = accel_power(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Classic:
-            modesConst.current_func_at_0 = accel_classic(FP64_0_01);
+            modesConst->current_func_at_0 = accel_classic(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Motivity:
-            modesConst.current_func_at_0 = accel_motivity(FP64_0_01);
+            modesConst->current_func_at_0 = accel_motivity(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Synchronous:
-            modesConst.current_func_at_0 = accel_synchronous(FP64_0_01);
+            modesConst->current_func_at_0 = accel_synchronous(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Natural:
-            modesConst.current_func_at_0 = accel_natural(FP64_0_01);
+            modesConst->current_func_at_0 = accel_natural(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Jump:
-            modesConst.current_func_at_0 = accel_jump(FP64_0_01);
+            modesConst->current_func_at_0 = accel_jump(profile, ACCEL_MIN_SPEED);
             break;
         case AccelMode_Lut: case AccelMode_CustomCurve:
-            modesConst.current_func_at_0 = accel_lut(FP64_0_01);
+            modesConst->current_func_at_0 = accel_lut(profile, ACCEL_MIN_SPEED);
             break;
         default:
-            modesConst.current_func_at_0 = FP64_1;
+            modesConst->current_func_at_0 = FP64_1;
             break;
     }
 
     // Rotation (precalculate the trig. functions)
-    modesConst.sin_a = FP64_Sin(g_RotationAngle);
-    modesConst.cos_a = FP64_Cos(g_RotationAngle);
+    modesConst->sin_a = FP64_Sin(profile->RotationAngle);
+    modesConst->cos_a = FP64_Cos(profile->RotationAngle);
+
+    modesConst->as_cos = FP64_Cos(profile->AngleSnap_Angle);
+    modesConst->as_sin = FP64_Sin(profile->AngleSnap_Angle);
+    modesConst->as_half_threshold = FP64_DivPrecise(profile->AngleSnap_Threshold, 2ll << FP64_Shift);
+
+    modesConst->is_init = 1;
 
-    modesConst.as_cos = FP64_Cos(g_AngleSnap_Angle);
-    modesConst.as_sin = FP64_Sin(g_AngleSnap_Angle);
-    modesConst.as_half_threshold = FP64_DivPrecise(g_AngleSnap_Threshold, 2ll << FP64_Shift);
+    return status;
+}
+
+#undef CONST_DIV
 
-    modesConst.is_init = 1;
+// |a| + |b|, saturated (bounds only get compared)
+static FP_LONG bound_add(FP_LONG a, FP_LONG b) {
+    FP_ULONG sum = fp_abs(a) + fp_abs(b);
+    return sum > (FP_ULONG)INT64_MAX || sum < fp_abs(a) ? INT64_MAX : (FP_LONG)sum;
 }
 
-#define SYNC_START (-3)
-#define SYNC_STOP (9)
-#define SYNC_NUM (8)
-#define SYNC_CAPACITY ((SYNC_STOP - SYNC_START) * SYNC_NUM + 1)
-
-// Local LUT storage for synchronous smoothing
-static struct {
-    FP_LONG x_start;                 // 2^SYNC_START
-    FP_LONG data[SYNC_CAPACITY];     // monotonic over x
-} s_sync_lut;
-
-static bool s_sync_lut_ready = false;
-
-static FP_LONG synchronous_legacy(FP_LONG x) {
-    if (modesConst.useClamp) {
-        FP_LONG L = FP64_Mul(modesConst.gammaConst, FP64_Sub(FP64_Log(x), modesConst.logSync));
-        if (L < FP64_1) return modesConst.minSens;
-        if (L > -FP64_1) return modesConst.maxSens;
-        return FP64_Exp(FP64_Mul(L, modesConst.logMot));
+// |a| * |b|, saturated
+static FP_LONG bound_mul(FP_LONG a, FP_LONG b) {
+    return mul_fits(a, b) ? (FP_LONG)fp_abs(FP64_Mul((FP_LONG)fp_abs(a), (FP_LONG)fp_abs(b))) : INT64_MAX;
+}
+
+// Whether |num / speed| fits for every speed from min_speed on, where |num| <= a + b * speed (a, b >= 0)
+static bool quotient_fits(FP_LONG a, FP_LONG b, FP_LONG min_speed) {
+    // |num / speed| <= a / min_speed + b
+    return div_fits(a, min_speed) && div_fits(bound_add(FP64_DivPrecise(a, min_speed), b), FP64_1);
+}
+
+// Proves that accel_pipeline() can't divide out of range (a divide error, an oops in the interrupt handler) with the
+// profile, and that the products leading to the divisions can't wrap around, for all the inputs it can get.
+// The speed is at most ACCEL_MAX_DISTANCE (pre-scaled and capped) over ACCEL_MIN_DT_NS, and the curve only gets the
+// speeds from ACCEL_MIN_SPEED on (see accel_stage_curve()). Every division of the curves gets a bound for its quotient
+// over that range. The ones that are 0/0 at a speed of 0 (the smooth Natural and Jump) are bounded through
+// |num| <= a + b * speed. FP64_Exp() and FP64_Pow() saturate instead of overflowing, so they need no bounds.
+static bool verify_profile(const struct accel_profile *profile) {
+    const struct ModesConstants *modesConst = &profile->consts;
+    FP_LONG min_ms = (ACCEL_MIN_DT_NS << FP64_Shift) / 1000000;
+    FP_LONG distance, max_speed, min_speed;
+
+    // accel_stage_speed()
+    if (!mul_fits(ACCEL_MAX_DISTANCE, profile->PreScale))
+        return false;
+    distance = bound_mul(ACCEL_MAX_DISTANCE, profile->PreScale);
+    if (profile->InputCap > 0 && profile->InputCap < distance)
+        distance = profile->InputCap;
+    if (!div_fits(distance, min_ms))
+        return false;
+    max_speed = bound_add(FP64_DivPrecise(distance, min_ms), profile->Offset);
+    if (!div_fits(max_speed, FP64_1))
+        return false;
+
+    static_assert(AccelMode_Count == 10, "Wrong AccelMode count!");
+    switch (profile->AccelerationMode) {
+        case AccelMode_Linear:
+        case AccelMode_Classic:
+            // gain / speed, speed >= cap_x
+            if (profile->UseSmoothing && modesConst->gain_constant != 0 &&
+                (modesConst->cap_x <= 0 || !div_fits(modesConst->gain_constant, modesConst->cap_x)))
+                return false;
+            return mul_fits(max_speed, profile->Acceleration);
+
+        case AccelMode_Power:
+            // power_constant / speed, speed > offset_x
+            if (modesConst->power_constant != 0 &&
+                (modesConst->offset_x <= 0 || !div_fits(modesConst->power_constant, modesConst->offset_x)))
+                return false;
+            // gain / speed, speed >= cap_x
+            if (profile->UseSmoothing && modesConst->cap_x != 0 &&
+                (modesConst->cap_x < 0 || !div_fits(modesConst->gain_constant, modesConst->cap_x)))
+                return false;
+            return mul_fits(max_speed, profile->Acceleration);
+
+        case AccelMode_Motivity:
+            // accel_sub_1 / (1 + e^x), always >= 1 (FP64_ExpFast() saturates)
+            return true;
+
+        case AccelMode_Synchronous:
+            // sync_data[i] / speed, speed >= 2^SYNC_START (sync_x_start below that)
+            if (profile->UseSmoothing) {
+                int i;
+                for (i = 0; i < SYNC_CAPACITY; i++) {
+                    if (!div_fits(modesConst->sync_data[i], modesConst->sync_x_start))
+                        return false;
+                }
+            }
+            return true;
+
+        case AccelMode_Natural: {
+            FP_LONG a;
+
+            // decay / auxiliar_accel, decay = e^(auxiliar_accel * (midpoint - speed)) in [0, 1] past the midpoint
+            if (modesConst->auxiliar_accel <= 0 || !div_fits(FP64_1, modesConst->auxiliar_accel) ||
+                !mul_fits(modesConst->auxiliar_accel, bound_add(max_speed, profile->Midpoint)))
+                return false;
+            min_speed = profile->Midpoint > ACCEL_MIN_SPEED ? profile->Midpoint : ACCEL_MIN_SPEED;
+            if (profile->UseSmoothing) {
+                // exp_sub_1 * (decay / auxiliar_accel - (midpoint - speed)) + auxiliar_constant
+                a = bound_add(bound_mul(modesConst->exp_sub_1,
+                                        bound_add(FP64_DivPrecise(FP64_1, modesConst->auxiliar_accel), profile->Midpoint)),
+                              modesConst->auxiliar_constant);
+                return quotient_fits(a, modesConst->exp_sub_1, min_speed);
+            }
+            // (midpoint - decay * (midpoint - speed)) / speed
+            return quotient_fits(bound_add(profile->Midpoint, profile->Midpoint), FP64_1, min_speed);
+        }
+
+        case AccelMode_Jump:
+            // x = r * (midpoint - speed)
+            if (!mul_fits(modesConst->r, bound_add(max_speed, profile->Midpoint)))
+                return false;
+            if (modesConst->r == 0) {
+                // accel_sub_1 * (speed - midpoint) / speed, speed > midpoint
+                min_speed = profile->Midpoint > ACCEL_MIN_SPEED ? profile->Midpoint : ACCEL_MIN_SPEED;
+                return !profile->UseSmoothing ||
+                       quotient_fits(bound_mul(modesConst->accel_sub_1, profile->Midpoint), modesConst->accel_sub_1,
+                                     min_speed);
+            }
+            if (profile->UseSmoothing) {
+                // log(1 + e^x) / r, log(1 + e^x) is taken as x past EXP_ARG_THRESHOLD
+                FP_LONG natural_log = bound_add(bound_mul(modesConst->r, profile->Midpoint), (EXP_ARG_THRESHOLD + 1) << FP64_Shift);
+                FP_LONG integral;
+                if (!div_fits(natural_log, modesConst->r))
+                    return false;
+                // (accel_sub_1 * (speed + log(1 + e^x) / r) - C0) / speed
+                integral = bound_add(bound_mul(modesConst->accel_sub_1, FP64_DivPrecise(natural_log, modesConst->r)),
+                                     modesConst->C0);
+                return quotient_fits(integral, modesConst->accel_sub_1, ACCEL_MIN_SPEED);
+            }
+            // accel_sub_1 / (1 + e^x)
+            return true;
+
+        case AccelMode_Lut: case AccelMode_CustomCurve: {
+            unsigned long last = profile->LutSize - 1;
+            FP_LONG frac;
+
+            // Past the last point the last segment gets extrapolated, (speed - x[n-2]) / (x[n-1] - x[n-2]).
+            // The other segments only ever get speeds within them, the fraction is in [0, 1].
+            if (!div_fits(bound_add(max_speed, profile->LutData_x[last - 1]),
+                          profile->LutData_x[last] - profile->LutData_x[last - 1]))
+                return false;
+            frac = FP64_DivPrecise(bound_add(max_speed, profile->LutData_x[last - 1]),
+                                   profile->LutData_x[last] - profile->LutData_x[last - 1]);
+            return mul_fits(bound_add(profile->LutData_y[last], profile->LutData_y[last - 1]), frac);
+        }
+
+        default:
+            return true;
     }
+}
+
+static FP_LONG synchronous_legacy(const struct accel_profile *profile, FP_LONG x) {
+    const struct ModesConstants *modesConst = &profile->consts;
 
-    if (x == g_Acceleration) {
+    if (modesConst->useClamp) {
+        FP_LONG L = FP64_Mul(modesConst->gammaConst, FP64_Sub(FP64_Log(x), modesConst->logSync));
+        if (L < -FP64_1) return modesConst->minSens;
+        if (L > FP64_1) return modesConst->maxSens;
+        return FP64_Exp(FP64_Mul(L, modesConst->logMot));
+    }
+
+    if (x == profile->Acceleration) {
         return FP64_1;
     }
 
-    FP_LONG delta = FP64_Sub(FP64_Log(x), modesConst.logSync);
-    FP_LONG M = FP64_Mul(modesConst.gammaConst, FP64_Abs(delta));
-    FP_LONG T = FP64_Tanh(FP64_Pow(M, modesConst.sharpness));
-    FP_LONG exponent = FP64_Pow(T, modesConst.sharpnessRecip);
+    FP_LONG delta = FP64_Sub(FP64_Log(x), modesConst->logSync);
+    FP_LONG M = FP64_Mul(modesConst->gammaConst, FP64_Abs(delta));
+    FP_LONG P = FP64_Pow(M, modesConst->sharpness);
+    FP_LONG exponent;
+    // tanh(M^s)^(1/s) -> M near the sync speed, where M^s has (almost) no bits left in fixed point
+    if (P < (FP64_1 >> 10))
+        exponent = M;
+    else
+        exponent = FP64_Pow(FP64_Tanh(P), modesConst->sharpnessRecip);
     if (delta < 0) {
         exponent = -exponent;
     }
-    return FP64_Exp(FP64_Mul(exponent, modesConst.logMot));
+    return FP64_Exp(FP64_Mul(exponent, modesConst->logMot));
 }
 
 // Helper: build LUT for smoothing/gain mode
-static bool synchronous_build_lut(void) {
+static void synchronous_build_lut(struct accel_profile *profile) {
+    struct ModesConstants *modesConst = &profile->consts;
+
     // x_start = 2^SYNC_START
-    s_sync_lut.x_start = FP64_Scalbn(FP64_1, SYNC_START);
+    modesConst->sync_x_start = FP64_Scalbn(FP64_1, SYNC_START);
 
     FP_LONG sum = 0;
     FP_LONG prev_x   = 0;
@@ -327,12 +547,12 @@ static bool synchronous_build_lut(void) {
                 // xi = a + p*interval
                 FP_LONG xi = FP64_Add(prev_x, FP64_Mul(FP64_FromInt(p), interval));
                 // sum += sync_legacy(xi) * interval
-                sum = FP64_Add(sum, FP64_Mul(synchronous_legacy(xi), interval));
+                sum = FP64_Add(sum, FP64_Mul(synchronous_legacy(profile, xi), interval));
             }
 
             prev_x = b;
 
-            s_sync_lut.data[idx++] = sum;
+            modesConst->sync_data[idx++] = sum;
         }
     }
 
@@ -342,20 +562,19 @@ static bool synchronous_build_lut(void) {
         FP_LONG interval = FP64_DivPrecise(FP64_Sub(b, prev_x), FP64_FromInt(2));
         for (int p = 1; p <= 2; ++p) {
             FP_LONG xi = FP64_Add(prev_x, FP64_Mul(FP64_FromInt(p), interval));
-            sum = FP64_Add(sum, FP64_Mul(synchronous_legacy(xi), interval));
+            sum = FP64_Add(sum, FP64_Mul(synchronous_legacy(profile, xi), interval));
         }
         prev_x = b;
 
         if (idx < SYNC_CAPACITY) {
-            s_sync_lut.data[idx] = sum; // last element
+            modesConst->sync_data[idx] = sum; // last element
         }
     }
-
-    s_sync_lut_ready = true;
-    return true;
 }
 
-static FP_LONG synchronous_eval(FP_LONG x) {
+static FP_LONG synchronous_eval(const struct accel_profile *profile, FP_LONG x) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
     // Find octave index: e = floor(log2(x)), clamped
     int e = FP64_Ilogb(x);
     if (e < SYNC_START) e = SYNC_START;
@@ -378,77 +597,153 @@ static FP_LONG synchronous_eval(FP_LONG x) {
         // t = fractional part in [0,1)
         FP_LONG t = FP64_Sub(idxF, FP64_FromInt(idx));
 
-        FP_LONG y = FP64_Lerp(s_sync_lut.data[idx], s_sync_lut.data[idx + 1], t);
+        FP_LONG y = FP64_Lerp(modesConst->sync_data[idx], modesConst->sync_data[idx + 1], t);
 
         return FP64_DivPrecise(y, x);
     }
-    FP_LONG y = s_sync_lut.data[0];
-    return FP64_DivPrecise(y, s_sync_lut.x_start);
+    FP_LONG y = modesConst->sync_data[0];
+    return FP64_DivPrecise(y, modesConst->sync_x_start);
+}
+
+// Interval analysis for the Linear curve, over the speeds [0, 2^k) counts/ms. Looks for the widest range where the
+// curve can be evaluated with a 32x32->64 bit multiply (and a 64 bit division for the smooth cap), instead of the
+// 128 bit math of Q32.32, staying within NARROW_PRECISION_BITS of it. Formats, in Q32.32 bits:
+//   speed: < 2^(32+k), the lowest speed_shift = k+1 bits are dropped to fit in 31 bits
+//   accel: the lowest accel_shift bits are dropped to fit in 31 bits (none for accelerations below 0.5)
+//   speed * accel: speed_shift + accel_shift bits already dropped, product_shift more to get back to Q32.32
+// The errors (in Q32.32 units) then are accel * 2^speed_shift from the speed, speed * 2^accel_shift from the
+// acceleration, plus the roundings. The smooth cap divides by the speed: |gain / speed| <= cap_y / 2 and
+// cap_y / (2 * cap_x) is the acceleration, so the error of the dropped speed bits is the same there.
+static void linear_select_kernel(struct accel_profile *profile) {
+    struct ModesConstants *modesConst = &profile->consts;
+    FP_LONG accel = modesConst->sign < 0 ? -profile->Acceleration : profile->Acceleration;
+    // The smallest multiplier of the curve, 1 - cap_y (= midpoint) with a cap below 1
+    FP_LONG min_mult = modesConst->sign < 0 ? profile->Midpoint : FP64_1;
+    int accel_shift = bit_length(profile->Acceleration) - 31;
+    int k;
+
+    if (profile->Acceleration <= 0 || min_mult <= 0)
+        return;
+    if (accel_shift < 0)
+        accel_shift = 0;
+
+    for (k = NARROW_MAX_SPEED_LOG2; k >= 0; k--) {
+        int speed_shift = k + 1;
+        int product_shift = FP64_Shift - speed_shift - accel_shift;
+        FP_LONG error = (profile->Acceleration >> (FP64_Shift - speed_shift)) + 3;
+
+        if (product_shift < 0)
+            continue;
+        if (accel_shift > 0)
+            error += 1ll << (k + accel_shift);
+        if (error > (min_mult >> NARROW_PRECISION_BITS))
+            continue;
+
+        // gain << (32 - speed_shift) has to fit, and the cap has to keep at least a bit of the speed
+        if (profile->UseSmoothing && modesConst->gain_constant != 0 &&
+            (bit_length(FP64_Abs(modesConst->gain_constant)) + FP64_Shift - speed_shift > 62 ||
+             modesConst->cap_x < (1ll << speed_shift)))
+            continue;
+
+        modesConst->narrow_accel = (FP_INT)(accel >> accel_shift);
+        modesConst->narrow_speed_shift = speed_shift;
+        modesConst->narrow_product_shift = product_shift;
+        modesConst->narrow_limit = 1ll << (FP64_Shift + k);
+        return;
+    }
+}
+
+// accel_linear() with the formats picked by linear_select_kernel(), for speeds below narrow_limit
+static FP_LONG accel_linear_narrow(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+    FP_INT speed_narrow = (FP_INT)(speed >> modesConst->narrow_speed_shift);
+    FP_LONG value;
+
+    if (!profile->UseSmoothing || speed < modesConst->cap_x)
+        value = ((FP_LONG)speed_narrow * modesConst->narrow_accel) >> modesConst->narrow_product_shift;
+    else {
+        value = modesConst->gain_constant == 0 ? 0 :
+                (modesConst->gain_constant << (FP64_Shift - modesConst->narrow_speed_shift)) / speed_narrow;
+        value = FP64_Add(value, modesConst->cap_y);
+        if (modesConst->sign < 0)
+            value = -value;
+    }
+    return FP64_Add(FP64_1, value);
 }
 
-FP_LONG accel_linear(FP_LONG speed) {
-    if (g_UseSmoothing) {
-        if (speed < modesConst.cap_x) {
-            speed = FP64_Mul(modesConst.sign, FP64_Mul(speed, g_Acceleration));
+FP_LONG accel_linear(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
+    // Negative speeds wrap around to huge ones, and take the Q32.32 path
+    if ((FP_ULONG)speed < (FP_ULONG)modesConst->narrow_limit)
+        return accel_linear_narrow(profile, speed);
+
+    if (profile->UseSmoothing) {
+        if (speed < modesConst->cap_x) {
+            speed = FP64_Mul(modesConst->sign, FP64_Mul(speed, profile->Acceleration));
         } else {
-            speed = FP64_Mul(modesConst.sign, FP64_Add(FP64_DivPrecise(modesConst.gain_constant, speed), modesConst.cap_y));
+            speed = FP64_Mul(modesConst->sign, FP64_Add(FP64_DivPrecise(modesConst->gain_constant, speed), modesConst->cap_y));
         }
     } else {
-        speed = FP64_Mul(speed, g_Acceleration);
+        speed = FP64_Mul(speed, profile->Acceleration);
     }
     return FP64_Add(FP64_1, speed);
 }
 
-FP_LONG accel_power(FP_LONG speed) {
-    if (speed <= modesConst.offset_x)
-        speed = g_Midpoint;
+FP_LONG accel_power(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
+    if (speed <= modesConst->offset_x)
+        speed = profile->Midpoint;
     else {
-        if (g_UseSmoothing) {
-            if (speed < modesConst.cap_x) {
-                if (modesConst.power_constant == 0)
-                    speed = FP64_PowFast(FP64_Mul(speed, g_Acceleration), g_Exponent);
+        if (profile->UseSmoothing) {
+            if (speed < modesConst->cap_x) {
+                if (modesConst->power_constant == 0)
+                    speed = FP64_PowFast(FP64_Mul(speed, profile->Acceleration), profile->Exponent);
                 else
-                    speed = FP64_Add(FP64_PowFast(FP64_Mul(speed, g_Acceleration), g_Exponent), FP64_DivPrecise(modesConst.power_constant, speed));
+                    speed = FP64_Add(FP64_PowFast(FP64_Mul(speed, profile->Acceleration), profile->Exponent), FP64_DivPrecise(modesConst->power_constant, speed));
             } else {
-                if (modesConst.cap_x == FP64_FromInt(0)) {
-                    speed = modesConst.cap_y;
+                if (modesConst->cap_x == FP64_FromInt(0)) {
+                    speed = modesConst->cap_y;
                 } else {
-                    speed = FP64_Add(FP64_DivPrecise(modesConst.gain_constant, speed), modesConst.cap_y);
+                    speed = FP64_Add(FP64_DivPrecise(modesConst->gain_constant, speed), modesConst->cap_y);
                 }
             }
         } else {
-            if (modesConst.power_constant == 0)
-                speed = FP64_PowFast(FP64_Mul(speed, g_Acceleration), g_Exponent);
+            if (modesConst->power_constant == 0)
+                speed = FP64_PowFast(FP64_Mul(speed, profile->Acceleration), profile->Exponent);
             else
-                speed = FP64_Add(FP64_PowFast(FP64_Mul(speed, g_Acceleration), g_Exponent), FP64_DivPrecise(modesConst.power_constant, speed));
+                speed = FP64_Add(FP64_PowFast(FP64_Mul(speed, profile->Acceleration), profile->Exponent), FP64_DivPrecise(modesConst->power_constant, speed));
         }
     }
     return speed;
 }
 
-FP_LONG accel_classic(FP_LONG speed) {
+FP_LONG accel_classic(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
     // (Speed * Acceleration) ^ (Exponent - 1) + 1
     // Same as above just without adding the one
-    //speed *= g_Acceleration;
+    //speed *= profile->Acceleration;
     //speed += 1;
-    //B_pow(&speed, &g_Exponent);
+    //B_pow(&speed, &profile->Exponent);
 
     // FIXED-POINT:
     FP_LONG accel_classic_result = speed;
-    accel_classic_result = FP64_Mul(accel_classic_result, g_Acceleration);
-    accel_classic_result = FP64_PowFast(accel_classic_result, modesConst.exp_sub_1);
+    accel_classic_result = FP64_Mul(accel_classic_result, profile->Acceleration);
+    accel_classic_result = FP64_PowFast(accel_classic_result, modesConst->exp_sub_1);
 
     // if Use Smooth Cap is on, we proceed to calculate the transition
     // point and the function that provides the smooth cap
-    if (g_UseSmoothing) {
+    if (profile->UseSmoothing) {
         // we setup the y cap
-        if (speed < modesConst.cap_x) {
-            accel_classic_result = FP64_Mul(modesConst.sign, accel_classic_result);
+        if (speed < modesConst->cap_x) {
+            accel_classic_result = FP64_Mul(modesConst->sign, accel_classic_result);
             speed = FP64_Add(accel_classic_result, FP64_1);
         } else {
-            speed = FP64_Add(FP64_Mul(modesConst.sign,
-                                      FP64_Add(FP64_DivPrecise(modesConst.gain_constant, speed),
-                                               modesConst.cap_y)), FP64_1);
+            speed = FP64_Add(FP64_Mul(modesConst->sign,
+                                      FP64_Add(FP64_DivPrecise(modesConst->gain_constant, speed),
+                                               modesConst->cap_y)), FP64_1);
         }
     } else
         speed = FP64_Add(accel_classic_result, FP64_1);
@@ -456,92 +751,95 @@ FP_LONG accel_classic(FP_LONG speed) {
     return speed;
 }
 
-FP_LONG accel_motivity(FP_LONG speed) {
+FP_LONG accel_motivity(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
     // Acceleration / ( 1 + e ^ (midpoint - x))
-    //product = g_Midpoint-speed;
+    //product = profile->Midpoint-speed;
     //motivity = e;
     //B_pow(&motivity, &product);
-    //motivity = g_Acceleration / (1 + motivity);
+    //motivity = profile->Acceleration / (1 + motivity);
     //speed = motivity;
 
     // FIXED-POINT:
-    FP_LONG exp = FP64_ExpFast(FP64_Sub(g_Midpoint, speed));
-    speed = FP64_Add(FP64_1, FP64_DivPrecise(modesConst.accel_sub_1, FP64_Add(FP64_1, exp)));
+    FP_LONG exp = FP64_ExpFast(FP64_Sub(profile->Midpoint, speed));
+    speed = FP64_Add(FP64_1, FP64_DivPrecise(modesConst->accel_sub_1, FP64_Add(FP64_1, exp)));
     return speed;
 }
 
-FP_LONG accel_synchronous(FP_LONG speed) {
+FP_LONG accel_synchronous(const struct accel_profile *profile, FP_LONG speed) {
     // Defensive: ensure speed > 0 for log-domain math; you can clamp differently if your file already does.
     if (speed <= 0) {
         return FP64_1;
     }
 
     FP_LONG val;
-    if (g_UseSmoothing) {
-        if (!s_sync_lut_ready) { // This should be skipped 100% (except the first time) of the time by the branch predictor
-            synchronous_build_lut();
-        }
-        val = synchronous_eval(speed);
+    if (profile->UseSmoothing) {
+        val = synchronous_eval(profile, speed);
     } else {
-        val = synchronous_legacy(speed);
+        val = synchronous_legacy(profile, speed);
     }
     return val;
 }
 
 
-FP_LONG accel_jump(FP_LONG speed) {
-    // r = 2pi/(k*midpoint), where k is the smoothness factor (stored inside g_Exponent)
+FP_LONG accel_jump(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
+    // r = 2pi/(k*midpoint), where k is the smoothness factor (stored inside profile->Exponent)
     // Jump: Acceleration / (1 + exp(r(midpoint - x))) + 1
     // Smooth: Integral of the above divided by x pretty much
 
     if (speed <= 0)
         return FP64_1;
 
-    FP_LONG exp_arg = FP64_Mul(modesConst.r, FP64_Sub(g_Midpoint, speed));
+    FP_LONG exp_arg = FP64_Mul(modesConst->r, FP64_Sub(profile->Midpoint, speed));
     FP_LONG D = FP64_Exp(exp_arg);
 
-    if(g_UseSmoothing) { // smooth
-        if (modesConst.r != 0) {
+    if(profile->UseSmoothing) { // smooth
+        if (modesConst->r != 0) {
             FP_LONG natural_log = exp_arg > (EXP_ARG_THRESHOLD << FP64_Shift) ? exp_arg : FP64_Log(FP64_Add(FP64_1, D));
-            FP_LONG integral = FP64_Mul(modesConst.accel_sub_1, FP64_Add(speed, FP64_DivPrecise(natural_log, modesConst.r)));
+            FP_LONG integral = FP64_Mul(modesConst->accel_sub_1, FP64_Add(speed, FP64_DivPrecise(natural_log, modesConst->r)));
             // Not really an integral
-            speed = FP64_Add(FP64_DivPrecise(FP64_Sub(integral, modesConst.C0), speed), FP64_1);
+            speed = FP64_Add(FP64_DivPrecise(FP64_Sub(integral, modesConst->C0), speed), FP64_1);
         }
-        else if (speed <= g_Midpoint)
+        else if (speed <= profile->Midpoint)
             speed = FP64_1;
         else
-            speed = FP64_Add(FP64_DivPrecise(FP64_Mul(modesConst.accel_sub_1, FP64_Sub(speed, g_Midpoint)), speed), FP64_1);
+            speed = FP64_Add(FP64_DivPrecise(FP64_Mul(modesConst->accel_sub_1, FP64_Sub(speed, profile->Midpoint)), speed), FP64_1);
     }
     else {
-        if (modesConst.r != 0)
-            speed = FP64_Add(FP64_DivPrecise(modesConst.accel_sub_1, FP64_Add(FP64_1, D)), FP64_1);
-        else if (speed <= g_Midpoint)
+        if (modesConst->r != 0)
+            speed = FP64_Add(FP64_DivPrecise(modesConst->accel_sub_1, FP64_Add(FP64_1, D)), FP64_1);
+        else if (speed <= profile->Midpoint)
             speed = FP64_1;
         else
-            speed = FP64_Add(modesConst.accel_sub_1, FP64_1);
+            speed = FP64_Add(modesConst->accel_sub_1, FP64_1);
     }
 
     return speed;
 }
 
-FP_LONG accel_natural(FP_LONG speed) {
-    if (speed <= g_Midpoint) {
+FP_LONG accel_natural(const struct accel_profile *profile, FP_LONG speed) {
+    const struct ModesConstants *modesConst = &profile->consts;
+
+    if (speed <= profile->Midpoint) {
         speed = FP64_1;
     } else {
-        FP_LONG n_offset_x = FP64_Sub(g_Midpoint, speed);
-        FP_LONG decay = FP64_Exp(FP64_Mul(modesConst.auxiliar_accel, n_offset_x));
+        FP_LONG n_offset_x = FP64_Sub(profile->Midpoint, speed);
+        FP_LONG decay = FP64_Exp(FP64_Mul(modesConst->auxiliar_accel, n_offset_x));
 
-        if (g_UseSmoothing) {
+        if (profile->UseSmoothing) {
             FP_LONG decay_auxiliaraccel =
-                    FP64_DivPrecise(decay, modesConst.auxiliar_accel);
+                    FP64_DivPrecise(decay, modesConst->auxiliar_accel);
             FP_LONG numerator = FP64_Add(
-                FP64_Mul(modesConst.exp_sub_1, FP64_Sub(decay_auxiliaraccel, n_offset_x)),
-                modesConst.auxiliar_constant);
+                FP64_Mul(modesConst->exp_sub_1, FP64_Sub(decay_auxiliaraccel, n_offset_x)),
+                modesConst->auxiliar_constant);
             speed = FP64_Add(FP64_DivPrecise(numerator, speed), FP64_1);
         } else {
             speed = FP64_Add(
-                FP64_Mul(modesConst.exp_sub_1, (FP64_Sub(
-                             FP64_1, FP64_DivPrecise(FP64_Sub(g_Midpoint, FP64_Mul(decay, n_offset_x)), speed)))),
+                FP64_Mul(modesConst->exp_sub_1, (FP64_Sub(
+                             FP64_1, FP64_DivPrecise(FP64_Sub(profile->Midpoint, FP64_Mul(decay, n_offset_x)), speed)))),
                 FP64_1);
         }
     }
@@ -553,34 +851,34 @@ FP_LONG accel_natural(FP_LONG speed) {
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #endif
 
-FP_LONG accel_lut(FP_LONG speed) {
+FP_LONG accel_lut(const struct accel_profile *profile, FP_LONG speed) {
     // Assumes the size and values are valid. Please don't change LUT parameters by hand.
 
-    if(speed < g_LutData_x[0]) // Check if the speed is below the first given point
-        speed = g_LutData_y[0];
+    // Check if the speed is below (or at) the first given point, the search below needs a point before the speed
+    if(speed <= profile->LutData_x[0])
+        speed = profile->LutData_y[0];
     else {
-        int l = 0, r = g_LutSize - 1, best_point = r, iter = 0; // We REALLY don't want an infinity loop in kernel
-        while (l <= r && iter < 10) {
+        // At most log2(MAX_LUT_ARRAY_SIZE) + 1 iterations, the range shrinks every time
+        int l = 0, r = profile->LutSize - 1, best_point = r;
+        while (l <= r) {
             int mid = (r + l) / 2;
 
-            if (speed > g_LutData_x[mid]) {
+            if (speed > profile->LutData_x[mid]) {
                 l = mid + 1;
             } else {
                 best_point = mid;
                 r = mid - 1;
             }
-
-            iter++;
         }
 
-        int index = MIN(best_point-1, g_LutSize-2);
+        int index = MIN(best_point-1, profile->LutSize-2);
 
-        FP_LONG p = g_LutData_y[index];
-        FP_LONG p1 = g_LutData_y[index + 1];
+        FP_LONG p = profile->LutData_y[index];
+        FP_LONG p1 = profile->LutData_y[index + 1];
 
-        // denominator should not possibly ever be equal to 0 here... (we all know how this will end)
-        FP_LONG frac = FP64_DivPrecise(speed - g_LutData_x[index],
-                                       g_LutData_x[index + 1] - g_LutData_x[index]);
+        // x[index] < speed <= x[index + 1] (or past the last point), never 0, see verify_profile() for the quotient
+        FP_LONG frac = FP64_DivPrecise(speed - profile->LutData_x[index],
+                                       profile->LutData_x[index + 1] - profile->LutData_x[index]);
 
         speed = FP64_Lerp(p, p1, frac);
     }
@@ -1,13 +1,31 @@
 #ifndef ACCEL_MODES_H
 #define ACCEL_MODES_H
 
-#include "config.h" // Used in the testing suite
+#include "config.h"
 #include <linux/module.h>
 #include "FixedMath/Fixed64.h"
 
+#ifdef __cplusplus // Also built for userspace, see lib/
+extern "C" {
+#endif
+
 #define MAX_LUT_ARRAY_SIZE 128
 #define MAX_LUT_BUF_LEN 4096
 
+// The inputs the profiles are verified for (see update_constants()), accel_pipeline() keeps them within it.
+// Reports closer than ACCEL_MIN_DT_NS (or further apart than ACCEL_MAX_DT_NS) are taken as that far apart, and speeds
+// below ACCEL_MIN_SPEED get the multiplier at 0 (current_func_at_0, which is the one at ACCEL_MIN_SPEED).
+#define ACCEL_MIN_DT_NS 10000ll // 100 kHz, twelve times the fastest polling rate there is
+#define ACCEL_MAX_DT_NS 100000000ll // 100 ms, like RawAccel
+#define ACCEL_MIN_SPEED FP64_0_01
+
+// Synchronous (gain) integral table, see update_constants()
+#define SYNC_START (-3)
+#define SYNC_STOP (9)
+#define SYNC_NUM (8)
+#define SYNC_CAPACITY ((SYNC_STOP - SYNC_START) * SYNC_NUM + 1)
+
+// New fields have to be added to lib/gen_fixed_profile.c as well
 struct ModesConstants {
     bool is_init;
 
@@ -26,12 +44,22 @@ struct ModesConstants {
     FP_LONG minSens;
     FP_LONG maxSens;
 
+    // Synchronous (gain)
+    FP_LONG sync_x_start;               // 2^SYNC_START
+    FP_LONG sync_data[SYNC_CAPACITY];   // monotonic over x
+
     // Classic
     FP_LONG sign;
     FP_LONG gain_constant;
     FP_LONG cap_x;
     FP_LONG cap_y;
 
+    // Linear, narrow kernel (see linear_select_kernel())
+    FP_LONG narrow_limit;       // Speeds below it are evaluated with 64 bit math, 0 if the profile doesn't fit it
+    FP_INT narrow_accel;        // Acceleration (with the sign of the cap), shifted right to fit in 32 bits
+    int narrow_speed_shift;     // Speed bits dropped to fit it in 32 bits
+    int narrow_product_shift;   // Brings the product of the two back to Q32.32
+
     // Jump
     FP_LONG C0; // the "integral" evaluated at 0
     FP_LONG r; // basically a smoothness factor
@@ -52,11 +80,23 @@ struct ModesConstants {
     FP_LONG as_half_threshold;
 };
 
-extern FP_LONG g_Sensitivity, g_SensitivityY, g_OutputCap, g_InputCap, g_Offset, g_PreScale, g_Acceleration, g_Exponent,
-        g_Midpoint, g_Motivity, g_RotationAngle, g_AngleSnap_Angle, g_AngleSnap_Threshold, g_LutData_x[], g_LutData_y[];
-extern char g_AccelerationMode, g_UseSmoothing;
-extern unsigned long g_LutSize;
-extern struct ModesConstants modesConst;
+// Everything the acceleration code needs to process a packet. A profile is validated and compiled (update_constants())
+// off the hot path, and never modified after being published, so it can be swapped with a single pointer write.
+struct accel_profile {
+    // User parameters, named after the module parameters
+    FP_LONG Sensitivity, SensitivityY, OutputCap, InputCap, Offset, PreScale, Acceleration, Exponent, Midpoint, Motivity,
+            RotationAngle, AngleSnap_Angle, AngleSnap_Threshold;
+    char AccelerationMode, UseSmoothing;
+    unsigned long LutSize;
+    FP_LONG LutData_x[MAX_LUT_ARRAY_SIZE];
+    FP_LONG LutData_y[MAX_LUT_ARRAY_SIZE];
+
+    // Aggregate values that don't change with speed to save on calculations done every irq
+    struct ModesConstants consts;
+
+    unsigned long long version; // Assigned when the profile is committed
+};
+
 static const FP_LONG FP64_PI =   C0NST_FP64_FromDouble(3.14159);
 static const FP_LONG FP64_PI_2 = C0NST_FP64_FromDouble(1.57079);
 static const FP_LONG FP64_PI_4 = C0NST_FP64_FromDouble(0.78539);
@@ -69,15 +109,22 @@ static const FP_LONG FP64_100     = 100ll << FP64_Shift;
 static const FP_LONG FP64_1000    = 1000ll << FP64_Shift;
 static const FP_LONG FP64_10000   = 10000ll << FP64_Shift;
 
-void update_constants(void);
+// Validates the parameters of the profile and calculates its constants.
+// Returns 0 on success, or -EINVAL if the parameters are invalid, in which case the mode falls back to AccelMode_Current.
+// That includes the profiles that could divide out of range or overflow at any of the inputs accel_pipeline() gets.
+int update_constants(struct accel_profile *profile);
+
+FP_LONG accel_linear(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_power(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_classic(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_motivity(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_synchronous(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_natural(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_jump(const struct accel_profile *profile, FP_LONG speed);
+FP_LONG accel_lut(const struct accel_profile *profile, FP_LONG speed);
 
-FP_LONG accel_linear(FP_LONG speed);
-FP_LONG accel_power(FP_LONG speed);
-FP_LONG accel_classic(FP_LONG speed);
-FP_LONG accel_motivity(FP_LONG speed);
-FP_LONG accel_synchronous(FP_LONG speed);
-FP_LONG accel_natural(FP_LONG speed);
-FP_LONG accel_jump(FP_LONG speed);
-FP_LONG accel_lut(FP_LONG speed);
+#ifdef __cplusplus
+}
+#endif
 
 #endif //ACCEL_MODES_H
@@ -0,0 +1,188 @@
+#ifndef ACCEL_PIPELINE_H
+#define ACCEL_PIPELINE_H
+
+// The acceleration pipeline run by accelerate() for every report, kept free of kernel dependencies
+// so that userspace tools (see tests/Replay.cpp) run exactly the same code.
+// The stages are separate so that the self-benchmark (see accel_benchmark()) can time every one of them on its own,
+// while accelerate() still gets them fully inlined.
+
+#include "accel.h"
+#include "accel_modes.h"
+#include "util.h"
+
+// Calculates the (pre-scaled, capped and offset) speed in counts/ms
+static INLINE FP_LONG accel_stage_speed(const struct accel_profile *profile, FP_LONG delta_x, FP_LONG delta_y, FP_LONG ms)
+{
+    //Calculate velocity (one step before rate, which divides rate by the last frametime)
+    FP_LONG speed = FP64_Sqrt(FP64_Add(FP64_Mul(delta_x, delta_x), FP64_Mul(delta_y, delta_y)));
+
+    // Apply Pre-Scale
+    if(profile->PreScale != FP64_1)
+        speed = FP64_Mul(speed, profile->PreScale);
+
+    //Apply speedcap
+    if(profile->InputCap > 0){
+        //if(speed >= profile->InputCap) {
+        if(FP64_Sub(speed, profile->InputCap) > 0) {
+            speed = profile->InputCap;
+        }
+    }
+
+    //Calculate rate from traveled overall distance and add possible rate offsets
+    speed = FP64_DivPrecise(speed, ms);
+    return FP64_Sub(speed, profile->Offset);
+}
+
+// Evaluates the selected acceleration curve, returns the (not yet sensitivity scaled) multiplier
+static INLINE FP_LONG accel_stage_curve(const struct accel_profile *profile, FP_LONG speed)
+{
+    static_assert(AccelMode_Count == 10, "Wrong AccelMode count!");
+    // Apply acceleration if movement is over offset (the profiles are verified from ACCEL_MIN_SPEED on)
+    if (speed >= ACCEL_MIN_SPEED) {
+        switch (profile->AccelerationMode) {
+            case AccelMode_Linear:
+                return accel_linear(profile, speed);
+            case AccelMode_Power:
+                return accel_power(profile, speed);
+            case AccelMode_Classic:
+                return accel_classic(profile, speed);
+            case AccelMode_Motivity:
+                return accel_motivity(profile, speed);
+            case AccelMode_Synchronous:
+                return accel_synchronous(profile, speed);
+            case AccelMode_Natural:
+                return accel_natural(profile, speed);
+            case AccelMode_Jump:
+                return accel_jump(profile, speed);
+            case AccelMode_Lut: case AccelMode_CustomCurve:
+                return accel_lut(profile, speed);
+            default:
+                return FP64_1;
+        }
+    }
+
+    return profile->consts.current_func_at_0;
+}
+
+// Actually apply accelerated sensitivity, allow post-scaling
+static INLINE void accel_stage_sensitivity(const struct accel_profile *profile, FP_LONG speed, FP_LONG *delta_x, FP_LONG *delta_y)
+{
+    // Like RawAccel, sensitivity will be a final multiplier:
+    if (profile->SensitivityY == FP64_1) {
+        if(profile->Sensitivity != FP64_1)
+            speed = FP64_Mul(speed, profile->Sensitivity);
+
+        // Apply Output Limit
+        if(profile->OutputCap > 0)
+            speed = FP64_Min(profile->OutputCap, speed);
+
+        // Apply acceleration
+        *delta_x = FP64_Mul(*delta_x, speed);
+        *delta_y = FP64_Mul(*delta_y, speed);
+    } else {
+        speed = FP64_Mul(speed, profile->Sensitivity);
+        FP_LONG speed_Y = FP64_Mul(speed, profile->SensitivityY);
+
+        // Apply Output Limit
+        if(profile->OutputCap > 0) {
+            speed = FP64_Min(profile->OutputCap, speed);
+            speed_Y = FP64_Min(profile->OutputCap, speed_Y);
+        }
+
+        // Apply acceleration
+        *delta_x = FP64_Mul(*delta_x, speed);
+        *delta_y = FP64_Mul(*delta_y, speed_Y);
+    }
+}
+
+static INLINE void accel_stage_snapping(const struct accel_profile *profile, FP_LONG *delta_x, FP_LONG *delta_y)
+{
+    // Angle Snapping
+    if(profile->consts.as_half_threshold != 0) {
+        FP_LONG delta_mag = FP64_Sqrt(FP64_Add(FP64_Mul(*delta_x, *delta_x), FP64_Mul(*delta_y, *delta_y)));
+        if (delta_mag != 0) {
+            FP_LONG current_angle = FP64_Atan2(*delta_y, *delta_x);
+            FP_LONG angle_diff = FP64_Sub(profile->AngleSnap_Angle, current_angle);
+            FP_LONG angle_diff_quarter = FP64_PI_2 - FP64_Abs(angle_diff);
+
+            int sign = FP64_Sign(angle_diff_quarter);
+            angle_diff_quarter = FP64_Abs(angle_diff_quarter) - FP64_PI_2;
+
+            if (FP64_Abs(angle_diff_quarter) <= profile->consts.as_half_threshold) {
+                *delta_x = FP64_Mul(profile->consts.as_cos, delta_mag) * sign;
+                *delta_y = FP64_Mul(profile->consts.as_sin, delta_mag) * sign;
+            }
+        }
+    }
+}
+
+static INLINE void accel_stage_rotation(const struct accel_profile *profile, FP_LONG *delta_x, FP_LONG *delta_y)
+{
+    // Apply Rotation after everything else to keep the precision
+    if(profile->RotationAngle != 0) {
+        FP_LONG new_delta_x = FP64_Mul(*delta_x, profile->consts.cos_a) - FP64_Mul(*delta_y, profile->consts.sin_a);
+        *delta_y = FP64_Mul(*delta_x, profile->consts.sin_a) + FP64_Mul(*delta_y, profile->consts.cos_a);
+        *delta_x = new_delta_x;
+    }
+}
+
+// Accelerates a single report. 'now_ns' is the (monotonic) time of the report in ns, passed in
+// so that the clock can be anything, like the timestamps of a recorded trace.
+static INLINE void accel_pipeline(const struct accel_profile *profile, struct accel_state *state, long long now_ns,
+                                  int *x, int *y)
+{
+    FP_LONG delta_x, delta_y, ms, speed;
+    long long dt;
+
+    delta_x = FP64_FromInt(*x);
+    delta_y = FP64_FromInt(*y);
+    //delta_whl = FP64_FromInt(*wheel);
+
+    //Calculate frametime
+    dt = now_ns - state->last_ns;
+    //int frac = dt % 10000;
+    // We can't just store milliseconds as this would lose a lot of precision (nano -> mili, that's 10^-6 difference).
+    // But we have only Q16.16 bits of precision, meaning 16 bits for the fractional part of the number (it's constant!).
+    // So it would be wasteful to store a millisecond in a fixed point format, because the integral part would be at max like 100
+    // and we would lose all the precision on the fractional part, so we move everything storing millis * 100.
+    // Now we have at max 10000 to store in the integral part (technically 0xFFFF) and a bit less information in the fractional part
+    // that would be lost either way.
+    /// THE ABOVE NO LONGER HOLDS, AS I'VE MOVED (AGAIN), THIS TIME TO 64bit FIXED POINT MATH
+    //ms = FP64_FromInt(dt / 10000ll) + FP64_Div(FP64_FromInt(frac), fp64_10000); // NOT MILLISECONDS, its ms * 100
+    // Kept within what the profiles are verified for (see update_constants()), the upper bound is the 100 ms of
+    // RawAccel (Original InterAccel has 200 here)
+    if(dt < ACCEL_MIN_DT_NS) dt = ACCEL_MIN_DT_NS;
+    if(dt > ACCEL_MAX_DT_NS) dt = ACCEL_MAX_DT_NS;
+    // dt < 2^31, so this needs no 128 bit division, same result as FP64_DivPrecise(FP64_FromInt(dt), 1000000 ms)
+    ms = (dt << FP64_Shift) / 1000000;
+    state->last_ns = now_ns;
+    //if(ms < 1) ms = last_ms;    //Sometimes, urbs appear bunched -> Beyond µs resolution so the timing reading is plain wrong. Fallback to last known valid frametime
+    // Editor node: I have no idea, what this line above really does, but commenting it out solves all my problems
+    // with incorrect data. It seems that it tries to fix a problem that doesn't exist, or doesn't exist on my
+    // specific setup (PC / System / Mice)
+
+    speed = accel_stage_speed(profile, delta_x, delta_y, ms);
+    speed = accel_stage_curve(profile, speed);
+    accel_stage_sensitivity(profile, speed, &delta_x, &delta_y);
+    accel_stage_snapping(profile, &delta_x, &delta_y);
+
+    // Apply carry from previous round
+    delta_x = FP64_Add(delta_x, state->carry_x);
+    delta_y = FP64_Add(delta_y, state->carry_y);
+
+    // I don't do wheel, sorry
+    //delta_whl *= g_ScrollsPerTick/3.0f;
+
+    accel_stage_rotation(profile, &delta_x, &delta_y);
+
+    //Cast back to int
+    *x = FP64_RoundToInt(delta_x);
+    *y = FP64_RoundToInt(delta_y);
+
+    //Save carry for next round
+    state->carry_x = FP64_Sub(delta_x, FP64_FromInt(*x));
+    state->carry_y = FP64_Sub(delta_y, FP64_FromInt(*y));
+    //carry_whl = delta_whl - *wheel;
+}
+
+#endif //ACCEL_PIPELINE_H
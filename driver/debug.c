@@ -0,0 +1,187 @@
+#include "debug.h"
+#include "accel.h"
+
+#include <linux/kernel.h>
+#include <linux/debugfs.h>
+#include <linux/fs.h>
+#include <linux/mutex.h>
+#include <linux/uaccess.h>
+#include <linux/slab.h>
+#include <linux/mm.h>
+
+#define BENCH_MAX_PASSES 100000
+#define BENCH_REPORT_SIZE 1024
+#define EVAL_MAX_POINTS 4096
+
+static struct dentry *debugfs_root;
+
+// ########## Self-benchmark
+
+static DEFINE_MUTEX(bench_lock);
+static char bench_report[BENCH_REPORT_SIZE] = "No benchmark has been run yet. Write the number of passes to this file to run one.\n";
+static size_t bench_report_len;
+
+static const char *bench_stage_names[AccelBenchStage_Count] = {
+    "speed",
+    "curve",
+    "sensitivity",
+    "snapping",
+    "rotation"
+};
+
+// Prints 'ns / ops' with 2 decimal places, there is no floating point in the kernel
+static int bench_print_per_op(char *buf, size_t size, const char *name, u64 ns, u64 ops)
+{
+    u64 centi_ns = div64_u64(ns * 100, ops);
+    return scnprintf(buf, size, "%-12s %llu.%02llu ns/op\n", name, div_u64(centi_ns, 100), centi_ns % 100);
+}
+
+static void bench_format_report(const struct accel_bench_result *res)
+{
+    u64 ops = (u64)res->passes * res->points;
+    size_t len = 0;
+    unsigned int stage;
+
+    len += scnprintf(bench_report + len, BENCH_REPORT_SIZE - len,
+                     "profile %llu (mode %d, smoothing %d), %u passes x %u speeds on CPU %d\n",
+                     res->version, res->mode, res->smoothing, res->passes, res->points, res->cpu);
+    len += bench_print_per_op(bench_report + len, BENCH_REPORT_SIZE - len, "total", res->total_ns, ops);
+    len += scnprintf(bench_report + len, BENCH_REPORT_SIZE - len, "%-12s %llu ns\n%-12s %llu ns\n",
+                     "min", res->op_min_ns, "max", res->op_max_ns);
+    for (stage = 0; stage < AccelBenchStage_Count; stage++)
+        len += bench_print_per_op(bench_report + len, BENCH_REPORT_SIZE - len,
+                                  bench_stage_names[stage], res->stage_ns[stage], ops);
+
+    bench_report_len = len;
+}
+
+static ssize_t bench_read(struct file *file, char __user *ubuf, size_t count, loff_t *ppos)
+{
+    ssize_t ret;
+
+    mutex_lock(&bench_lock);
+    if (bench_report_len == 0)
+        bench_report_len = strlen(bench_report);
+    ret = simple_read_from_buffer(ubuf, count, ppos, bench_report, bench_report_len);
+    mutex_unlock(&bench_lock);
+
+    return ret;
+}
+
+// Writing N runs the benchmark synchronously for N passes, the report can be read back afterwards
+static ssize_t bench_write(struct file *file, const char __user *ubuf, size_t count, loff_t *ppos)
+{
+    struct accel_bench_result res;
+    unsigned int passes;
+    int error;
+
+    error = kstrtouint_from_user(ubuf, count, 0, &passes);
+    if (error)
+        return error;
+
+    if (passes == 0 || passes > BENCH_MAX_PASSES) {
+        printk("YeetMouse: Error: Benchmark pass count has to be between 1 and %d\n", BENCH_MAX_PASSES);
+        return -EINVAL;
+    }
+
+    mutex_lock(&bench_lock);
+    error = accel_benchmark(passes, &res);
+    if (!error)
+        bench_format_report(&res);
+    mutex_unlock(&bench_lock);
+
+    return error ? error : count;
+}
+
+static const struct file_operations bench_fops = {
+    .owner = THIS_MODULE,
+    .read = bench_read,
+    .write = bench_write,
+    .llseek = default_llseek,
+};
+
+// ########## Batch evaluation
+// Userspace writes an array of Q32.32 input speeds (s64, native endianness) in a single write, then reads back
+// one Q32.32 multiplier per speed, evaluated with the live parameters by the very same code accelerate() runs.
+// The batch is kept per open file, and writes don't move the file position, so one write/read pair is all it takes.
+
+struct eval_batch {
+    unsigned int count;
+    s64 speeds[EVAL_MAX_POINTS];
+    s64 mults[EVAL_MAX_POINTS];
+};
+
+static int eval_open(struct inode *inode, struct file *file)
+{
+    struct eval_batch *batch = kvzalloc(sizeof(*batch), GFP_KERNEL);
+    if (!batch)
+        return -ENOMEM;
+
+    file->private_data = batch;
+    return 0;
+}
+
+static int eval_release(struct inode *inode, struct file *file)
+{
+    kvfree(file->private_data);
+    return 0;
+}
+
+static ssize_t eval_write(struct file *file, const char __user *ubuf, size_t count, loff_t *ppos)
+{
+    struct eval_batch *batch = file->private_data;
+
+    if (count == 0 || count % sizeof(s64) != 0 || count > sizeof(batch->speeds))
+        return -EINVAL;
+
+    if (copy_from_user(batch->speeds, ubuf, count))
+        return -EFAULT;
+
+    batch->count = count / sizeof(s64);
+    return count;
+}
+
+static ssize_t eval_read(struct file *file, char __user *ubuf, size_t count, loff_t *ppos)
+{
+    struct eval_batch *batch = file->private_data;
+
+    // Evaluate once per read-through, so that reading in chunks stays consistent
+    if (*ppos == 0) {
+        int error = accel_eval(batch->speeds, batch->mults, batch->count);
+        if (error)
+            return error;
+    }
+
+    return simple_read_from_buffer(ubuf, count, ppos, batch->mults, batch->count * sizeof(s64));
+}
+
+static const struct file_operations eval_fops = {
+    .owner = THIS_MODULE,
+    .open = eval_open,
+    .release = eval_release,
+    .read = eval_read,
+    .write = eval_write,
+    .llseek = default_llseek,
+};
+
+int yeetmouse_debugfs_init(void)
+{
+    debugfs_root = debugfs_create_dir("yeetmouse", NULL);
+    if (IS_ERR_OR_NULL(debugfs_root)) {
+        // Debugfs is optional, the driver works fine without it
+        printk("YeetMouse: debugfs is not available, profiling interface disabled\n");
+        debugfs_root = NULL;
+        return 0;
+    }
+
+    debugfs_create_file("benchmark", 0600, debugfs_root, NULL, &bench_fops);
+    debugfs_create_file("eval", 0600, debugfs_root, NULL, &eval_fops);
+
+    return 0;
+}
+
+void yeetmouse_debugfs_exit(void)
+{
+    debugfs_remove_recursive(debugfs_root);
+    debugfs_root = NULL;
+}
@@ -0,0 +1,9 @@
+#ifndef _DEBUG_H
+#define _DEBUG_H
+
+// Debugfs interface living in /sys/kernel/debug/yeetmouse, used for profiling and validating the driver
+
+int yeetmouse_debugfs_init(void);
+void yeetmouse_debugfs_exit(void);
+
+#endif /* _DEBUG_H */
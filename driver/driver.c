@@ -1,4 +1,5 @@
 #include "accel.h"
+#include "debug.h"
 #include "config.h"
 #include "util.h"
 
@@ -9,6 +10,8 @@
 #include <linux/usb/input.h>
 #include <linux/hid.h>
 #include <linux/version.h>
+#include <linux/glob.h>
+#include <linux/mutex.h>
 
 #define NONE_EVENT_VALUE 0
 
@@ -18,12 +21,203 @@
 #define __cleanup_events 1
 #endif
 
+#define BINDING_PASSTHROUGH (-2) // Leave the device alone
+#define MAX_BINDINGS 16
+#define MAX_BINDING_PHYS_LEN 64
+
 struct mouse_state {
     int x;
     int y;
     int wheel;
+    int slot; // Profile slot (from the bindings), ACCEL_SLOT_ACTIVE or BINDING_PASSTHROUGH
+    struct accel_state accel; // Carry and timing of this device only
+};
+
+// ########## Device bindings ('bindings')
+
+// 'vendor:product[:phys]=target', vendor and product in hex (or '*'), phys is a glob pattern
+struct binding_rule {
+    int vendor;  // -1 for any
+    int product; // -1 for any
+    char phys[MAX_BINDING_PHYS_LEN]; // Empty for any
+    int slot;    // Profile slot, ACCEL_SLOT_ACTIVE or BINDING_PASSTHROUGH
 };
 
+static struct binding_rule g_bindings[MAX_BINDINGS];
+static unsigned int g_bindings_count;
+static DEFINE_MUTEX(g_bindings_lock);
+
+extern struct input_handler driver_handler;
+
+// First matching rule wins, devices not matching any rule use the active profile
+static int binding_resolve(const struct input_dev *dev)
+{
+    unsigned int i;
+
+    lockdep_assert_held(&g_bindings_lock);
+
+    for (i = 0; i < g_bindings_count; i++) {
+        const struct binding_rule *rule = &g_bindings[i];
+
+        if (rule->vendor >= 0 && rule->vendor != dev->id.vendor)
+            continue;
+        if (rule->product >= 0 && rule->product != dev->id.product)
+            continue;
+        if (rule->phys[0] && !glob_match(rule->phys, dev->phys ?: ""))
+            continue;
+
+        return rule->slot;
+    }
+
+    return ACCEL_SLOT_ACTIVE;
+}
+
+static int binding_parse_id(const char *str, int *id)
+{
+    u16 val;
+
+    if (strcmp(str, "*") == 0) {
+        *id = -1;
+        return 0;
+    }
+
+    if (kstrtou16(str, 16, &val))
+        return -EINVAL;
+
+    *id = val;
+    return 0;
+}
+
+static int binding_parse_rule(char *line, struct binding_rule *rule)
+{
+    char *target = strrchr(line, '=');
+    char *vendor, *product;
+    unsigned int slot;
+
+    if (!target)
+        return -EINVAL;
+    *target++ = '\0';
+    target = strim(target);
+
+    // phys paths contain ':' too, so only the first two are separators
+    vendor = strsep(&line, ":");
+    product = strsep(&line, ":");
+    if (!product || binding_parse_id(strim(vendor), &rule->vendor) || binding_parse_id(strim(product), &rule->product))
+        return -EINVAL;
+
+    rule->phys[0] = '\0';
+    if (line) {
+        line = strim(line);
+        if (strscpy(rule->phys, strcmp(line, "*") == 0 ? "" : line, sizeof(rule->phys)) < 0)
+            return -EINVAL;
+    }
+
+    if (strcmp(target, "off") == 0)
+        rule->slot = BINDING_PASSTHROUGH;
+    else if (strcmp(target, "active") == 0)
+        rule->slot = ACCEL_SLOT_ACTIVE;
+    else if (!kstrtouint(target, 0, &slot) && slot < PROFILE_SLOTS)
+        rule->slot = slot;
+    else
+        return -EINVAL;
+
+    return 0;
+}
+
+static int binding_apply(struct input_handle *handle, void *data)
+{
+    struct mouse_state *state = handle->private;
+
+    WRITE_ONCE(state->slot, binding_resolve(handle->dev));
+    return 0;
+}
+
+static int bindings_set(const char *val, const struct kernel_param *kp)
+{
+    struct binding_rule *rules;
+    char *buf, *cur, *line;
+    unsigned int count = 0;
+    int error = 0;
+
+    rules = kcalloc(MAX_BINDINGS, sizeof(*rules), GFP_KERNEL);
+    buf = kstrdup(val, GFP_KERNEL);
+    if (!rules || !buf) {
+        kfree(rules);
+        kfree(buf);
+        return -ENOMEM;
+    }
+
+    // One rule per line (or separated with ';'), '#' starts a comment
+    cur = buf;
+    while (!error && (line = strsep(&cur, "\n;")) != NULL) {
+        line = strim(line);
+        if (*line == '\0' || *line == '#')
+            continue;
+
+        if (count == MAX_BINDINGS) {
+            printk("YeetMouse: Error: Too many device bindings (%d max).\n", MAX_BINDINGS);
+            error = -EINVAL;
+        } else if ((error = binding_parse_rule(line, &rules[count])) != 0) {
+            printk("YeetMouse: Error: Invalid device binding, expected 'vendor:product[:phys]=slot|active|off'.\n");
+        } else
+            count++;
+    }
+    kfree(buf);
+
+    if (!error) {
+        mutex_lock(&g_bindings_lock);
+        memcpy(g_bindings, rules, sizeof(*rules) * count);
+        g_bindings_count = count;
+        // Resolve it right away for the devices already connected, the event path never looks it up
+        input_handler_for_each_handle(&driver_handler, NULL, binding_apply);
+        mutex_unlock(&g_bindings_lock);
+    }
+    kfree(rules);
+
+    return error;
+}
+
+static int bindings_get(char *buffer, const struct kernel_param *kp)
+{
+    unsigned int i;
+    int len = 0;
+
+    mutex_lock(&g_bindings_lock);
+    for (i = 0; i < g_bindings_count; i++) {
+        const struct binding_rule *rule = &g_bindings[i];
+
+        if (rule->vendor >= 0)
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "%04x:", rule->vendor);
+        else
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "*:");
+        if (rule->product >= 0)
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "%04x", rule->product);
+        else
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "*");
+        if (rule->phys[0])
+            len += scnprintf(buffer + len, PAGE_SIZE - len, ":%s", rule->phys);
+
+        if (rule->slot == BINDING_PASSTHROUGH)
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "=off\n");
+        else if (rule->slot == ACCEL_SLOT_ACTIVE)
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "=active\n");
+        else
+            len += scnprintf(buffer + len, PAGE_SIZE - len, "=%d\n", rule->slot);
+    }
+    mutex_unlock(&g_bindings_lock);
+
+    return len;
+}
+
+static const struct kernel_param_ops bindings_ops = { .set = bindings_set, .get = bindings_get };
+module_param_cb(bindings, &bindings_ops, NULL, 0644);
+MODULE_PARM_DESC(bindings, "Device to profile slot bindings, 'vendor:product[:phys]=slot|active|off' per line");
+
+// Checked when a device connects, so it has to be set before the virtual device is created
+static bool g_match_virtual = false;
+module_param_named(match_virtual, g_match_virtual, bool, 0644);
+MODULE_PARM_DESC(match_virtual, "Also accelerate virtual mice (without a parent device, e.g. uinput), for testing");
+
 #if __cleanup_events
 static unsigned int driver_events(struct input_handle *handle, struct input_value *vals, unsigned int count) {
 #else
@@ -37,6 +231,9 @@ static unsigned int driver_events(struct input_handle *handle, struct input_valu
     struct input_value *v;
     int error;
 
+    if (READ_ONCE(state->slot) == BINDING_PASSTHROUGH)
+        goto unchanged_return;
+
     for (v = (struct input_value *) vals; v != vals + count; v++) {
         if (v->type == EV_REL) {
             /* Find input_value for EV_REL events we're interested in and store values */
@@ -69,7 +266,7 @@ static unsigned int driver_events(struct input_handle *handle, struct input_valu
         /* If we found no values to update, return */
         if (x == NONE_EVENT_VALUE && y == NONE_EVENT_VALUE && wheel == NONE_EVENT_VALUE)
             goto unchanged_return;
-        error = accelerate(&x, &y);
+        error = accelerate(READ_ONCE(state->slot), &state->accel, &x, &y);
         /* Reset state */
         state->x = NONE_EVENT_VALUE;
         state->y = NONE_EVENT_VALUE;
@@ -161,10 +358,11 @@ unchanged_return:
 }
 
 static bool driver_match(struct input_handler *handler, struct input_dev *dev) {
-    if (!dev->dev.parent)
+    // Virtual devices (e.g. uinput) have no parent, they are only matched on request (for testing, see tests/)
+    if (!dev->dev.parent && !READ_ONCE(g_match_virtual))
         return false;
-    struct hid_device *hdev = to_hid_device(dev->dev.parent);
-    printk("Yeetmouse: found a possible mouse %s", hdev->name);
+    // Not every parent is a HID device (PS/2, virtual devices), so only the input device's own name is safe to use
+    printk("Yeetmouse: found a possible mouse %s", dev->name ?: "unknown");
     //return hdev->type == HID_TYPE_USBMOUSE; // This only detects USB mice, not bluetooth, or other mice (like PS/2)
 
     // Discard if doesn't have left button key capabilities
@@ -229,10 +427,16 @@ static int driver_connect(struct input_handler *handler, struct input_dev *dev,
     handle->handler = handler;
     handle->name = "yeetmouse";
 
+    // Resolved once here (and on 'bindings' change), so that the events don't need any lookups.
+    // The lock is held until the handle is on the handler's list, so that a 'bindings' write can't miss the device.
+    mutex_lock(&g_bindings_lock);
+    state->slot = binding_resolve(dev);
+
     /* WARN: Instead of `input_register_handle` we use a customized version of it here.
      * This prepends the handler (like a filter) instead of appending it, making
      * it take precedence over any other input handler that'll be added. */
     error = input_register_handle_head(handle);
+    mutex_unlock(&g_bindings_lock);
     if (error)
         goto err_free_mem;
 
@@ -240,8 +444,12 @@ static int driver_connect(struct input_handler *handler, struct input_dev *dev,
     if (error)
         goto err_unregister_handle;
 
-    printk(pr_fmt("Yeetmouse: connecting to device: %s (%s at %s)"), dev_name(&dev->dev), dev->name ?: "unknown",
-           dev->phys ?: "unknown");
+    printk(pr_fmt("Yeetmouse: connecting to device: %s (%s at %s, %04x:%04x)"), dev_name(&dev->dev),
+           dev->name ?: "unknown", dev->phys ?: "unknown", dev->id.vendor, dev->id.product);
+    if (state->slot == BINDING_PASSTHROUGH)
+        printk(pr_fmt("Yeetmouse: device bound to passthrough, leaving it alone"));
+    else if (state->slot != ACCEL_SLOT_ACTIVE)
+        printk(pr_fmt("Yeetmouse: device bound to profile slot %d"), state->slot);
 
     return 0;
 
@@ -272,6 +480,8 @@ static const struct input_device_id driver_ids[] = {
 MODULE_DEVICE_TABLE(input, driver_ids);
 
 struct input_handler driver_handler = {
+    // Walked by bindings_set(), which also runs for the bindings given at load time (before the handler is registered)
+    .h_list = LIST_HEAD_INIT(driver_handler.h_list),
     .name = "yeetmouse",
     .id_table = driver_ids,
     .events = driver_events,
@@ -281,11 +491,24 @@ struct input_handler driver_handler = {
 };
 
 static int __init yeetmouse_init(void) {
-    return input_register_handler(&driver_handler);
+    int error = accel_init();
+    if (error)
+        return error;
+
+    error = input_register_handler(&driver_handler);
+    if (error) {
+        accel_exit();
+        return error;
+    }
+
+    yeetmouse_debugfs_init();
+    return 0;
 }
 
 static void __exit yeetmouse_exit(void) {
+    yeetmouse_debugfs_exit();
     input_unregister_handler(&driver_handler);
+    accel_exit();
 }
 
 MODULE_DESCRIPTION("USB HID input handler applying mouse acceleration (Yeetmouse)");
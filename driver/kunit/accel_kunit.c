@@ -0,0 +1,730 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// KUnit tests of the acceleration code and the device bindings, runnable under User-Mode Linux (see scripts/run_kunit.sh).
+// The sources are included, so that the static parts (parameter parsing, profile commit, bindings) can be tested directly.
+
+#include <kunit/test.h>
+#include <linux/math64.h>
+
+#include "../accel_modes.c"
+#include "../accel.c"
+#include "../debug.c"
+
+// The input handler never gets registered here, like when the module parameters are given at load time
+#pragma push_macro("module_init")
+#pragma push_macro("module_exit")
+#undef module_init
+#undef module_exit
+#define module_init(fn) static initcall_t __maybe_unused yeetmouse_unregistered_init = fn
+#define module_exit(fn) static exitcall_t __maybe_unused yeetmouse_unregistered_exit = fn
+#include "../driver.c"
+#pragma pop_macro("module_init")
+#pragma pop_macro("module_exit")
+
+#define TEST_SPEED_STEPS 400 // Speeds evaluated per mode, in steps of 0.5 counts/ms
+#define TEST_BENCH_PASSES 64
+#define TEST_ACCEL_CALLS 4096
+
+// Parses a fixed point number, there is no floating point in the kernel
+static FP_LONG fp(const char *str)
+{
+    FP_LONG value = 0;
+
+    FP64_FromString(str, &value);
+    return value;
+}
+
+#define TEST_PARAM_SET(param, val) do {                         \
+        struct kernel_param kp = { .arg = &g_param_##param };   \
+        param_set_charp(val, &kp);                              \
+    } while (0)
+
+// Every case starts with all the slots empty and the legacy parameters at known values, loaded into the first slot
+static int accel_test_init(struct kunit *test)
+{
+    accel_exit();
+
+    TEST_PARAM_SET(InputCap, "0");
+    TEST_PARAM_SET(Sensitivity, "1");
+    TEST_PARAM_SET(SensitivityY, "1");
+    TEST_PARAM_SET(OutputCap, "0");
+    TEST_PARAM_SET(Offset, "0");
+    TEST_PARAM_SET(PreScale, "1");
+    TEST_PARAM_SET(Acceleration, "0.1");
+    TEST_PARAM_SET(Exponent, "1.8");
+    TEST_PARAM_SET(Midpoint, "1.3");
+    TEST_PARAM_SET(Motivity, "1.5");
+    TEST_PARAM_SET(RotationAngle, "0");
+    TEST_PARAM_SET(AngleSnap_Threshold, "0");
+    TEST_PARAM_SET(AngleSnap_Angle, "0");
+    g_AccelerationMode = AccelMode_Current;
+    g_UseSmoothing = 1;
+    g_LutSize = 0;
+    g_param_LutDataBuf[0] = '\0';
+    g_active_slot = 0;
+
+    return accel_init();
+}
+
+static void accel_test_exit(struct kunit *test)
+{
+    accel_exit();
+}
+
+// Copy of the profile in use, freed with the test
+static struct accel_profile *active_profile(struct kunit *test)
+{
+    struct accel_profile *copy = kunit_kmalloc(test, sizeof(*copy), GFP_KERNEL);
+    struct accel_profile *profile = accel_profile_dup();
+
+    KUNIT_ASSERT_NOT_NULL(test, copy);
+    KUNIT_ASSERT_NOT_NULL(test, profile);
+    memcpy(copy, profile, sizeof(*copy));
+    kfree(profile);
+    return copy;
+}
+
+static unsigned long long active_version(void)
+{
+    unsigned long long version;
+
+    rcu_read_lock();
+    version = rcu_dereference(g_profile)->version;
+    rcu_read_unlock();
+
+    return version;
+}
+
+// Builds a profile from 'Name=Value' lines on top of a neutral one (smoothing on, like the default config),
+// without validating or committing it
+static struct accel_profile *parse_profile(struct kunit *test, const char *text)
+{
+    struct accel_profile *profile = kunit_kzalloc(test, sizeof(*profile), GFP_KERNEL);
+    char *buf = kunit_kzalloc(test, strlen(text) + 1, GFP_KERNEL);
+    char *cur = buf, *line;
+    long lut_size = -2;
+
+    KUNIT_ASSERT_NOT_NULL(test, profile);
+    KUNIT_ASSERT_NOT_NULL(test, buf);
+
+    profile->Sensitivity = FP64_1;
+    profile->SensitivityY = FP64_1;
+    profile->PreScale = FP64_1;
+    profile->UseSmoothing = 1;
+
+    strcpy(buf, text);
+    while ((line = strsep(&cur, "\n")) != NULL) {
+        line = strim(line);
+        if (*line)
+            KUNIT_ASSERT_EQ_MSG(test, parse_profile_line(line, profile, &lut_size), 0, "'%s'", line);
+    }
+
+    return profile;
+}
+
+// ########## Legacy interface (update_params())
+
+static void update_params_parses_test(struct kunit *test)
+{
+    struct accel_profile *profile;
+
+    TEST_PARAM_SET(Sensitivity, "2.5");
+    TEST_PARAM_SET(SensitivityY, "0.75");
+    TEST_PARAM_SET(Acceleration, "0.25\n"); // As written from a shell
+    TEST_PARAM_SET(Exponent, "3");
+    TEST_PARAM_SET(Midpoint, "4.5");
+    TEST_PARAM_SET(PreScale, "0.5");
+    TEST_PARAM_SET(RotationAngle, "-0.125");
+    g_AccelerationMode = AccelMode_Classic;
+    g_UseSmoothing = 0;
+
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    profile = active_profile(test);
+
+    KUNIT_EXPECT_EQ(test, profile->AccelerationMode, AccelMode_Classic);
+    KUNIT_EXPECT_EQ(test, profile->UseSmoothing, 0);
+    KUNIT_EXPECT_EQ(test, profile->Sensitivity, fp("2.5"));
+    KUNIT_EXPECT_EQ(test, profile->SensitivityY, fp("0.75"));
+    KUNIT_EXPECT_EQ(test, profile->Acceleration, fp("0.25"));
+    KUNIT_EXPECT_EQ(test, profile->Exponent, FP64_FromInt(3));
+    KUNIT_EXPECT_EQ(test, profile->Midpoint, fp("4.5"));
+    KUNIT_EXPECT_EQ(test, profile->PreScale, FP64_0_5);
+    KUNIT_EXPECT_EQ(test, profile->RotationAngle, -fp("0.125"));
+    KUNIT_EXPECT_TRUE(test, profile->consts.is_init);
+}
+
+static void update_params_lut_test(struct kunit *test)
+{
+    struct accel_profile *profile;
+
+    strscpy(g_param_LutDataBuf, "1,1.5;2,2.5;10,4;", sizeof(g_param_LutDataBuf));
+    g_LutSize = 3;
+    g_AccelerationMode = AccelMode_Lut;
+
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    profile = active_profile(test);
+
+    KUNIT_EXPECT_EQ(test, profile->AccelerationMode, AccelMode_Lut);
+    KUNIT_ASSERT_EQ(test, profile->LutSize, 3);
+    KUNIT_EXPECT_EQ(test, profile->LutData_x[0], FP64_1);
+    KUNIT_EXPECT_EQ(test, profile->LutData_y[0], fp("1.5"));
+    KUNIT_EXPECT_EQ(test, profile->LutData_x[2], FP64_10);
+    KUNIT_EXPECT_EQ(test, profile->LutData_y[2], FP64_FromInt(4));
+
+    // LutSize limits the number of points read
+    g_LutSize = 2;
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->LutSize, 2);
+}
+
+// The legacy interface never fails, invalid parameters make the driver fall back to no acceleration
+static void update_params_invalid_test(struct kunit *test)
+{
+    // Odd number of values
+    strscpy(g_param_LutDataBuf, "1,1.5;2", sizeof(g_param_LutDataBuf));
+    g_LutSize = 2;
+    g_AccelerationMode = AccelMode_Lut;
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->AccelerationMode, AccelMode_Current);
+    KUNIT_EXPECT_EQ(test, g_AccelerationMode, AccelMode_Current); // Reported back
+
+    // Not a number, so 0, which Linear doesn't support
+    TEST_PARAM_SET(Acceleration, "fast");
+    g_AccelerationMode = AccelMode_Linear;
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->AccelerationMode, AccelMode_Current);
+
+    g_AccelerationMode = AccelMode_Count;
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->AccelerationMode, AccelMode_Current);
+
+    // Out of [0, PI), ignored
+    TEST_PARAM_SET(AngleSnap_Threshold, "4");
+    KUNIT_ASSERT_EQ(test, update_params(), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->AngleSnap_Threshold, 0);
+}
+
+static void update_set_test(struct kunit *test)
+{
+    unsigned long long version = active_version();
+
+    KUNIT_EXPECT_EQ(test, update_set("0", NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_version(), version);
+    KUNIT_EXPECT_EQ(test, update_set("1\n", NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_version(), version + 1);
+    KUNIT_EXPECT_EQ(test, update_set("maybe", NULL), -EINVAL);
+}
+
+// ########## Atomic interface ('profile', 'active_profile')
+
+static void profile_parses_test(struct kunit *test)
+{
+    unsigned long long version = active_version();
+    struct accel_profile *profile;
+
+    KUNIT_ASSERT_EQ(test, profile_set("# Comment\nAccelerationMode=2\n  Exponent = 0.5 \n\nAcceleration=0.1\n"
+                                      "Midpoint=0\nUseSmoothing=0\n", NULL), 0);
+    profile = active_profile(test);
+
+    KUNIT_EXPECT_EQ(test, profile->AccelerationMode, AccelMode_Power);
+    KUNIT_EXPECT_EQ(test, profile->Exponent, FP64_0_5);
+    KUNIT_EXPECT_EQ(test, profile->Acceleration, fp("0.1"));
+    KUNIT_EXPECT_EQ(test, profile->Motivity, fp("1.5")); // Not given, kept
+    KUNIT_EXPECT_EQ(test, profile->version, version + 1);
+
+    // Mirrored in the legacy parameters
+    KUNIT_EXPECT_STREQ(test, g_param_Exponent, "0.50000");
+    KUNIT_EXPECT_EQ(test, g_AccelerationMode, AccelMode_Power);
+
+    // Explicit versions have to be newer
+    KUNIT_EXPECT_EQ(test, profile_set("Version=100\nExponent=0.6\n", NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_version(), 100);
+}
+
+static void profile_rejects_test(struct kunit *test)
+{
+    static const char *const invalid[] = {
+        "Acceleration=0.2\nFoo=1\n",
+        "Acceleration\n",
+        "Acceleration=fast\n",
+        "AccelerationMode=256\n",
+        "AccelerationMode=42\n",
+        "AccelerationMode=1\nAcceleration=0\n",
+        "AngleSnap_Threshold=4\n",
+        "LutSize=3\nLutDataBuf=1,1;2,2;\n",
+        "LutSize=129\n",
+        "LutDataBuf=1,1;2\n",
+        "Version=1\n",
+        "Acceleration=0.2\nSlot=1\n",
+        "Slot=8\n",
+    };
+    unsigned long long version = active_version();
+    FP_LONG acceleration = active_profile(test)->Acceleration;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(invalid); i++)
+        KUNIT_EXPECT_LT_MSG(test, profile_set(invalid[i], NULL), 0, "'%s'", invalid[i]);
+
+    // Rejected as a whole
+    KUNIT_EXPECT_EQ(test, active_version(), version);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->Acceleration, acceleration);
+}
+
+static void profile_slots_test(struct kunit *test)
+{
+    char *buf = kunit_kzalloc(test, PAGE_SIZE, GFP_KERNEL);
+
+    KUNIT_ASSERT_NOT_NULL(test, buf);
+    KUNIT_ASSERT_EQ(test, profile_set("Slot=3\nSensitivity=3\n", NULL), 0);
+    // Stored, but not in use
+    KUNIT_EXPECT_EQ(test, active_profile(test)->Sensitivity, FP64_1);
+
+    KUNIT_EXPECT_EQ(test, active_profile_set("5", NULL), -ENOENT);
+    KUNIT_EXPECT_EQ(test, active_profile_set("8", NULL), -EINVAL);
+    KUNIT_ASSERT_EQ(test, active_profile_set("3\n", NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->Sensitivity, FP64_FromInt(3));
+    KUNIT_EXPECT_STREQ(test, g_param_Sensitivity, "3.0");
+
+    KUNIT_ASSERT_GT(test, active_profile_get(buf, NULL), 0);
+    KUNIT_EXPECT_STREQ(test, buf, "3\n");
+    KUNIT_ASSERT_GT(test, profile_get(buf, NULL), 0);
+    KUNIT_EXPECT_TRUE(test, strncmp(buf, "Slot=3\n", 7) == 0);
+
+    // Switching back doesn't touch either of them
+    KUNIT_ASSERT_EQ(test, active_profile_set("0", NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->Sensitivity, FP64_1);
+}
+
+// What profile_get() prints has to be accepted by profile_set(), and give the same profile
+static void profile_round_trip_test(struct kunit *test)
+{
+    char *buf = kunit_kzalloc(test, PAGE_SIZE, GFP_KERNEL);
+    char *text;
+
+    KUNIT_ASSERT_NOT_NULL(test, buf);
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=8\nLutDataBuf=0,1;10,1.5;50,2;200,3;\nSensitivity=1.25\n"
+                                      "RotationAngle=0.1\n", NULL), 0);
+    KUNIT_ASSERT_GT(test, profile_get(buf, NULL), 0);
+
+    // Without the version, it would have to be newer
+    text = strstr(buf, "Version=");
+    KUNIT_ASSERT_NOT_NULL(test, text);
+    *text = '#';
+
+    KUNIT_ASSERT_EQ(test, profile_set(buf, NULL), 0);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->LutSize, 4);
+    KUNIT_EXPECT_EQ(test, active_profile(test)->LutData_y[3], FP64_FromInt(3));
+    KUNIT_EXPECT_EQ(test, active_profile(test)->Sensitivity, fp("1.25"));
+}
+
+static struct kunit_case accel_params_test_cases[] = {
+    KUNIT_CASE(update_params_parses_test),
+    KUNIT_CASE(update_params_lut_test),
+    KUNIT_CASE(update_params_invalid_test),
+    KUNIT_CASE(update_set_test),
+    KUNIT_CASE(profile_parses_test),
+    KUNIT_CASE(profile_rejects_test),
+    KUNIT_CASE(profile_slots_test),
+    KUNIT_CASE(profile_round_trip_test),
+    {}
+};
+
+static struct kunit_suite accel_params_test_suite = {
+    .name = "yeetmouse_params",
+    .init = accel_test_init,
+    .exit = accel_test_exit,
+    .test_cases = accel_params_test_cases,
+};
+
+// ########## Validation (update_constants())
+
+struct constants_case {
+    const char *desc;
+    const char *profile;
+    int error;
+};
+
+static const struct constants_case constants_cases[] = {
+    { "linear", "AccelerationMode=1\nAcceleration=0.1\n", 0 },
+    { "linear, no acceleration", "AccelerationMode=1\nAcceleration=0\n", -EINVAL },
+    { "power", "AccelerationMode=2\nAcceleration=0.1\nExponent=0.5\nMidpoint=0.5\nMotivity=2\n", 0 },
+    { "power, exponent 0", "AccelerationMode=2\nAcceleration=0.1\nExponent=0\n", -EINVAL },
+    { "power, exponent -1", "AccelerationMode=2\nAcceleration=0.1\nExponent=-1\n", -EINVAL },
+    { "power, offset over the cap", "AccelerationMode=2\nAcceleration=0.1\nExponent=0.5\nMidpoint=3\nMotivity=2\n",
+      -EINVAL },
+    { "power, offset too far", "AccelerationMode=2\nAcceleration=0.001\nExponent=0.5\nMidpoint=1\nMotivity=2\n",
+      -EINVAL },
+    { "classic", "AccelerationMode=3\nAcceleration=0.05\nExponent=2\nMidpoint=3\n", 0 },
+    { "classic, exponent 1", "AccelerationMode=3\nAcceleration=0.05\nExponent=1\n", -EINVAL },
+    { "classic, exponent 1, no cap", "AccelerationMode=3\nAcceleration=0.05\nExponent=1\nUseSmoothing=0\n", 0 },
+    { "motivity", "AccelerationMode=4\nAcceleration=0.2\nMidpoint=10\nMotivity=2\n", 0 },
+    { "synchronous", "AccelerationMode=5\nAcceleration=5\nExponent=0.5\nMidpoint=0.5\nMotivity=1.5\n", 0 },
+    { "synchronous, motivity 1", "AccelerationMode=5\nAcceleration=5\nMotivity=1\n", -EINVAL },
+    { "natural", "AccelerationMode=6\nAcceleration=0.1\nExponent=2\n", 0 },
+    { "natural, exponent 1", "AccelerationMode=6\nAcceleration=0.1\nExponent=1\n", -EINVAL },
+    { "natural, no acceleration", "AccelerationMode=6\nAcceleration=0\nExponent=2\n", -EINVAL },
+    { "jump", "AccelerationMode=7\nAcceleration=2\nExponent=0.2\nMidpoint=20\n", 0 },
+    { "jump, midpoint 0", "AccelerationMode=7\nAcceleration=2\nMidpoint=0\n", -EINVAL },
+    { "lut", "AccelerationMode=8\nLutDataBuf=0,1;10,1.5;50,2;\n", 0 },
+    { "lut, single point", "AccelerationMode=8\nLutDataBuf=10,1.5;\n", -EINVAL },
+    { "lut, unsorted", "AccelerationMode=8\nLutDataBuf=0,1;50,2;10,1.5;\n", -EINVAL },
+    { "lut, duplicate end", "AccelerationMode=8\nLutDataBuf=0,1;10,1.5;10,2;\n", -EINVAL },
+    { "custom curve", "AccelerationMode=9\nLutDataBuf=0,1;10,1.5;50,2;\n", 0 },
+};
+
+static void constants_case_desc(const struct constants_case *c, char *desc)
+{
+    strscpy(desc, c->desc, KUNIT_PARAM_DESC_SIZE);
+}
+
+KUNIT_ARRAY_PARAM(constants, constants_cases, constants_case_desc);
+
+static void update_constants_test(struct kunit *test)
+{
+    const struct constants_case *c = test->param_value;
+    struct accel_profile *profile = parse_profile(test, c->profile);
+    char mode = profile->AccelerationMode;
+
+    KUNIT_EXPECT_EQ(test, update_constants(profile), c->error);
+    KUNIT_EXPECT_TRUE(test, profile->consts.is_init);
+
+    // Invalid profiles fall back to no acceleration, so that the legacy interface can still apply them
+    KUNIT_EXPECT_EQ(test, profile->AccelerationMode, c->error ? AccelMode_Current : mode);
+    if (c->error)
+        KUNIT_EXPECT_EQ(test, profile->consts.current_func_at_0, FP64_1);
+}
+
+static struct kunit_case accel_constants_test_cases[] = {
+    KUNIT_CASE_PARAM(update_constants_test, constants_gen_params),
+    {}
+};
+
+static struct kunit_suite accel_constants_test_suite = {
+    .name = "yeetmouse_constants",
+    .test_cases = accel_constants_test_cases,
+};
+
+// ########## Acceleration modes
+
+struct mode_case {
+    const char *desc;
+    const char *profile;
+    FP_LONG (*accel)(const struct accel_profile *profile, FP_LONG speed);
+};
+
+// Valid profiles of every mode, with and without smoothing (gain) where it matters
+static const struct mode_case mode_cases[] = {
+    { "linear", "AccelerationMode=1\nAcceleration=0.1\nUseSmoothing=0\n", accel_linear },
+    { "linear, capped", "AccelerationMode=1\nAcceleration=0.1\nMidpoint=3\n", accel_linear },
+    { "power", "AccelerationMode=2\nAcceleration=0.1\nExponent=0.5\nMidpoint=0\nUseSmoothing=0\n", accel_power },
+    { "power, capped", "AccelerationMode=2\nAcceleration=0.1\nExponent=0.5\nMidpoint=0.5\nMotivity=2\n", accel_power },
+    { "classic", "AccelerationMode=3\nAcceleration=0.05\nExponent=2\nUseSmoothing=0\n", accel_classic },
+    { "classic, capped", "AccelerationMode=3\nAcceleration=0.05\nExponent=2\nMidpoint=3\n", accel_classic },
+    { "motivity", "AccelerationMode=4\nAcceleration=0.2\nMidpoint=10\nMotivity=2\n", accel_motivity },
+    { "synchronous", "AccelerationMode=5\nAcceleration=5\nExponent=0.5\nMidpoint=0.5\nMotivity=1.5\nUseSmoothing=0\n",
+      accel_synchronous },
+    { "synchronous, gain", "AccelerationMode=5\nAcceleration=5\nExponent=0.5\nMidpoint=0.5\nMotivity=1.5\n",
+      accel_synchronous },
+    { "natural", "AccelerationMode=6\nAcceleration=0.1\nExponent=2\nUseSmoothing=0\n", accel_natural },
+    { "natural, gain", "AccelerationMode=6\nAcceleration=0.1\nExponent=2\n", accel_natural },
+    { "jump", "AccelerationMode=7\nAcceleration=2\nExponent=0.2\nMidpoint=20\n", accel_jump },
+    { "lut", "AccelerationMode=8\nLutDataBuf=0,1;10,1.5;50,2;200,3;\n", accel_lut },
+};
+
+static void mode_case_desc(const struct mode_case *c, char *desc)
+{
+    strscpy(desc, c->desc, KUNIT_PARAM_DESC_SIZE);
+}
+
+KUNIT_ARRAY_PARAM(modes, mode_cases, mode_case_desc);
+
+// Every mode has to give a sane, continuous multiplier over the whole range of speeds
+static void accel_mode_test(struct kunit *test)
+{
+    const struct mode_case *c = test->param_value;
+    struct accel_profile *profile = parse_profile(test, c->profile);
+    FP_LONG prev = 0;
+    int i;
+
+    KUNIT_ASSERT_EQ(test, update_constants(profile), 0);
+
+    for (i = 1; i <= TEST_SPEED_STEPS; i++) {
+        FP_LONG speed = FP64_FromInt(i) / 2;
+        FP_LONG value = c->accel(profile, speed);
+
+        // Same as what the pipeline runs
+        KUNIT_EXPECT_EQ(test, accel_stage_curve(profile, speed), value);
+
+        KUNIT_EXPECT_GT_MSG(test, value, 0, "at speed %d/2", i);
+        KUNIT_EXPECT_LT_MSG(test, value, FP64_100, "at speed %d/2", i);
+        // No jumps, a step of 0.5 counts/ms changes the multiplier by less than half
+        if (i > 1)
+            KUNIT_EXPECT_LT_MSG(test, FP64_Abs(value - prev), prev / 2, "at speed %d/2", i);
+
+        prev = value;
+    }
+
+    // Below the offset (or standing still) the multiplier is the one at 0
+    KUNIT_EXPECT_EQ(test, accel_stage_curve(profile, 0), profile->consts.current_func_at_0);
+}
+
+// Exact values, where they are easy to get
+static void accel_values_test(struct kunit *test)
+{
+    struct accel_profile *profile;
+    FP_LONG tolerance = FP64_1 >> 16;
+
+    // 1 + acceleration * speed
+    profile = parse_profile(test, "AccelerationMode=1\nAcceleration=0.125\nUseSmoothing=0\n");
+    KUNIT_ASSERT_EQ(test, update_constants(profile), 0);
+    KUNIT_EXPECT_EQ(test, accel_linear(profile, FP64_FromInt(8)), FP64_FromInt(2));
+    KUNIT_EXPECT_EQ(test, accel_linear(profile, FP64_FromInt(40)), FP64_FromInt(6));
+
+    // Gain cap at the midpoint, the multiplier only approaches it
+    profile = parse_profile(test, "AccelerationMode=1\nAcceleration=0.125\nMidpoint=3\n");
+    KUNIT_ASSERT_EQ(test, update_constants(profile), 0);
+    KUNIT_EXPECT_LT(test, accel_linear(profile, FP64_FromInt(10000)), FP64_FromInt(3));
+    KUNIT_EXPECT_GT(test, accel_linear(profile, FP64_FromInt(10000)), FP64_FromInt(3) - FP64_0_01);
+
+    // The LUT goes through its points, and is linear in between
+    profile = parse_profile(test, "AccelerationMode=8\nLutDataBuf=0,1;10,1.5;50,2;200,3;\n");
+    KUNIT_ASSERT_EQ(test, update_constants(profile), 0);
+    KUNIT_EXPECT_LE(test, FP64_Abs(accel_lut(profile, FP64_10) - fp("1.5")), tolerance);
+    KUNIT_EXPECT_LE(test, FP64_Abs(accel_lut(profile, FP64_FromInt(30)) - fp("1.75")), tolerance);
+    KUNIT_EXPECT_LE(test, FP64_Abs(accel_lut(profile, FP64_FromInt(200)) - FP64_FromInt(3)), tolerance);
+
+    // Motivity is a sigmoid between 1 / motivity and motivity, centered at the midpoint
+    profile = parse_profile(test, "AccelerationMode=4\nAcceleration=0.2\nMidpoint=10\nMotivity=2\n");
+    KUNIT_ASSERT_EQ(test, update_constants(profile), 0);
+    KUNIT_EXPECT_LT(test, accel_motivity(profile, FP64_1), FP64_1);
+}
+
+static struct kunit_case accel_modes_test_cases[] = {
+    KUNIT_CASE_PARAM(accel_mode_test, modes_gen_params),
+    KUNIT_CASE(accel_values_test),
+    {}
+};
+
+static struct kunit_suite accel_modes_test_suite = {
+    .name = "yeetmouse_modes",
+    .test_cases = accel_modes_test_cases,
+};
+
+// ########## accelerate(), end to end
+
+static void accelerate_sensitivity_test(struct kunit *test)
+{
+    struct accel_state state = {0};
+    int x = 10, y = -4;
+
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=0\nSensitivity=2\n", NULL), 0);
+    KUNIT_EXPECT_EQ(test, accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y), 0);
+    KUNIT_EXPECT_EQ(test, x, 20);
+    KUNIT_EXPECT_EQ(test, y, -8);
+
+    // SensitivityY is the ratio to the X axis
+    KUNIT_ASSERT_EQ(test, profile_set("SensitivityY=0.5\n", NULL), 0);
+    x = 10, y = -4;
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 20);
+    KUNIT_EXPECT_EQ(test, y, -4);
+
+    x = 0, y = 0;
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 0);
+    KUNIT_EXPECT_EQ(test, y, 0);
+}
+
+static void accelerate_rotation_test(struct kunit *test)
+{
+    struct accel_state state = {0};
+    int x = 10, y = 0;
+
+    // 90 degrees clockwise
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=0\nRotationAngle=1.5707963\n", NULL), 0);
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 0);
+    KUNIT_EXPECT_EQ(test, y, 10);
+}
+
+static void accelerate_accelerates_test(struct kunit *test)
+{
+    struct accel_state state = {0};
+    int x = 50, y = 0;
+
+    // Whatever the time since the last report (capped at 100ms), the speed is at least 0.5 counts/ms
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=1\nAcceleration=0.1\nUseSmoothing=0\n", NULL), 0);
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_GE(test, x, 52);
+    KUNIT_EXPECT_EQ(test, y, 0);
+
+    x = -50;
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_LE(test, x, -52);
+}
+
+static void accelerate_slots_test(struct kunit *test)
+{
+    struct accel_state state = {0};
+    int x, y;
+
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=0\n", NULL), 0);
+    KUNIT_ASSERT_EQ(test, profile_set("Slot=2\nSensitivity=3\n", NULL), 0);
+
+    x = 10, y = 0;
+    accelerate(2, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 30);
+
+    x = 10, y = 0;
+    accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 10);
+
+    // Devices bound to an empty slot use the active profile
+    x = 10, y = 0;
+    accelerate(5, &state, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 10);
+}
+
+static void accelerate_per_device_test(struct kunit *test)
+{
+    struct accel_state first = {0}, second = {0};
+    int x, y = 0;
+
+    // Every report moves 0.4 counts, what's left of a count is carried over to the next report of the same device
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=0\nSensitivity=0.4\n", NULL), 0);
+
+    x = 1;
+    accelerate(ACCEL_SLOT_ACTIVE, &first, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 0);
+
+    // Doesn't get the carry of the first device
+    x = 1;
+    accelerate(ACCEL_SLOT_ACTIVE, &second, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 0);
+
+    x = 1;
+    accelerate(ACCEL_SLOT_ACTIVE, &first, &x, &y);
+    KUNIT_EXPECT_EQ(test, x, 1);
+}
+
+static void accel_eval_test(struct kunit *test)
+{
+    FP_LONG speeds[4] = { 0, FP64_1, FP64_10, FP64_100 };
+    FP_LONG out[4];
+    FP_LONG tolerance = FP64_1 >> 16;
+    int i;
+
+    KUNIT_ASSERT_EQ(test, profile_set("AccelerationMode=1\nAcceleration=0.125\nUseSmoothing=0\nSensitivity=2\n",
+                                      NULL), 0);
+    KUNIT_ASSERT_EQ(test, accel_eval(speeds, out, ARRAY_SIZE(speeds)), 0);
+
+    for (i = 1; i < ARRAY_SIZE(speeds); i++)
+        KUNIT_EXPECT_LE(test, FP64_Abs(out[i] - 2 * (FP64_1 + speeds[i] / 8)), tolerance);
+}
+
+static struct kunit_case accel_pipeline_test_cases[] = {
+    KUNIT_CASE(accelerate_sensitivity_test),
+    KUNIT_CASE(accelerate_rotation_test),
+    KUNIT_CASE(accelerate_accelerates_test),
+    KUNIT_CASE(accelerate_slots_test),
+    KUNIT_CASE(accelerate_per_device_test),
+    KUNIT_CASE(accel_eval_test),
+    {}
+};
+
+static struct kunit_suite accel_pipeline_test_suite = {
+    .name = "yeetmouse_pipeline",
+    .init = accel_test_init,
+    .exit = accel_test_exit,
+    .test_cases = accel_pipeline_test_cases,
+};
+
+// ########## Time budget
+
+// Average cost of a report in every mode, both through the self-benchmark (the math alone)
+// and through accelerate() (locking and the clock included)
+static void accel_budget_test(struct kunit *test)
+{
+    const struct mode_case *c = test->param_value;
+    struct accel_bench_result res;
+    struct accel_state state = {0};
+    u64 ops, start, elapsed;
+    int i, x, y;
+
+    KUNIT_ASSERT_EQ(test, profile_set(c->profile, NULL), 0);
+
+    KUNIT_ASSERT_EQ(test, accel_benchmark(TEST_BENCH_PASSES, &res), 0);
+    ops = (u64)res.passes * res.points;
+    KUNIT_EXPECT_LE_MSG(test, div64_u64(res.total_ns, ops), (u64)CONFIG_YEETMOUSE_KUNIT_BUDGET_NS,
+                        "math of a report, on average (max %llu ns)", res.op_max_ns);
+
+    start = ktime_get_ns();
+    for (i = 0; i < TEST_ACCEL_CALLS; i++) {
+        x = (i % 64) - 32;
+        y = (i % 16) - 8;
+        accelerate(ACCEL_SLOT_ACTIVE, &state, &x, &y);
+    }
+    elapsed = ktime_get_ns() - start;
+    KUNIT_EXPECT_LE_MSG(test, div64_u64(elapsed, TEST_ACCEL_CALLS), (u64)CONFIG_YEETMOUSE_KUNIT_BUDGET_NS,
+                        "accelerate(), on average");
+}
+
+static struct kunit_case accel_timing_test_cases[] = {
+    KUNIT_CASE_PARAM(accel_budget_test, modes_gen_params),
+    {}
+};
+
+static struct kunit_suite accel_timing_test_suite = {
+    .name = "yeetmouse_timing",
+    .init = accel_test_init,
+    .exit = accel_test_exit,
+    .test_cases = accel_timing_test_cases,
+};
+
+// ########## Device bindings
+
+static void bindings_before_init_test(struct kunit *test)
+{
+    char *buf = kunit_kzalloc(test, PAGE_SIZE, GFP_KERNEL);
+
+    KUNIT_ASSERT_NOT_NULL(test, buf);
+    // No devices to resolve the bindings for yet, the handler isn't registered
+    KUNIT_ASSERT_EQ(test, bindings_set("046d:c077=1;*:*:usb-*=off\n", NULL), 0);
+    KUNIT_ASSERT_GT(test, bindings_get(buf, NULL), 0);
+    KUNIT_EXPECT_STREQ(test, buf, "046d:c077=1\n*:*:usb-*=off\n");
+
+    KUNIT_EXPECT_EQ(test, bindings_set("046d:c077=8", NULL), -EINVAL);
+    KUNIT_EXPECT_EQ(test, bindings_set("", NULL), 0);
+}
+
+static void bindings_resolve_test(struct kunit *test)
+{
+    struct input_dev mouse = { .phys = "usb-0000:00:14.0-1/input0", .id = { .vendor = 0x046d, .product = 0xc077 } };
+    struct input_dev other = { .phys = "isa0060/serio1/input0", .id = { .vendor = 0x0002, .product = 0x0001 } };
+
+    KUNIT_ASSERT_EQ(test, bindings_set("046d:c077=1\n*:*:usb-*=off\n", NULL), 0);
+    mutex_lock(&g_bindings_lock);
+    KUNIT_EXPECT_EQ(test, binding_resolve(&mouse), 1);
+    KUNIT_EXPECT_EQ(test, binding_resolve(&other), ACCEL_SLOT_ACTIVE);
+    mouse.id.product = 0xc08b;
+    KUNIT_EXPECT_EQ(test, binding_resolve(&mouse), BINDING_PASSTHROUGH);
+    mutex_unlock(&g_bindings_lock);
+
+    KUNIT_EXPECT_EQ(test, bindings_set("", NULL), 0);
+}
+
+static struct kunit_case bindings_test_cases[] = {
+    KUNIT_CASE(bindings_before_init_test),
+    KUNIT_CASE(bindings_resolve_test),
+    {}
+};
+
+static struct kunit_suite bindings_test_suite = {
+    .name = "yeetmouse_bindings",
+    .test_cases = bindings_test_cases,
+};
+
+kunit_test_suites(&accel_params_test_suite, &accel_constants_test_suite, &accel_modes_test_suite,
+                  &accel_pipeline_test_suite, &accel_timing_test_suite, &bindings_test_suite);
+
+MODULE_DESCRIPTION("KUnit tests of the YeetMouse acceleration code");
+MODULE_LICENSE("GPL");
@@ -267,6 +267,12 @@ namespace ConfigHelper {
         if (filepath == nullptr)
             return false;
 
+        bool res = ImportFile(filepath, lut_data, params, true);
+        delete[] filepath;
+        return res;
+    }
+
+    bool ImportFile(const char *filepath, char *lut_data, Parameters &params, bool update_old_format) {
         bool is_config_h = false;
         auto file_name_len = strlen(filepath);
         try {
@@ -288,7 +294,7 @@ namespace ConfigHelper {
             file.close();
 
             // Automatically re-export in the correct format
-            if (is_old_config) {
+            if (is_old_config && update_old_format) {
                 std::ofstream out_file(filepath);
 
                 if (out_file.is_open()) {
@@ -300,10 +306,7 @@ namespace ConfigHelper {
                     out_file.close();
                 }
             }
-
-            delete[] filepath;
         } catch (std::exception &ex) {
-            delete[] filepath;
             printf("Import error: %s\n", ex.what());
             return false;
         }
@@ -311,7 +314,7 @@ namespace ConfigHelper {
         return true;
     }
 
-    bool ImportClipboard(char *lut_data, const char *clipboard, Parameters &params) {
+    bool ImportClipboard(char *lut_data, const char *clipboard, Parameters &params, std::string *updated) {
         if (clipboard == nullptr)
             return false;
 
@@ -326,12 +329,8 @@ namespace ConfigHelper {
                 return false;
 
             // Automatically re-export in the correct format
-            if (is_old_config) {
-                if (is_config_h)
-                    ImGui::SetClipboardText(ExportConfig(params, false).c_str());
-                else
-                    ImGui::SetClipboardText(ExportPlainText(params, false).c_str());
-            }
+            if (is_old_config && updated)
+                *updated = is_config_h ? ExportConfig(params, false) : ExportPlainText(params, false);
         } catch (std::exception &ex) {
             printf("Import error: %s\n", ex.what());
             return false;
@@ -8,9 +8,15 @@ namespace ConfigHelper {
 
     std::string ExportConfig(Parameters params, bool save_to_file);
 
+    /// Asks for the file to import (zenity)
     bool ImportFile(char *lut_data, Parameters &params);
 
-    bool ImportClipboard(char *lut_data, const char *clipboard, Parameters &params);
+    /// Imports a plain text or config.h (.h) file. Files in an old format get rewritten in the current one, if
+    /// update_old_format is set.
+    bool ImportFile(const char *filepath, char *lut_data, Parameters &params, bool update_old_format);
+
+    /// updated (optional) gets the config in the current format, if the clipboard had it in an old one
+    bool ImportClipboard(char *lut_data, const char *clipboard, Parameters &params, std::string *updated = nullptr);
 } // ConfigHelper
 
 #endif //GUI_CONFIGHELPER_H
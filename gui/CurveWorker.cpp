@@ -0,0 +1,211 @@
+#include "CurveWorker.h"
+
+#include <algorithm>
+#include <cmath>
+
+float CurveWorker::Tile::Min() const {
+    // Negative speeds are all the same speed (see EvaluateFuncWithGlobalParameters())
+    return std::max(0.f, static_cast<float>(std::ldexp(static_cast<double>(index), level)));
+}
+
+float CurveWorker::Tile::Max() const {
+    return static_cast<float>(std::ldexp(static_cast<double>(index + 2), level));
+}
+
+CurveWorker::CurveWorker(CachedFunction *functions, size_t count) : functions(functions), slots(count) {
+    for (auto &slot: slots)
+        slot.work.params = &slot.work_params;
+
+    worker = std::thread(&CurveWorker::WorkerLoop, this);
+}
+
+CurveWorker::~CurveWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void CurveWorker::MarkDirty(int index, float x_stride) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Slot &slot = slots[index];
+        slot.params = *functions[index].params;
+        if (x_stride > 0)
+            slot.x_stride = x_stride;
+        else if (slot.x_stride <= 0)
+            slot.x_stride = functions[index].x_stride;
+        slot.requested++;
+    }
+    wake.notify_one();
+}
+
+void CurveWorker::SetPriority(std::initializer_list<int> order) {
+    std::lock_guard<std::mutex> lock(mutex);
+    priority.clear();
+    for (int index: order) {
+        if (index >= 0 && index < static_cast<int>(slots.size()))
+            priority.push_back(index);
+    }
+}
+
+void CurveWorker::SetPlotRange(double x_min, double x_max) {
+    Tile new_tile;
+    new_tile.level = static_cast<int>(std::ceil(std::log2(std::max(x_max - x_min, 1e-3))));
+    new_tile.index = static_cast<long long>(std::floor(std::ldexp(x_min, -new_tile.level)));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (has_tile && tile == new_tile)
+            return;
+        tile = new_tile;
+        has_tile = true;
+    }
+    wake.notify_one();
+}
+
+int CurveWorker::Publish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    int published = 0;
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        Slot &slot = slots[i];
+        CachedFunction &function = functions[i];
+
+        if (slot.has_result) {
+            // The function keeps pointing to the live parameters, and its samples are handled below
+            Parameters *params = function.params;
+            PlotSamples samples = std::move(function.samples);
+            function = slot.result;
+            function.params = params;
+            function.samples = std::move(samples);
+            slot.has_result = false;
+            published++;
+        }
+
+        if (!has_tile || (slot.published_tile == tile && slot.published_version == slot.version))
+            continue;
+
+        bool found = false;
+        for (const auto &cached: slot.tiles) {
+            if (cached.tile == tile && cached.version == slot.version) {
+                function.samples = cached.samples;
+                slot.published_tile = tile;
+                slot.published_version = slot.version;
+                found = true;
+                break;
+            }
+        }
+
+        // Samples of an older function would show the old curve, the uniform values are closer
+        if (!found && slot.published_version != slot.version)
+            function.samples = PlotSamples{};
+    }
+
+    return published;
+}
+
+bool CurveWorker::IsPending(int index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots[index].done != slots[index].requested;
+}
+
+void CurveWorker::Finish(int index) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this, index] { return slots[index].done == slots[index].requested; });
+    }
+    Publish();
+}
+
+void CurveWorker::SetNotify(void (*callback)()) {
+    std::lock_guard<std::mutex> lock(mutex);
+    notify = callback;
+}
+
+bool CurveWorker::HasTile(const Slot &slot) const {
+    for (const auto &cached: slot.tiles) {
+        if (cached.tile == tile && cached.version == slot.version)
+            return true;
+    }
+    return false;
+}
+
+CurveWorker::Job CurveWorker::NextJob() const {
+    auto job_for = [this](int index) {
+        const Slot &slot = slots[index];
+        if (slot.running)
+            return Job{};
+        if (slot.done != slot.requested)
+            return Job{index, true};
+        // Only functions that were computed at least once can be sampled
+        if (has_tile && slot.version > 0 && !HasTile(slot))
+            return Job{index, false};
+        return Job{};
+    };
+
+    for (int index: priority) {
+        if (Job job = job_for(index); job.index >= 0)
+            return job;
+    }
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (Job job = job_for(static_cast<int>(i)); job.index >= 0)
+            return job;
+    }
+    return Job{};
+}
+
+void CurveWorker::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        Job job;
+        wake.wait(lock, [this, &job] { return stopping || (job = NextJob()).index >= 0; });
+        if (stopping)
+            return;
+
+        Slot &slot = slots[job.index];
+        const unsigned long long generation = slot.requested;
+        const Tile sampled_tile = tile;
+        const bool sample = has_tile;
+        if (job.recompute) {
+            slot.work_params = slot.params;
+            slot.work.x_stride = slot.x_stride;
+        }
+        slot.running = true;
+
+        lock.unlock();
+        if (job.recompute)
+            slot.work.PreCacheFunc();
+        TileSamples samples{sampled_tile, 0, {}};
+        if (sample)
+            slot.work.SampleAdaptive(sampled_tile.Min(), sampled_tile.Max(), samples.samples);
+        lock.lock();
+
+        if (job.recompute) {
+            // Even if it's outdated already, it's closer than what's plotted now; the newer parameters get their own
+            // job
+            slot.result = slot.work;
+            slot.has_result = true;
+            slot.done = generation;
+            slot.version++;
+            slot.tiles.clear();
+        }
+        if (sample) {
+            samples.version = slot.version;
+            slot.tiles.push_front(std::move(samples));
+            if (slot.tiles.size() > PLOT_TILE_CACHE)
+                slot.tiles.pop_back();
+        }
+        slot.running = false;
+        finished.notify_all();
+
+        if (void (*callback)() = notify) {
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef GUI_CURVEWORKER_H
+#define GUI_CURVEWORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "FunctionHelper.h"
+
+#define PLOT_TILE_CACHE 8 // Sampled ranges kept per function
+
+///
+/// Recomputes the cached functions (PreCacheFunc()) on a background thread, so that dragging a slider never stalls a
+/// frame. Only the functions marked dirty get recomputed, the prioritized ones (the visible and the active modes) first.
+/// Every job works on a snapshot of the parameters taken when the function was marked dirty; the results stay in the
+/// worker until Publish() copies them into the functions (values, values_y, isValid and the constants), on the render
+/// thread, so the plotted values are never written to from the background.
+///
+/// The worker also samples the functions adaptively (CachedFunction::SampleAdaptive()) for the plotted range, see
+/// SetPlotRange(). The samples are published into CachedFunction::samples the same way.
+///
+class CurveWorker {
+public:
+    CurveWorker(CachedFunction *functions, size_t count);
+    ~CurveWorker();
+    CurveWorker(const CurveWorker &) = delete;
+    CurveWorker &operator=(const CurveWorker &) = delete;
+
+    /// The function's parameters changed. x_stride > 0 changes its stride too (it's published along with the values)
+    void MarkDirty(int index, float x_stride = 0);
+
+    /// Functions to recompute first, in order. Negative indices are ignored.
+    void SetPriority(std::initializer_list<int> order);
+
+    /// The visible range of the plot. The functions get sampled over a tile around it: the span rounded up to a power
+    /// of 2, and twice as wide, so that panning within it or zooming a little doesn't resample. The last few tiles of
+    /// every function are kept, going back to one of them doesn't resample either.
+    void SetPlotRange(double x_min, double x_max);
+
+    /// Copies the finished results into the functions, returns how many were updated. Render thread only.
+    int Publish();
+
+    /// Still waiting to be (or being) recomputed
+    bool IsPending(int index);
+
+    /// Waits for the function to be up to date and publishes the results (e.g. before applying its parameters)
+    void Finish(int index);
+
+    /// Called from the worker after every finished job (e.g. to wake up the render loop), nullptr for none
+    void SetNotify(void (*callback)());
+
+private:
+    struct Tile {
+        int level = 0; // Width is 2^level
+        long long index = 0;
+
+        bool operator==(const Tile &other) const { return level == other.level && index == other.index; }
+        float Min() const;
+        float Max() const;
+    };
+
+    struct TileSamples {
+        Tile tile;
+        unsigned long long version; // Of the function it was sampled from
+        PlotSamples samples;
+    };
+
+    struct Slot {
+        // Render thread side, guarded by the mutex
+        Parameters params; // Snapshot of the latest parameters
+        float x_stride = 0;
+        unsigned long long requested = 0; // Generations
+        unsigned long long done = 0;
+        bool running = false;
+        CachedFunction result;
+        bool has_result = false;
+
+        unsigned long long version = 0; // Of the function computed last, bumped on every job
+        std::deque<TileSamples> tiles; // Most recent first
+        Tile published_tile; // What's in CachedFunction::samples
+        unsigned long long published_version = 0;
+
+        // Worker side, keeps the constants between the jobs (see SynchronousBuildLUT())
+        Parameters work_params;
+        CachedFunction work;
+    };
+
+    struct Job {
+        int index = -1;
+        bool recompute = false; // Otherwise just a tile to sample
+    };
+
+    void WorkerLoop();
+
+    /// Highest priority function that needs a recompute (or samples), index -1 if there's none
+    Job NextJob() const;
+
+    bool HasTile(const Slot &slot) const;
+
+    CachedFunction *functions;
+    std::vector<Slot> slots;
+    std::vector<int> priority;
+    Tile tile;
+    bool has_tile = false;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping = false;
+    void (*notify)() = nullptr;
+    std::thread worker;
+};
+
+#endif //GUI_CURVEWORKER_H
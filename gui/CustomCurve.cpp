@@ -1,6 +1,7 @@
 #include "CustomCurve.h"
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "DriverHelper.h"
@@ -24,6 +25,16 @@ void CustomCurve::ApplyCurveConstraints() {
     }
 }
 
+// Cubic Bezier point, the same as ImGui's ImBezierCubicCalc() (which would need ImGui linked in, see ctl.cpp)
+ImVec2 BezierCubicCalc(ImVec2 p0, ImVec2 p1, ImVec2 p2, ImVec2 p3, float t) {
+    float u = 1.0f - t;
+    float w1 = u * u * u;
+    float w2 = 3 * u * u * t;
+    float w3 = 3 * u * t * t;
+    float w4 = t * t * t;
+    return {w1 * p0.x + w2 * p1.x + w3 * p2.x + w4 * p3.x, w1 * p0.y + w2 * p1.y + w3 * p2.y + w4 * p3.y};
+}
+
 // Cubic Bezier derivatives
 ImVec2 BezierFirstOrderDerivative(ImVec2 p0, ImVec2 p1, ImVec2 p2, ImVec2 p3, float t) {
     float u = (1 - t);
@@ -40,11 +51,73 @@ ImVec2 BezierSecondOrderDerivative(ImVec2 p0, ImVec2 p1, ImVec2 p2, ImVec2 p3, f
     return (p2 - p1 * 2 + p0) * w1 + (p3 - p2 * 2 + p1) * w2;
 }
 
+// Points of the cubic Bezier at t = 0, 1 / (count - 1), ..., 1, by forward differencing: the polynomial's differences
+// over the step are updated with 3 additions per point, instead of evaluating it every time
+template<typename Point>
+static void TessellateBezier(const std::array<ImVec2, 4> &segment, int count, Point *out) {
+    const double h = 1.0 / (count - 1);
+    double d[2][4]; // Value, 1st, 2nd and 3rd difference; for x and y
+    for (int axis = 0; axis < 2; axis++) {
+        double p0 = segment[0][axis], p1 = segment[1][axis], p2 = segment[2][axis], p3 = segment[3][axis];
+        // p(t) = a t^3 + b t^2 + c t + p0
+        double a = -p0 + 3 * p1 - 3 * p2 + p3, b = 3 * p0 - 6 * p1 + 3 * p2, c = 3 * (p1 - p0);
+        d[axis][0] = p0;
+        d[axis][1] = a * h * h * h + b * h * h + c * h;
+        d[axis][2] = 6 * a * h * h * h + 2 * b * h * h;
+        d[axis][3] = 6 * a * h * h * h;
+    }
+
+    for (int j = 0; j < count - 1; j++) {
+        out[j] = Point(d[0][0], d[1][0]);
+        for (auto &axis: d) {
+            axis[0] += axis[1];
+            axis[1] += axis[2];
+            axis[2] += axis[3];
+        }
+    }
+    // No rounding drift at the end point, the next segment starts there
+    out[count - 1] = Point(segment[3].x, segment[3].y);
+}
+
+CustomCurve::Segment CustomCurve::GetSegment(size_t i) const {
+    return {points[i], control_points[i][0], control_points[i][1], points[i + 1]};
+}
+
+const CustomCurve::ArcLengths &CustomCurve::SegmentArcLengths(size_t i) const {
+    const Segment segment = GetSegment(i);
+    if (arc_lengths.size() != points.size() - 1)
+        arc_lengths.resize(points.size() - 1);
+
+    ArcLengths &table = arc_lengths[i];
+    if (table.length > 0 && table.segment == segment)
+        return table;
+
+    std::array<ImVec2, LUT_ARC_LENGTH_SAMPLES> samples;
+    TessellateBezier(segment, LUT_ARC_LENGTH_SAMPLES, samples.data());
+
+    table.segment = segment;
+    table.length = 0;
+    table.cumulative[0] = 0;
+    for (int j = 1; j < LUT_ARC_LENGTH_SAMPLES; j++) {
+        ImVec2 dist = samples[j] - samples[j - 1];
+        dist.y *= 30; // The graph is stretched horizontally, this accounts for that
+        table.length += std::sqrt(ImLengthSqr(dist));
+        table.cumulative[j] = table.length;
+    }
+    return table;
+}
+
+int CustomCurve::ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const {
+    if (LUT_placement == LUTPlacement_MinError)
+        return ExportCurveToLUTMinError(LUT_data_x, LUT_data_y);
+    return ExportCurveToLUTAdaptive(LUT_data_x, LUT_data_y);
+}
+
 // Spreads points based on the rate of change and other things
 // Sorry for the shear number of magic numbers in this function, there is just a lot to configure
-int CustomCurve::ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const {
+int CustomCurve::ExportCurveToLUTAdaptive(double *LUT_data_x, double *LUT_data_y) const {
     const float TIME_ADAPTIVE_FACTOR = 0.5;
-    const int PRE_LUT_ARRAY_SIZE = 100;
+    const int PRE_LUT_ARRAY_SIZE = LUT_ARC_LENGTH_SAMPLES;
     const float LENGTH_WEIGHT = 0.95;
     int LUT_size = 0;
 
@@ -54,24 +127,13 @@ int CustomCurve::ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const
     LUT_size = 0;
 
     std::vector<float> curve_arc_len((points.size() - 1) * PRE_LUT_ARRAY_SIZE);
-    size_t idx = 0;
     std::vector<double> seg_len(points.size() - 1); // normalized
     double len_sum = 0;
-    // Pre calculate each segments' length
-    auto last_p = points[0];
+    // Each segments' length, only the changed segments get measured again
     for (int i = 0; i < points.size() - 1; i++) {
-        seg_len[i] = 0;
-        curve_arc_len[idx++] = 0;
-        for (int j = 1; j < PRE_LUT_ARRAY_SIZE; j++) {
-            const double t = j / (PRE_LUT_ARRAY_SIZE - 1.0);
-            ImVec2 p = ImBezierCubicCalc(points[i], control_points[i][0], control_points[i][1], points[i + 1], t);
-            ImVec2 dist = p - last_p;
-            dist.y *= 30; // The graph is stretched horizontally, this accounts for that
-            curve_arc_len[idx] = curve_arc_len[idx - 1] + std::sqrt(ImLengthSqr(dist));
-            seg_len[i] += std::sqrt(ImLengthSqr(dist));
-            last_p = p;
-            idx++;
-        }
+        const ArcLengths &table = SegmentArcLengths(i);
+        std::copy(table.cumulative.begin(), table.cumulative.end(), curve_arc_len.begin() + i * PRE_LUT_ARRAY_SIZE);
+        seg_len[i] = table.length;
         len_sum += seg_len[i];
     }
 
@@ -125,7 +187,7 @@ int CustomCurve::ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const
         int start = edge_idx * PRE_LUT_ARRAY_SIZE;
         t = linear_map_t(tg_arc_len, start);
 
-        auto p = ImBezierCubicCalc(points[edge_idx], control_points[edge_idx][0], control_points[edge_idx][1],
+        auto p = BezierCubicCalc(points[edge_idx], control_points[edge_idx][0], control_points[edge_idx][1],
                                    points[edge_idx + 1], t);
         auto dp = BezierFirstOrderDerivative(points[edge_idx], control_points[edge_idx][0], control_points[edge_idx][1],
                                              points[edge_idx + 1], t);
@@ -177,6 +239,157 @@ int CustomCurve::ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const
     return LUT_size;
 }
 
+void CustomCurve::SampleDense(std::vector<double> &xs, std::vector<double> &ys) const {
+    xs.clear();
+    ys.clear();
+    if (points.size() <= 1)
+        return;
+
+    xs.reserve((points.size() - 1) * LUT_ERROR_SAMPLES + 1);
+    ys.reserve((points.size() - 1) * LUT_ERROR_SAMPLES + 1);
+    xs.push_back(points[0].x);
+    ys.push_back(points[0].y);
+    for (size_t i = 0; i < points.size() - 1; i++) {
+        for (int j = 1; j <= LUT_ERROR_SAMPLES; j++) {
+            float t = (float) j / LUT_ERROR_SAMPLES;
+            ImVec2 p = BezierCubicCalc(points[i], control_points[i][0], control_points[i][1], points[i + 1], t);
+            // A curve that bends back isn't a function, the LUT can't follow it anyway
+            xs.push_back(std::max((double) p.x, xs.back()));
+            ys.push_back(p.y);
+        }
+    }
+}
+
+double CustomCurve::LUTError(const double *LUT_data_x, const double *LUT_data_y, int LUT_size) const {
+    std::vector<double> xs, ys;
+    SampleDense(xs, ys);
+    if (xs.empty() || LUT_size < 2)
+        return INFINITY;
+
+    double error = 0;
+    for (size_t k = 0; k < xs.size(); k++) {
+        double y;
+        // Same as accel_lut(): the first point's value before it, the last segment extended past the end
+        if (xs[k] <= LUT_data_x[0])
+            y = LUT_data_y[0];
+        else {
+            int index = (int) (std::lower_bound(LUT_data_x, LUT_data_x + LUT_size, xs[k]) - LUT_data_x) - 1;
+            index = std::min(index, LUT_size - 2);
+            double frac = (xs[k] - LUT_data_x[index]) / (LUT_data_x[index + 1] - LUT_data_x[index]);
+            y = LUT_data_y[index] + (LUT_data_y[index + 1] - LUT_data_y[index]) * frac;
+        }
+        error = std::max(error, std::fabs(y - ys[k]));
+    }
+
+    return error;
+}
+
+// Covers the dense samples of the curve with as few chords as the error (max distance in y) allows, the LUT points
+// being some of the samples. Goes from the end, every chord as long as it can be, so the last segment (the one the
+// driver extends past the curve) is never a short one.
+// For a chord ending at sample b, every sample k in between bounds its slope to an interval (the chord has to pass
+// within the error of it), a chord to sample a works if its slope is in all the intervals of the samples past a. So the
+// longest chord is found in a single pass, the intersection of the intervals only narrows.
+static int CoverWithChords(const std::vector<double> &xs, const std::vector<double> &ys, double max_error,
+                           int max_points, int *out_indices) {
+    int count = 0;
+    int b = (int) xs.size() - 1;
+    out_indices[count++] = b;
+
+    while (b > 0) {
+        if (count == max_points)
+            return max_points + 1; // Doesn't fit
+
+        double slope_min = -INFINITY, slope_max = INFINITY;
+        int best = -1, closest = -1;
+        for (int a = b - 1; a >= 0; a--) {
+            double dx = xs[b] - xs[a];
+            // The first point is the start of the curve, nothing can be too close to it either
+            if (dx >= LUT_MIN_POINT_DIST && (a == 0 || xs[a] - xs[0] >= LUT_MIN_POINT_DIST)) {
+                double slope = (ys[b] - ys[a]) / dx;
+                if (slope >= slope_min && slope <= slope_max)
+                    best = a;
+                if (closest < 0)
+                    closest = a;
+            }
+
+            // Sample a is between the ends of all the longer chords
+            bool feasible = true;
+            if (dx > 0) {
+                slope_min = std::max(slope_min, (ys[b] - ys[a] - max_error) / dx);
+                slope_max = std::min(slope_max, (ys[b] - ys[a] + max_error) / dx);
+                feasible = slope_min <= slope_max;
+            } else
+                feasible = std::fabs(ys[b] - ys[a]) <= max_error;
+            // No longer chord can work, but the points still have to be apart
+            if (!feasible) {
+                slope_min = INFINITY;
+                if (closest >= 0)
+                    break;
+            }
+        }
+
+        // Too steep for the error, the shortest chord that keeps the points apart (a curve that's too short for that
+        // is just its ends)
+        if (best < 0)
+            best = closest >= 0 ? closest : 0;
+        out_indices[count++] = best;
+        b = best;
+    }
+
+    return count;
+}
+
+// Bisects the lowest error the points allow, then takes as few points as that error (or the target error) needs
+int CustomCurve::ExportCurveToLUTMinError(double *LUT_data_x, double *LUT_data_y) const {
+    const int MAX_ITERATIONS = 60;
+    std::vector<double> xs, ys;
+    SampleDense(xs, ys);
+    if (xs.size() < 2)
+        return 0;
+
+    int indices[MAX_LUT_ARRAY_SIZE];
+    int best_indices[MAX_LUT_ARRAY_SIZE];
+    int best_count = 0;
+
+    auto fit = [&](double max_error) {
+        int count = CoverWithChords(xs, ys, max_error, MAX_LUT_ARRAY_SIZE, indices);
+        if (count > MAX_LUT_ARRAY_SIZE)
+            return false;
+        std::copy(indices, indices + count, best_indices);
+        best_count = count;
+        return true;
+    };
+
+    // Lower errors would only take more points for what gets rounded off
+    auto [y_min, y_max] = std::minmax_element(ys.begin(), ys.end());
+    const double resolution = LUT_ERROR_RESOLUTION * std::max(std::fabs(*y_min), std::fabs(*y_max));
+
+    if (!fit(std::max((double) LUT_target_error, resolution))) {
+        // A single chord over the whole curve is within its y range of it
+        double hi = *y_max - *y_min + resolution;
+        double lo = resolution;
+        fit(hi);
+        for (int i = 0; i < MAX_ITERATIONS && hi - lo > 1e-3 * resolution; i++) {
+            double mid = (lo + hi) / 2;
+            if (fit(mid))
+                hi = mid;
+            else
+                lo = mid;
+        }
+        // The last successful fit is the one for hi
+        fit(hi);
+    }
+
+    // The chords were found from the end
+    for (int i = 0; i < best_count; i++) {
+        LUT_data_x[i] = xs[best_indices[best_count - 1 - i]];
+        LUT_data_y[i] = ys[best_indices[best_count - 1 - i]];
+    }
+
+    return best_count;
+}
+
 // ctrl_p -> control_point
 // Format: point[i].x;point[i].y;ctrl_p[i][0].x,ctrl_p[i][0].y;ctrl_p[i][1].x;ctrl_p[i][1].y;point[i+1].x;point[i+1].y;ctrl_p[i][0].x;ctrl_p[i][0].y;ctrl_p[i][1].x;ctrl_p[i][1].y;point[i+1].x.y;...point[n-1].x;point[n-1];
 std::string CustomCurve::ExportCustomCurve() const {
@@ -337,20 +550,26 @@ void CustomCurve::SmoothBezier() {
     delete[] tmp;
 }
 
-void CustomCurve::UpdateLUT() {
+int CustomCurve::UpdateLUT() {
     if (points.size() < 2)
-        return;
-    LUT_points.resize((points.size() - 1) * BEZIER_FRAG_SEGMENTS);
-    ImVec2 last_point = points[0];
-    for (int i = 0; i < points.size() - 1; i++) {
-        for (int j = 0; j < BEZIER_FRAG_SEGMENTS; ++j) {
-            float t = (float) j / (BEZIER_FRAG_SEGMENTS - 1);
-            ImVec2 p = ImBezierCubicCalc(points[i], control_points[i][0], control_points[i][1], points[i + 1], t);
-            LUT_points[i * BEZIER_FRAG_SEGMENTS + j] = p;
-            if (last_point.x > p.x) {
-                // Bad Curve
-            }
-            last_point = p;
-        }
+        return 0;
+
+    const size_t segments = points.size() - 1;
+    // A point added or removed shifts the segments, all of them get tessellated again
+    bool all = LUT_segments.size() != segments || LUT_points.size() != segments * BEZIER_FRAG_SEGMENTS;
+    LUT_points.resize(segments * BEZIER_FRAG_SEGMENTS);
+    LUT_segments.resize(segments);
+
+    int updated = 0;
+    for (size_t i = 0; i < segments; i++) {
+        Segment segment = GetSegment(i);
+        if (!all && LUT_segments[i] == segment)
+            continue;
+
+        TessellateBezier(segment, BEZIER_FRAG_SEGMENTS, &LUT_points[i * BEZIER_FRAG_SEGMENTS]);
+        LUT_segments[i] = segment;
+        updated++;
     }
+
+    return updated;
 }
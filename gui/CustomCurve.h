@@ -11,7 +11,16 @@
 
 #define CURVE_POINTS_MARGIN 0.2f
 #define BEZIER_FRAG_SEGMENTS 50
+#define LUT_ARC_LENGTH_SAMPLES 100 // Per Bezier segment, for the arc length tables of the adaptive LUT export
 #define CURVE_EXPORT_PRECISION 3 // Decimal points precision for exporting Custom Curves
+#define LUT_ERROR_SAMPLES 256 // Per Bezier segment, the curve an exported LUT gets measured against
+#define LUT_MIN_POINT_DIST 0.02 // Closest the LUT points get (in x), so that they stay apart when exported
+#define LUT_ERROR_RESOLUTION 5e-5 // Relative, what the export rounds off anyway (see LUT_EXPORT_PRECISION)
+
+enum LUTPlacement {
+    LUTPlacement_Adaptive, // Spreads the points by the curvature and the length of the segments
+    LUTPlacement_MinError, // Minimizes the max error of the driver's linear interpolation
+};
 
 struct Ex_Vec2 : ImVec2 {
     bool is_locked = false;
@@ -27,14 +36,22 @@ public:
     std::deque<std::array<ImVec2, 2> > control_points{std::array<ImVec2, 2>({ImVec2{40, 1}, ImVec2{20, 2}})};
     std::vector<ImPlotPoint> LUT_points{};
 
+    // How ExportCurveToLUT() places the points (not exported with the curve)
+    LUTPlacement LUT_placement = LUTPlacement_Adaptive;
+    // LUTPlacement_MinError only: uses fewer points if they're enough to get the error below this, 0 - uses all of them
+    float LUT_target_error = 0;
+
     CustomCurve() = default;
 
     // Constraints the curve to be aligned with the "mathematical" definition of a function x -> f(x)
     void ApplyCurveConstraints();
 
-    // Tries to optimally distribute the points for the exported LUT
+    // Tries to optimally distribute the points for the exported LUT (see LUT_placement)
     int ExportCurveToLUT(double *LUT_data_x, double *LUT_data_y) const;
 
+    // Max difference (in y) between the curve and the driver's linear interpolation of the LUT, see accel_lut()
+    double LUTError(const double *LUT_data_x, const double *LUT_data_y, int LUT_size) const;
+
     // Exports the custom curve points raw (not as a LUT)
     std::string ExportCustomCurve() const;
 
@@ -44,8 +61,34 @@ public:
     // Makes first and second derivative continuous
     void SmoothBezier();
 
-    // Builds a LUT for a fast curve plotting (stored in LUT_points), no "fancy" algorithms here
-    void UpdateLUT();
+    // Builds a LUT for a fast curve plotting (stored in LUT_points), no "fancy" algorithms here. Only the segments that
+    // changed since the last call get tessellated again (e.g. the one or two around a dragged point), returns how many.
+    int UpdateLUT();
+
+private:
+    using Segment = std::array<ImVec2, 4>; // Start, the 2 control points, end
+
+    struct ArcLengths {
+        Segment segment; // The table is of this one
+        float length = 0;
+        std::array<float, LUT_ARC_LENGTH_SAMPLES> cumulative;
+    };
+
+    // What every segment of LUT_points was tessellated from
+    std::vector<Segment> LUT_segments;
+    // Cache of the adaptive export's arc length tables, the ones of the segments that didn't change are reused
+    mutable std::vector<ArcLengths> arc_lengths;
+
+    Segment GetSegment(size_t i) const;
+
+    const ArcLengths &SegmentArcLengths(size_t i) const;
+
+    int ExportCurveToLUTAdaptive(double *LUT_data_x, double *LUT_data_y) const;
+
+    int ExportCurveToLUTMinError(double *LUT_data_x, double *LUT_data_y) const;
+
+    // LUT_ERROR_SAMPLES points of every segment, x never decreasing
+    void SampleDense(std::vector<double> &xs, std::vector<double> &ys) const;
 };
 
 
@@ -1,73 +1,273 @@
 #include "DriverHelper.h"
-#include "External/FixedMath/Fixed64.h"
+#include "../driver/FixedMath/Fixed64.h"
+#include "yeetaccel.h"
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <cstring>
+#include <cerrno>
 #include <sstream>
 #include <algorithm>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
 #include <set>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <string_view>
+#include <charconv>
+#include <unordered_map>
 
 #include "External/ImGui/imgui_internal.h"
 #include "External/ImGui/implot.h"
 
 #define YEETMOUSE_PARAMS_DIR "/sys/module/yeetmouse/parameters/"
+#define YEETMOUSE_DEBUGFS_DIR "/sys/kernel/debug/yeetmouse/"
+#define DRIVER_EVAL_MAX_POINTS 4096 // THIS NEEDS TO BE THE SAME AS IN THE DRIVER CODE
+
+namespace {
+    // The parameter files stay open: sysfs regenerates the contents on every read from offset 0, and takes every
+    // write as a whole value, so there's no need to reopen them (or seek) between the accesses.
+    class ParameterFiles {
+    public:
+        ~ParameterFiles() {
+            for (auto &[name, file]: files)
+                close(file.fd);
+        }
 
-template<typename Ty>
-bool GetParameterTy(const std::string &param_name, Ty &value) {
-    try {
-        using namespace std;
-        ifstream file(YEETMOUSE_PARAMS_DIR + param_name);
+        /// Descriptor of the parameter's file, -1 (with errno set) if it can't be opened
+        int Get(const std::string &param_name, bool for_writing) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = files.find(param_name);
+            if (it != files.end() && (it->second.writable || !for_writing))
+                return it->second.fd;
+
+            // Read only without root, or for the read only parameters
+            const std::string path = YEETMOUSE_PARAMS_DIR + param_name;
+            File file{open(path.c_str(), O_RDWR | O_CLOEXEC), true};
+            if (file.fd < 0 && (errno == EACCES || errno == EPERM) && !for_writing)
+                file = {open(path.c_str(), O_RDONLY | O_CLOEXEC), false};
+            if (file.fd < 0)
+                return -1;
+
+            if (it != files.end()) {
+                close(it->second.fd);
+                it->second = file;
+            } else
+                files.emplace(param_name, file);
+            return file.fd;
+        }
+
+    private:
+        struct File {
+            int fd;
+            bool writable;
+        };
 
-        if (file.bad())
+        std::mutex mutex;
+        std::unordered_map<std::string, File> files;
+    };
+
+    ParameterFiles parameter_files;
+
+    // Reads the whole parameter into a buffer reused between the reads (per thread)
+    bool ReadParameter(const std::string &param_name, std::string_view &value) {
+        thread_local std::vector<char> buffer(MAX_LUT_BUF_LEN);
+
+        int fd = parameter_files.Get(param_name, false);
+        if (fd < 0)
             return false;
 
-        file >> value;
-        file.close();
+        size_t size = 0;
+        while (true) {
+            ssize_t read = pread(fd, buffer.data() + size, buffer.size() - size, static_cast<off_t>(size));
+            if (read < 0) {
+                if (errno == EINTR)
+                    continue;
+                fprintf(stderr, "Error when reading parameter %s (%s)\n", param_name.c_str(), strerror(errno));
+                return false;
+            }
+            if (read == 0)
+                break;
+            size += read;
+            if (size == buffer.size())
+                buffer.resize(buffer.size() * 2);
+        }
+
+        value = std::string_view(buffer.data(), size);
         return true;
-    } catch (std::exception &ex) {
-        fprintf(stderr, "Error when reading parameter %s (%s)\n", param_name.c_str(), ex.what());
-        return false;
     }
+
+    // Writes the whole value at once, returns 0 or the errno it failed with
+    int WriteParameter(const std::string &param_name, std::string_view value) {
+        int fd = parameter_files.Get(param_name, true);
+        if (fd < 0)
+            return errno;
+
+        ssize_t written;
+        do {
+            written = pwrite(fd, value.data(), value.size(), 0);
+        } while (written < 0 && errno == EINTR);
+
+        if (written < 0)
+            return errno;
+        return static_cast<size_t>(written) == value.size() ? 0 : EIO;
+    }
+
+    // Writes the queued batches in order, on its own thread so that applying the parameters never stalls a frame
+    class ParameterWriter {
+    public:
+        ~ParameterWriter() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            if (worker.joinable())
+                worker.join();
+        }
+
+        void Queue(std::vector<DriverHelper::ParameterWrite> writes) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!worker.joinable())
+                    worker = std::thread(&ParameterWriter::WorkerLoop, this);
+                queue.push_back(std::move(writes));
+            }
+            wake.notify_one();
+        }
+
+        bool TakeResults(std::vector<DriverHelper::ParameterWrite> &results) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (done.empty())
+                return false;
+            results = std::move(done);
+            done.clear();
+            return true;
+        }
+
+        void Flush() {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return queue.empty() && !writing; });
+        }
+
+        void SetNotify(void (*callback)()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            notify = callback;
+        }
+
+    private:
+        void WorkerLoop() {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (true) {
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                // Whatever is queued still gets written
+                if (queue.empty())
+                    return;
+
+                std::vector<DriverHelper::ParameterWrite> writes = std::move(queue.front());
+                queue.pop_front();
+                writing = true;
+
+                lock.unlock();
+                DriverHelper::WriteParameters(writes);
+                lock.lock();
+
+                done.insert(done.end(), std::make_move_iterator(writes.begin()), std::make_move_iterator(writes.end()));
+                writing = false;
+                finished.notify_all();
+
+                if (void (*callback)() = notify) {
+                    lock.unlock();
+                    callback();
+                    lock.lock();
+                }
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        std::deque<std::vector<DriverHelper::ParameterWrite>> queue;
+        std::vector<DriverHelper::ParameterWrite> done;
+        bool writing = false;
+        bool stopping = false;
+        void (*notify)() = nullptr;
+        std::thread worker;
+    };
+
+    ParameterWriter parameter_writer;
 }
 
-bool GetParameterTy(const std::string &param_name, std::string &value) {
-    try {
-        using namespace std;
-        ifstream file(YEETMOUSE_PARAMS_DIR + param_name);
+static std::string_view Trim(std::string_view text) {
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.front())))
+        text.remove_prefix(1);
+    while (!text.empty() && isspace(static_cast<unsigned char>(text.back())))
+        text.remove_suffix(1);
+    return text;
+}
 
-        if (file.bad() || file.fail())
-            return false;
+template<typename Ty>
+static bool FromChars(std::string_view text, Ty &value) {
+    // from_chars() doesn't take the plus sign
+    if (!text.empty() && text.front() == '+')
+        text.remove_prefix(1);
+    return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+}
 
-        std::stringstream ss;
-        ss << file.rdbuf();
-        value = ss.str();
-        file.close();
-        return true;
-    } catch (std::exception &ex) {
-        fprintf(stderr, "Error when reading parameter %s (%s)\n", param_name.c_str(), ex.what());
+// Numbers as the driver prints them, and the raw FP64 forms its parameters can hold before the first update:
+// "(N ll << 32)" is the integer N, "N ll" (or "(N ll)") is N in fixed point (see CleanParameters())
+template<typename Ty>
+static bool ParseNumber(std::string_view text, Ty &value) {
+    text = Trim(text);
+
+    size_t ll_pos = text.find("ll");
+    if (ll_pos == std::string_view::npos)
+        return FromChars(text, value);
+
+    size_t bracket_pos = text.find('(');
+    size_t start = bracket_pos == std::string_view::npos || bracket_pos > ll_pos ? 0 : bracket_pos + 1;
+    long long raw = 0;
+    if (!FromChars(Trim(text.substr(start, ll_pos - start)), raw))
         return false;
-    }
+
+    if (text.find("<< 32") != std::string_view::npos)
+        value = static_cast<Ty>(raw);
+    else
+        value = static_cast<Ty>(FP64_ToDouble(raw));
+    return true;
 }
 
 template<typename Ty>
-bool SetParameterTy(const std::string &param_name, Ty value) {
-    try {
-        using namespace std;
-        ofstream file(YEETMOUSE_PARAMS_DIR + param_name);
+bool GetParameterTy(const std::string &param_name, Ty &value) {
+    std::string_view text;
+    return ReadParameter(param_name, text) && ParseNumber(text, value);
+}
 
-        if (file.bad())
-            return false;
+bool GetParameterTy(const std::string &param_name, std::string &value) {
+    std::string_view text;
+    if (!ReadParameter(param_name, text))
+        return false;
 
-        file << value;
-        file.close();
-        return true;
-    } catch (std::exception &ex) {
-        fprintf(stderr, "Error when saving parameter %s (%s)\n", param_name.c_str(), ex.what());
+    value = text;
+    return true;
+}
+
+template<typename Ty>
+bool SetParameterTy(const std::string &param_name, Ty value) {
+    std::ostringstream ss;
+    ss << value;
+
+    if (int error = WriteParameter(param_name, ss.str())) {
+        fprintf(stderr, "Error when saving parameter %s (%s)\n", param_name.c_str(), strerror(error));
         return false;
     }
+    return true;
 }
 
 namespace DriverHelper {
@@ -94,55 +294,42 @@ namespace DriverHelper {
         namespace fs = std::filesystem;
 
         for (const auto &entry: fs::directory_iterator(YEETMOUSE_PARAMS_DIR)) {
-            std::string str;
-            std::ifstream t(entry.path());
-            if (!t.is_open() || t.bad() || t.fail())
+            const std::string param_name = entry.path().filename();
+            std::string_view text;
+            if (!ReadParameter(param_name, text))
                 return false;
-            std::stringstream buffer;
-            buffer << t.rdbuf();
-            str = buffer.str();
+            std::string str(text);
             //printf("param at %s = %s\n", entry.path().c_str(), str.c_str());
 
-            //std::streampos size = t.tellg();
-            //std::cout << "pos = " << size << std::endl;
-            //t.clear();
-            //t.seekp(0);
-            // I assume this is enough to not leave behind some parts of the old values if the new ones are shorter
-            t.close();
-
             try {
+                std::string clean;
                 // Integer written with FP64_Shift
                 if (size_t bracket_pos = str.find('('), ll_pos = str.find("ll");
                     str.find("<< 32") != std::string::npos && bracket_pos != std::string::npos && ll_pos !=
                     std::string::npos) {
-                    fixed_num++;
-                    std::ofstream o(entry.path());
-                    if (!o.is_open() || o.bad() || o.fail())
-                        return false;
-                    std::string int_str = str.substr(bracket_pos + 1, ll_pos - bracket_pos - 1);
-                    //printf("Clean param: %s\n", int_str.c_str());
-                    o.write(int_str.c_str(), int_str.size());
-                    o.close();
+                    clean = str.substr(bracket_pos + 1, ll_pos - bracket_pos - 1);
+                    //printf("Clean param: %s\n", clean.c_str());
                 } else if (ll_pos != std::string::npos) {
                     // Floating point represented as a long long
-                    fixed_num++;
                     size_t start_offset = bracket_pos == std::string::npos ? 0 : (bracket_pos + 1);
-                    std::ofstream o(entry.path());
-                    if (!o.is_open() || o.bad() || o.fail())
-                        return false;
-                    std::string int_str = str.substr(start_offset, ll_pos - start_offset);
-                    FP_LONG fp_val = std::stoll(int_str);
+                    FP_LONG fp_val = std::stoll(str.substr(start_offset, ll_pos - start_offset));
                     char buf[24];
                     FP64_ToString(fp_val, buf, 6);
-                    //printf("Clean param: %s, which is %s\n", int_str.c_str(), buf);
-                    o.write(buf, strlen(buf));
-                    o.close();
+                    clean = buf;
+                    //printf("Clean param: %s\n", clean.c_str());
                 } else {
                     // Anything else is either 0 or not meant to be a floating point
                     //printf("Wrong format \\;\n");
+                    continue;
+                }
+
+                fixed_num++;
+                if (int error = WriteParameter(param_name, clean)) {
+                    fprintf(stderr, "Error when cleaning parameter %s (%s)\n", param_name.c_str(), strerror(error));
+                    return false;
                 }
             } catch (const std::exception &ex) {
-                fprintf(stderr, "Error parsing parameter %s!\n", entry.path().filename().c_str());
+                fprintf(stderr, "Error parsing parameter %s!\n", param_name.c_str());
                 return false;
             }
         }
@@ -157,6 +344,128 @@ namespace DriverHelper {
         return SetParameterTy("update", (int) 1);
     }
 
+    bool WriteProfile(const std::string &profile) {
+        // The driver only sees a consistent profile if it arrives in one piece
+        if (int error = WriteParameter("profile", profile)) {
+            fprintf(stderr, "Error when committing the profile (%s)\n", strerror(error));
+            return false;
+        }
+        return true;
+    }
+
+    bool WriteParameters(std::vector<ParameterWrite> &writes) {
+        bool res = true;
+        for (auto &write: writes) {
+            write.error = WriteParameter(write.param_name, write.value);
+            if (write.error) {
+                fprintf(stderr, "Error when saving parameter %s (%s)\n", write.param_name.c_str(),
+                        strerror(write.error));
+                res = false;
+            }
+        }
+        return res;
+    }
+
+    void QueueWrites(std::vector<ParameterWrite> writes) {
+        parameter_writer.Queue(std::move(writes));
+    }
+
+    bool TakeWriteResults(std::vector<ParameterWrite> &results) {
+        return parameter_writer.TakeResults(results);
+    }
+
+    void FlushWrites() {
+        parameter_writer.Flush();
+    }
+
+    void SetWriteNotify(void (*callback)()) {
+        parameter_writer.SetNotify(callback);
+    }
+
+    bool ReadDriverState(Parameters &params, std::string &lut_text, std::string &custom_curve_text) {
+        std::string_view profile;
+        if (!ReadParameter("profile", profile) || !ParseDriverProfile(profile, params, lut_text))
+            return false;
+
+        // Not a part of the profile, the driver just keeps it for the GUI
+        std::string_view curve;
+        if (ReadParameter("_CustomCurveDataAggregate", curve))
+            custom_curve_text = curve;
+
+        return true;
+    }
+
+    bool ParseDriverProfile(std::string_view profile, Parameters &params, std::string &lut_text) {
+        static const std::pair<std::string_view, float Parameters::*> fields[] = {
+            {"Sensitivity", &Parameters::sens},
+            {"SensitivityY", &Parameters::sensY},
+            {"OutputCap", &Parameters::outCap},
+            {"InputCap", &Parameters::inCap},
+            {"Offset", &Parameters::offset},
+            {"PreScale", &Parameters::preScale},
+            {"Acceleration", &Parameters::accel},
+            {"Exponent", &Parameters::exponent},
+            {"Midpoint", &Parameters::midpoint},
+            {"Motivity", &Parameters::motivity},
+            {"RotationAngle", &Parameters::rotation},
+            {"AngleSnap_Threshold", &Parameters::as_threshold},
+            {"AngleSnap_Angle", &Parameters::as_angle},
+        };
+
+        bool has_mode = false;
+        while (!profile.empty()) {
+            size_t line_end = profile.find('\n');
+            std::string_view line = profile.substr(0, line_end);
+            profile.remove_prefix(line_end == std::string_view::npos ? profile.size() : line_end + 1);
+
+            size_t eq = line.find('=');
+            if (eq == std::string_view::npos)
+                continue;
+            std::string_view name = Trim(line.substr(0, eq)), value = Trim(line.substr(eq + 1));
+
+            bool parsed = true;
+            if (name == "AccelerationMode") {
+                int mode = 0;
+                parsed = has_mode = FromChars(value, mode);
+                params.accelMode = static_cast<AccelMode>(mode);
+            } else if (name == "UseSmoothing") {
+                int smoothing = 0;
+                parsed = FromChars(value, smoothing);
+                params.useSmoothing = smoothing == 1;
+            } else if (name == "LutSize")
+                parsed = FromChars(value, params.LUT_size);
+            else if (name == "LutDataBuf") {
+                lut_text = value;
+                ParseDriverLutData(lut_text.c_str(), params.LUT_data_x, params.LUT_data_y);
+            } else {
+                for (const auto &[field_name, field]: fields) {
+                    if (name == field_name) {
+                        parsed = FromChars(value, params.*field);
+                        break;
+                    }
+                }
+            }
+
+            if (!parsed) {
+                fprintf(stderr, "Could not parse %.*s in the driver's profile\n", (int) name.size(), name.data());
+                return false;
+            }
+        }
+        if (!has_mode)
+            return false;
+
+        // The driver takes radians, the GUI shows degrees
+        params.rotation /= DEG2RAD;
+        params.as_threshold /= DEG2RAD;
+        params.as_angle /= DEG2RAD;
+
+        return true;
+    }
+
+    bool GetProfileVersion(unsigned long long &version) {
+        return GetParameterTy("profile_version", version);
+    }
+
     bool WriteParameterF(const std::string &param_name, float value) {
         return SetParameterTy(param_name, value);
     }
@@ -178,6 +487,51 @@ namespace DriverHelper {
         return true;
     }
 
+    // Without debugfs, the driver's code runs here instead (see lib/), with the profile the driver reports in use.
+    // Its numbers read back bit for bit (see FP64_ToStringExact()), so this is the very profile the driver runs.
+    static bool EvaluateProfile(const FP_LONG *speeds, FP_LONG *out, size_t count) {
+        static bool initialized = yeetaccel_init() == 0;
+        std::string profile, line, filtered;
+
+        if (!initialized || !GetParameterS("profile", profile))
+            return false;
+
+        // Slots and versions are the driver's business, here it's just the profile to evaluate
+        std::stringstream ss(profile);
+        while (std::getline(ss, line)) {
+            if (line.rfind("Slot=", 0) != 0 && line.rfind("Version=", 0) != 0)
+                filtered += line + '\n';
+        }
+
+        return yeetaccel_param_set("profile", filtered.c_str()) == 0 && accel_eval(speeds, out, count) == 0;
+    }
+
+    bool EvaluateDriverCurve(const double *speeds, double *out, size_t count) {
+        if (count == 0 || count > DRIVER_EVAL_MAX_POINTS)
+            return false;
+
+        std::vector<FP_LONG> buf(count);
+        for (size_t i = 0; i < count; i++)
+            buf[i] = FP64_FromDouble(speeds[i]);
+
+        int fd = open(YEETMOUSE_DEBUGFS_DIR "eval", O_RDWR | O_CLOEXEC);
+        if (fd >= 0) {
+            // The whole batch has to go in a single write, and is evaluated when read back from the start
+            const ssize_t size = count * sizeof(FP_LONG);
+            bool ok = write(fd, buf.data(), size) == size && pread(fd, buf.data(), size, 0) == size;
+            close(fd);
+
+            if (!ok)
+                return false;
+        } else if (!EvaluateProfile(buf.data(), buf.data(), count))
+            return false;
+
+        for (size_t i = 0; i < count; i++)
+            out[i] = FP64_ToDouble(buf[i]);
+
+        return true;
+    }
+
     size_t ParseUserLutData(char *szUser_data, double *out_x, double *out_y, size_t out_size) {
         if (!szUser_data) {
             strcpy(szUser_data, "Bad data pointer\0");
@@ -277,19 +631,20 @@ namespace DriverHelper {
     }
 
     size_t ParseDriverLutData(const char *szUser_data, double *out_x, double *out_y) {
-        std::stringstream ss(szUser_data);
+        // "x,y;x,y;..." as the driver prints it, or all separated with ';' (older drivers)
+        const char *p = szUser_data, *end = szUser_data + strlen(szUser_data);
         size_t idx = 0;
 
-        double p = 0;
-        while (idx < MAX_LUT_ARRAY_SIZE * 2 && ss >> p) {
-            //printf("idx = %zu, p = %f\n", idx, p);
-            (idx % 2 == 0 ? out_x : out_y)[idx++ / 2] = p;
+        while (idx < MAX_LUT_ARRAY_SIZE * 2) {
+            while (p < end && (*p == ',' || *p == ';' || isspace(static_cast<unsigned char>(*p))))
+                p++;
 
-            char nextC = ss.peek();
-            if (nextC == ';')
-                ss.ignore();
-
-            //idx++;
+            double value = 0;
+            auto [next, ec] = std::from_chars(p, end, value);
+            if (ec != std::errc())
+                break;
+            (idx % 2 == 0 ? out_x : out_y)[idx++ / 2] = value;
+            p = next;
         }
 
         // 1 element is not enough for a linear interpolation
@@ -300,7 +655,7 @@ namespace DriverHelper {
         return idx / 2;
     }
 
-    std::string EncodeLutData(double *data_x, double *data_y, size_t size, bool strict_format) {
+    std::string EncodeLutData(const double *data_x, const double *data_y, size_t size, bool strict_format) {
         std::stringstream res;
         res << std::setprecision(LUT_EXPORT_PRECISION);
 
@@ -319,49 +674,55 @@ namespace DriverHelper {
 //                                                                           midpoint(midpoint), scrollAccel(scrollAccel),
 //                                                                           accelMode(accelMode) {}
 
-bool Parameters::SaveAll() {
-    bool res = true;
+bool Parameters::BuildWrites(std::vector<DriverHelper::ParameterWrite> &writes) const {
+    std::stringstream profile;
+    profile << std::fixed << std::setprecision(6);
 
     // LUT
     auto encodedLutData = DriverHelper::EncodeLutData(LUT_data_x, LUT_data_y, LUT_size);
     if (!encodedLutData.empty() && encodedLutData.size() < MAX_LUT_BUF_LEN) {
-        res &= SetParameterTy("LutSize", LUT_size);
-        //res &= SetParameterTy("LutStride", LUT_stride);
-        //printf("encoded: %s, size: %zu, stride: %i\n", encoded.c_str(), LUT_size, LUT_stride);
-        res &= SetParameterTy("LutDataBuf", encodedLutData);
+        profile << "LutSize=" << LUT_size << '\n';
+        profile << "LutDataBuf=" << encodedLutData << '\n';
     } else if (accelMode == AccelMode_Lut || accelMode == AccelMode_CustomCurve)
         return false;
 
-    // Custom Curve
+    // Custom Curve (not used by the driver, so it's not a part of the profile)
     auto encodedCCData = customCurve.ExportCustomCurve();
     if (!encodedCCData.empty() && encodedCCData.size() < MAX_LUT_BUF_LEN) {
-        res &= SetParameterTy("_CustomCurveDataAggregate", encodedCCData);
+        writes.push_back({"_CustomCurveDataAggregate", encodedCCData});
     }
     else if (accelMode == AccelMode_CustomCurve)
         return false;
 
     // General
-    res &= SetParameterTy("Sensitivity", sens);
-    res &= SetParameterTy("SensitivityY", use_anisotropy ? sensY : sens);
-    res &= SetParameterTy("OutputCap", outCap);
-    res &= SetParameterTy("InputCap", inCap);
-    res &= SetParameterTy("Offset", offset);
-    res &= SetParameterTy("RotationAngle", rotation * DEG2RAD);
-    res &= SetParameterTy("AngleSnap_Threshold", as_threshold * DEG2RAD);
-    res &= SetParameterTy("AngleSnap_Angle", as_angle * DEG2RAD);
+    profile << "Sensitivity=" << sens << '\n';
+    profile << "SensitivityY=" << (use_anisotropy ? sensY : sens) << '\n';
+    profile << "OutputCap=" << outCap << '\n';
+    profile << "InputCap=" << inCap << '\n';
+    profile << "Offset=" << offset << '\n';
+    profile << "RotationAngle=" << rotation * DEG2RAD << '\n';
+    profile << "AngleSnap_Threshold=" << as_threshold * DEG2RAD << '\n';
+    profile << "AngleSnap_Angle=" << as_angle * DEG2RAD << '\n';
 
     // Specific
-    res &= SetParameterTy("Acceleration", accel);
-    res &= SetParameterTy("Exponent", exponent);
-    res &= SetParameterTy("Midpoint", midpoint);
-    res &= SetParameterTy("Motivity", motivity);
-    res &= SetParameterTy("PreScale", preScale);
-    res &= SetParameterTy("UseSmoothing", useSmoothing);
+    profile << "Acceleration=" << accel << '\n';
+    profile << "Exponent=" << exponent << '\n';
+    profile << "Midpoint=" << midpoint << '\n';
+    profile << "Motivity=" << motivity << '\n';
+    profile << "PreScale=" << preScale << '\n';
+    profile << "UseSmoothing=" << useSmoothing << '\n';
 
-    res &= SetParameterTy("AccelerationMode", accelMode);
+    profile << "AccelerationMode=" << accelMode << '\n';
 
-    if (res)
-        res &= DriverHelper::SaveParameters();
+    // Everything goes in at once, the driver either takes the whole profile or none of it
+    if (profile.tellp() > MAX_PROFILE_LEN)
+        return false;
+    writes.push_back({"profile", profile.str()});
+
+    return true;
+}
 
-    return res;
+bool Parameters::SaveAll() {
+    std::vector<DriverHelper::ParameterWrite> writes;
+    return BuildWrites(writes) && DriverHelper::WriteParameters(writes);
 }
@@ -3,18 +3,23 @@
 
 #include <cmath>
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <algorithm>
+#include <vector>
 
 #include "CustomCurve.h"
 #include "../shared_definitions.h"
 
 #define MAX_LUT_ARRAY_SIZE 128  // THIS NEEDS TO BE THE SAME AS IN THE DRIVER CODE
 #define MAX_LUT_BUF_LEN 4096
+#define MAX_PROFILE_LEN (4096 - 2) // The driver takes the profile in a single write, shorter than PAGE_SIZE - 1
 #define LUT_EXPORT_PRECISION 5 // Decimal points precision for exporting a LUT
 
 #define DEG2RAD (M_PI / 180.0)
 
+struct Parameters;
+
 namespace DriverHelper {
     bool GetParameterF(const std::string &param_name, float &value);
     bool GetParameterI(const std::string &param_name, int &value);
@@ -26,8 +31,50 @@ namespace DriverHelper {
 
     bool SaveParameters();
 
+    /// Commits a whole profile ('Name=Value' lines) in a single write, the driver validates and swaps it atomically
+    bool WriteProfile(const std::string &profile);
+
+    /// A write of one parameter file. error is the errno it failed with, 0 if it went through
+    struct ParameterWrite {
+        std::string param_name;
+        std::string value;
+        int error = 0;
+    };
+
+    /// Writes the parameters in order, each one in a single write. Returns false if any of them failed (see error)
+    bool WriteParameters(std::vector<ParameterWrite> &writes);
+
+    /// WriteParameters() on a background thread, the batches get written in the order they were queued
+    void QueueWrites(std::vector<ParameterWrite> writes);
+
+    /// Moves out the writes finished since the last call (with their errors), returns false if there were none
+    bool TakeWriteResults(std::vector<ParameterWrite> &results);
+
+    /// Waits for all the queued writes to finish
+    void FlushWrites();
+
+    /// Called from the background thread after every written batch, nullptr for none
+    void SetWriteNotify(void (*callback)());
+
+    /// Reads the parameters the driver uses, all at once and without writing anything: the whole active profile in a
+    /// single read, and the custom curve stored next to it. The angles come out in degrees, like the GUI keeps them,
+    /// lut_text gets the LUT as the driver prints it. Returns false if there's no profile to read (an older driver).
+    bool ReadDriverState(Parameters &params, std::string &lut_text, std::string &custom_curve_text);
+
+    /// The parsing part of ReadDriverState(), 'profile' as the driver prints it. The driver prints its numbers exactly,
+    /// so the parameters written by Parameters::BuildWrites() come back as the same floats
+    bool ParseDriverProfile(std::string_view profile, Parameters &params, std::string &lut_text);
+
+    /// Version of the profile currently used by the driver, bumped on every commit
+    bool GetProfileVersion(unsigned long long &version);
+
     bool ValidateDirectory();
 
+    /// Evaluates the multipliers the driver applies at the given input speeds (counts/ms), bit-exact with the kernel.
+    /// Asks the driver itself if it can (debugfs, root), otherwise runs the driver's code (libyeetaccel) with the
+    /// profile in use, which the driver prints exactly. Returns false if the driver isn't loaded.
+    bool EvaluateDriverCurve(const double *speeds, double *out, size_t count);
+
     /// Converts the ugly FP64 representation of user parameters to nice floating point values
     bool CleanParameters(int &fixed_num);
 
@@ -37,7 +84,7 @@ namespace DriverHelper {
     /// Returns the number of parsed values
     size_t ParseDriverLutData(const char *user_data, double *out_x, double *out_y);
 
-    std::string EncodeLutData(double *data_x, double *data_y, size_t size, bool strict_format = true);
+    std::string EncodeLutData(const double *data_x, const double *data_y, size_t size, bool strict_format = true);
 } // DriverHelper
 
 inline std::string AccelMode2String(AccelMode mode) {
@@ -208,6 +255,7 @@ struct Parameters {
     double LUT_data_x[MAX_LUT_ARRAY_SIZE];
     double LUT_data_y[MAX_LUT_ARRAY_SIZE];
     int LUT_size = 0;
+    double LUT_error = 0; // Custom curve only: max error of the LUT against the curve, as of the last export
 
     CustomCurve customCurve{};
 
@@ -219,6 +267,9 @@ struct Parameters {
     //Parameters(float sens, float sensCap, float speedCap, float offset, float accel, float exponent, float midpoint,
     //           float scrollAccel, int accelMode);
 
+    /// The writes that apply these parameters (see DriverHelper::QueueWrites()), false if they can't be encoded
+    bool BuildWrites(std::vector<DriverHelper::ParameterWrite> &writes) const;
+
     bool SaveAll();
 };
 
@@ -1,9 +1,10 @@
+#include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 #include "FunctionHelper.h"
 
 #define EXP_ARG_THRESHOLD 16ll
-#define FUNC_EVAL_START_VAL 0.01f
 
 CachedFunction::CachedFunction(float xStride, Parameters *params)
         : x_stride(xStride), params(params) { }
@@ -19,21 +20,14 @@ inline float lerp(float a, float b, float t) {
  * gamma -> exponent
  */
 float CachedFunction::SynchronousLegacy(float x) const {
-    float logMot = std::log(params->motivity);
-    float gammaConst = params->exponent / logMot;
-    float logSync = std::log(params->accel);
+    const SynchronousConstants &c = synchronous_constants;
+    const float logMot = c.logMot, gammaConst = c.gammaConst, logSync = c.logSync;
+    const float sharpness = c.sharpness, sharpnessRecip = c.sharpnessRecip;
 
-    float sharpness = (params->midpoint == 0.0) ? 16.0 : (0.5 / params->midpoint);
-    float sharpnessRecip = 1.0 / sharpness;
-    bool useClamp = sharpness >= 16.0;
-
-    float minSens = 1.0 / params->motivity;
-    float maxSens = params->motivity;
-
-    if (useClamp) {
+    if (c.useClamp) {
         float L = gammaConst * (std::log(x) - logSync);
-        if (L < -1.0) return minSens;
-        if (L > +1.0) return maxSens;
+        if (L < -1.0) return c.minSens;
+        if (L > +1.0) return c.maxSens;
         return std::exp(L * logMot);
     }
     if (x == params->accel) {
@@ -82,10 +76,19 @@ bool CachedFunction::SynchronousBuildLUT() {
         a = b;
         synchronous_data.data.push_back(sum);
     }
+
+    synchronous_data.accel = params->accel;
+    synchronous_data.exponent = params->exponent;
+    synchronous_data.midpoint = params->midpoint;
+    synchronous_data.motivity = params->motivity;
     return true;
 }
 
 float CachedFunction::SynchronousGainEval(float x) const {
+    // Not built yet (the function is still waiting for the first PreCacheFunc())
+    if (synchronous_data.data.empty())
+        return SynchronousLegacy(x);
+
     // find exponent e = floor(log2(x)), clamped
     int e = std::min(std::max(std::ilogb(x), SynchronousData::start), SynchronousData::stop - 1);
 
@@ -112,42 +115,25 @@ float CachedFunction::SynchronousGainEval(float x) const {
     return y;
 }
 
-float CachedFunction::EvalFuncAt(float x) const {
+// The mode's curve alone, Mode is known at compile time so the switch folds away (see EvalFuncBatch())
+template <AccelMode Mode>
+float CachedFunction::EvalMode(float x) const {
     static_assert(AccelMode_Count == 10);
 
-    x *= params->preScale;
-    if (params->inCap > 0) {
-        x = fminf(x, params->inCap);
-    }
     float val = 0;
-    switch (params->accelMode) {
+    switch (Mode) {
         case AccelMode_Current: {
             break;
         }
         case AccelMode_Linear: // Linear
         {
             if (params->useSmoothing) {
-                // The sign is used to have the possibility to
-                // allow negative values
-                float sign = 1.0;
-                float cap_y = params->midpoint - 1.0;
-                float cap_x = 0.0;
-                if (cap_y != 0.0) {
-                    if (cap_y < 0.0) {
-                        cap_y = -cap_y;
-                        sign = -sign;
-                    }
-                    cap_x = (cap_y / 2) / params->accel;
-                }
-                // The following expresions has been simplified
-                // to a single constant expresion
-                // float m = cap_y / 2;
-                // float constant = (m - cap_y) * cap_x;
-                float constant = -cap_y * cap_x / 2;
-                if (x < cap_x) {
+                // See PreCacheConstants() for the constants
+                const float sign = cap.sign;
+                if (x < cap.x) {
                     val = sign * x * params->accel + 1.0;
                 } else {
-                    val = sign * (constant / x + cap_y) + 1.0;
+                    val = sign * (cap.constant / x + cap.y) + 1.0;
                 }
             } else {
                 val = params->accel * x + 1;
@@ -160,21 +146,10 @@ float CachedFunction::EvalFuncAt(float x) const {
                 val = params->midpoint;
             else {
                 if (params->useSmoothing) {
-                    float cap_y = params->motivity;
-                    float cap_x = 0.0;
-                    if (cap_y > 0.0) {
-                        cap_x = (std::pow(cap_y / (params->exponent + 1.0), 1.0 / params->exponent)) / params->accel;
-                    }
-                    // float m = std::pow(cap_x * params->accel,
-                    // params->exponent) + (power_constant / cap_x); float
-                    // constant = (m - cap_y) * cap_x;
-                    // those expresions were simplified into:
-                    float constant = std::pow(cap_x * params->accel, params->exponent) * cap_x + power_constant - cap_x
-                                     * cap_y;
-                    if (x < cap_x) {
+                    if (x < cap.x) {
                         val = std::pow(x * params->accel, params->exponent) + (power_constant / x);
                     } else {
-                        val = constant / x + cap_y;
+                        val = cap.constant / x + cap.y;
                     }
                 } else {
                     val = std::pow(x * params->accel, params->exponent) + (power_constant / x);
@@ -187,25 +162,11 @@ float CachedFunction::EvalFuncAt(float x) const {
         case AccelMode_Classic: // Classic
         {
             if (params->useSmoothing) {
-                // The sign is used to have the possibility to
-                // allow negative values
-                float sign = 1.0;
-                float accel_raised = std::pow(params->accel, params->exponent - 1.0);
-                float cap_y = params->midpoint - 1.0;
-                float cap_x = 0.0;
-                if (cap_y != 0.0) {
-                    if (cap_y < 0.0) {
-                        cap_y = -cap_y;
-                        sign = -sign;
-                    }
-                    cap_x = (std::pow(cap_y / params->exponent, 1.0 / (params->exponent - 1.0))) / params->accel;
-                }
-                float m = accel_raised * std::pow(cap_x, params->exponent - 1.0);
-                float constant = (m - cap_y) * cap_x;
-                if (x < cap_x) {
+                const float sign = cap.sign;
+                if (x < cap.x) {
                     val = sign * std::pow(x * params->accel, params->exponent - 1.0) + 1.0;
                 } else {
-                    val = sign * (constant / x + cap_y) + 1.0;
+                    val = sign * (cap.constant / x + cap.y) + 1.0;
                 }
             } else {
                 val = std::pow(x * params->accel, params->exponent - 1.0) + 1.0;
@@ -229,17 +190,16 @@ float CachedFunction::EvalFuncAt(float x) const {
             if (x <= params->midpoint) {
                 val = 1;
             } else {
-                float limit = params->exponent - 1.0;
-                float auxiliar_accel = params->accel / std::fabs(limit);
-                float offset = params->midpoint;
-                float n_offset_x = offset - x;
-                float decay = std::exp(auxiliar_accel * n_offset_x);
+                // In double, the smooth variant cancels out almost completely at low speeds with a small decay rate
+                const double limit = natural_limit;
+                double offset = params->midpoint;
+                double n_offset_x = offset - x;
+                double decay = std::exp(natural_auxiliar_accel * n_offset_x);
 
                 if (params->useSmoothing) {
-                    float auxiliar_constant = -limit / auxiliar_accel;
-                    float numerator =
-                            limit * ((decay / auxiliar_accel) - n_offset_x) +
-                            auxiliar_constant;
+                    double numerator =
+                            limit * ((decay / natural_auxiliar_accel) - n_offset_x) +
+                            natural_auxiliar_constant;
                     val = (numerator / x) + 1.0;
                 } else {
                     val = limit * (1.0 - (offset - decay * n_offset_x) / x) + 1.0;
@@ -336,36 +296,157 @@ float CachedFunction::EvalFuncAt(float x) const {
         }
     }
 
+    return val;
+}
+
+// Calls f with the mode as a compile time constant (std::integral_constant)
+template <typename F>
+static void DispatchMode(AccelMode mode, F &&f) {
+    static_assert(AccelMode_Count == 10);
+
+    switch (mode) {
+        case AccelMode_Linear: f(std::integral_constant<AccelMode, AccelMode_Linear>{}); break;
+        case AccelMode_Power: f(std::integral_constant<AccelMode, AccelMode_Power>{}); break;
+        case AccelMode_Classic: f(std::integral_constant<AccelMode, AccelMode_Classic>{}); break;
+        case AccelMode_Motivity: f(std::integral_constant<AccelMode, AccelMode_Motivity>{}); break;
+        case AccelMode_Synchronous: f(std::integral_constant<AccelMode, AccelMode_Synchronous>{}); break;
+        case AccelMode_Natural: f(std::integral_constant<AccelMode, AccelMode_Natural>{}); break;
+        case AccelMode_Jump: f(std::integral_constant<AccelMode, AccelMode_Jump>{}); break;
+        case AccelMode_Lut: f(std::integral_constant<AccelMode, AccelMode_Lut>{}); break;
+        case AccelMode_CustomCurve: f(std::integral_constant<AccelMode, AccelMode_CustomCurve>{}); break;
+        default: f(std::integral_constant<AccelMode, AccelMode_Current>{}); break;
+    }
+}
+
+float CachedFunction::EvalFuncAt(float x) const {
+    x *= params->preScale;
+    if (params->inCap > 0) {
+        x = fminf(x, params->inCap);
+    }
+    float val = 0;
+    DispatchMode(params->accelMode, [&](auto mode) { val = EvalMode<decltype(mode)::value>(x); });
+
     return ((params->outCap > 0) ? fminf(val, params->outCap) : val) * params->sens;
 }
 
+void CachedFunction::EvalFuncBatch(const float *xs, float *out, size_t n) const {
+    // Copies of the parameters and restrict pointers: the compiler has to know that the stores to out don't change
+    // them (or xs), otherwise it reloads them every iteration and nothing gets vectorized
+    const float pre_scale = params->preScale, in_cap = params->inCap, out_cap = params->outCap, sens = params->sens;
+    const float *__restrict src = xs;
+    float *__restrict dst = out;
+
+    // The caps are positive here, so 'x < cap ? x : cap' is fminf() (NaN included), but it maps to a vector min
+    if (in_cap > 0) {
+        for (size_t i = 0; i < n; i++) {
+            float x = src[i] * pre_scale;
+            dst[i] = x < in_cap ? x : in_cap;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++)
+            dst[i] = src[i] * pre_scale;
+    }
+
+    // One loop per mode, with the dispatch out of it
+    DispatchMode(params->accelMode, [&](auto mode) {
+        for (size_t i = 0; i < n; i++)
+            dst[i] = EvalMode<decltype(mode)::value>(dst[i]);
+    });
+
+    if (out_cap > 0) {
+        for (size_t i = 0; i < n; i++)
+            dst[i] = (dst[i] < out_cap ? dst[i] : out_cap) * sens;
+    } else {
+        for (size_t i = 0; i < n; i++)
+            dst[i] *= sens;
+    }
+}
+
 void CachedFunction::PreCacheConstants() {
-    // Pre-Cache constants
+    // Pre-Cache constants, everything that only depends on the parameters, so that EvalFuncAt() only does the part
+    // that depends on x
     switch (params->accelMode) {
         case AccelMode_Current: {
             break;
         }
         case AccelMode_Linear: {
+            // The sign is used to have the possibility to
+            // allow negative values
+            cap.sign = 1.0;
+            cap.y = params->midpoint - 1.0;
+            cap.x = 0.0;
+            if (cap.y != 0.0) {
+                if (cap.y < 0.0) {
+                    cap.y = -cap.y;
+                    cap.sign = -cap.sign;
+                }
+                cap.x = (cap.y / 2) / params->accel;
+            }
+            // The following expresions has been simplified
+            // to a single constant expresion
+            // float m = cap_y / 2;
+            // float constant = (m - cap_y) * cap_x;
+            cap.constant = -cap.y * cap.x / 2;
             break;
         }
         case AccelMode_Power: {
             offset_x = std::pow(params->midpoint / (params->exponent + 1), 1 / params->exponent) / params->accel;
             power_constant = offset_x * params->midpoint * params->exponent / (params->exponent + 1);
             //printf("offset_x = %f, constant = %f\n", offset_x, power_constant);
+
+            cap.y = params->motivity;
+            cap.x = 0.0;
+            if (cap.y > 0.0) {
+                cap.x = (std::pow(cap.y / (params->exponent + 1.0), 1.0 / params->exponent)) / params->accel;
+            }
+            // float m = std::pow(cap_x * params->accel,
+            // params->exponent) + (power_constant / cap_x); float
+            // constant = (m - cap_y) * cap_x;
+            // those expresions were simplified into:
+            cap.constant = std::pow(cap.x * params->accel, params->exponent) * cap.x + power_constant - cap.x * cap.y;
             break;
         }
         case AccelMode_Classic: {
+            cap.sign = 1.0;
+            float accel_raised = std::pow(params->accel, params->exponent - 1.0);
+            cap.y = params->midpoint - 1.0;
+            cap.x = 0.0;
+            if (cap.y != 0.0) {
+                if (cap.y < 0.0) {
+                    cap.y = -cap.y;
+                    cap.sign = -cap.sign;
+                }
+                cap.x = (std::pow(cap.y / params->exponent, 1.0 / (params->exponent - 1.0))) / params->accel;
+            }
+            float m = accel_raised * std::pow(cap.x, params->exponent - 1.0);
+            cap.constant = (m - cap.y) * cap.x;
             break;
         }
         case AccelMode_Motivity: {
             break;
         }
         case AccelMode_Synchronous: {
-            if (params->useSmoothing)
+            SynchronousConstants &c = synchronous_constants;
+            c.logMot = std::log(params->motivity);
+            c.gammaConst = params->exponent / c.logMot;
+            c.logSync = std::log(params->accel);
+
+            c.sharpness = (params->midpoint == 0.0) ? 16.0 : (0.5 / params->midpoint);
+            c.sharpnessRecip = 1.0 / c.sharpness;
+            c.useClamp = c.sharpness >= 16.0;
+
+            c.minSens = 1.0 / params->motivity;
+            c.maxSens = params->motivity;
+
+            // Rebuilt only when the integrated parameters change, not on every sensitivity or cap change
+            if (params->useSmoothing && !synchronous_data.IsBuiltFor(*params))
                 SynchronousBuildLUT();
             break;
         }
         case AccelMode_Natural: {
+            natural_limit = params->exponent - 1.0;
+            natural_auxiliar_accel = params->accel / std::fabs(natural_limit);
+            natural_auxiliar_constant = -natural_limit / natural_auxiliar_accel;
             break;
         }
         case AccelMode_Jump: {
@@ -402,22 +483,18 @@ void CachedFunction::PreCacheConstants() {
 void CachedFunction::PreCacheFunc() {
     PreCacheConstants();
 
+    float xs[PLOT_POINTS];
     float x = -params->offset + FUNC_EVAL_START_VAL;
     for (int i = 0; i < PLOT_POINTS; i++) {
-        if (x < 0) {
-            // skip offset
-            values[i] = EvalFuncAt(FUNC_EVAL_START_VAL);
-            values_y[i] = params->sensY * values[i];
-            x += x_stride;
-            continue;
-        }
-        float val = EvalFuncAt(x);
-        values[i] = val; // fabsf(params->outCap) > 0.01 ? fminf(val, params->outCap) : val;
-        if (params->use_anisotropy)
-            values_y[i] = val * params->sensY;
+        // skip offset
+        xs[i] = x < 0 ? FUNC_EVAL_START_VAL : x;
         x += x_stride;
     }
 
+    EvalFuncBatch(xs, values, PLOT_POINTS);
+    for (int i = 0; i < PLOT_POINTS; i++)
+        values_y[i] = values[i] * params->sensY;
+
     ValidateSettings();
 }
 
@@ -428,6 +505,84 @@ float CachedFunction::EvaluateFuncWithGlobalParameters(float speed) const {
         return EvalFuncAt(x);
 }
 
+void CachedFunction::SampleAdaptive(float x_min, float x_max, PlotSamples &out) const {
+    std::vector<float> shifted;
+    auto evaluate = [this, &shifted](const std::vector<float> &xs, std::vector<float> &ys) {
+        // The same offset handling as EvaluateFuncWithGlobalParameters()
+        shifted.resize(xs.size());
+        for (size_t i = 0; i < xs.size(); i++) {
+            float x = xs[i] - params->offset + FUNC_EVAL_START_VAL;
+            shifted[i] = x <= 0 ? FUNC_EVAL_START_VAL : x;
+        }
+        ys.resize(xs.size());
+        EvalFuncBatch(shifted.data(), ys.data(), xs.size());
+    };
+
+    std::vector<float> xs(ADAPTIVE_INITIAL_POINTS + 1), ys;
+    for (int i = 0; i <= ADAPTIVE_INITIAL_POINTS; i++)
+        xs[i] = x_min + (x_max - x_min) * i / ADAPTIVE_INITIAL_POINTS;
+    evaluate(xs, ys);
+
+    // Relative to the curve's height, but at least to the height of a ratio of 1 (flat curves)
+    float y_min = 1, y_max = 0;
+    for (float y: ys) {
+        if (std::isfinite(y)) {
+            y_min = std::min(y_min, y);
+            y_max = std::max(y_max, y);
+        }
+    }
+    const float tolerance = ADAPTIVE_TOLERANCE * std::max(y_max - y_min, 1.f);
+
+    // Every interval to be halved on the next level
+    std::vector<char> refine(xs.size() - 1, true);
+    std::vector<float> mid_x, mid_y, new_xs, new_ys;
+    std::vector<char> new_refine;
+
+    for (int level = 0; level < ADAPTIVE_MAX_LEVELS && xs.size() < ADAPTIVE_MAX_POINTS; level++) {
+        mid_x.clear();
+        for (size_t i = 0; i + 1 < xs.size(); i++) {
+            if (refine[i])
+                mid_x.push_back((xs[i] + xs[i + 1]) / 2);
+        }
+        if (mid_x.empty())
+            break;
+        evaluate(mid_x, mid_y);
+
+        new_xs.clear();
+        new_ys.clear();
+        new_refine.clear();
+        for (size_t i = 0, m = 0; i + 1 < xs.size(); i++) {
+            new_xs.push_back(xs[i]);
+            new_ys.push_back(ys[i]);
+            if (!refine[i]) {
+                new_refine.push_back(false);
+                continue;
+            }
+
+            // ~ h^2 * f'' / 8, the halves get refined further where the curve bends (NaNs don't)
+            bool bends = std::fabs(mid_y[m] - (ys[i] + ys[i + 1]) / 2) > tolerance;
+            new_xs.push_back(mid_x[m]);
+            new_ys.push_back(mid_y[m]);
+            new_refine.push_back(bends);
+            new_refine.push_back(bends);
+            m++;
+        }
+        new_xs.push_back(xs.back());
+        new_ys.push_back(ys.back());
+
+        xs.swap(new_xs);
+        ys.swap(new_ys);
+        refine.swap(new_refine);
+    }
+
+    out.x = std::move(xs);
+    out.y = std::move(ys);
+    out.y_aniso.resize(out.y.size());
+    for (size_t i = 0; i < out.y.size(); i++)
+        out.y_aniso[i] = out.y[i] * params->sensY;
+    out.x_min = x_min;
+    out.x_max = x_max;
+}
 
 bool CachedFunction::ValidateSettings() {
     isValid = true;
@@ -5,10 +5,25 @@
 #include "DriverHelper.h"
 
 #define PLOT_POINTS (512)
+#define FUNC_EVAL_START_VAL 0.01f
 inline float PLOT_X_RANGE (150);
 
 #define LERP(a,b,x)     (((b) - (a)) * (x) + (a))
 
+// Adaptive sampling of the plotted range (see CachedFunction::SampleAdaptive())
+#define ADAPTIVE_INITIAL_POINTS 128
+#define ADAPTIVE_MAX_POINTS 8192
+#define ADAPTIVE_MAX_LEVELS 8 // Every level can halve the spacing once
+#define ADAPTIVE_TOLERANCE 0.0005f // Of the curve's height over the range, below a pixel even on a big plot
+
+/// The curve sampled over a range of speeds, denser where it bends
+struct PlotSamples {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> y_aniso; // y * sensY
+    float x_min = 0, x_max = 0;
+};
+
 class CachedFunction {
 public:
     float values[PLOT_POINTS]{0};
@@ -18,6 +33,9 @@ public:
 
     bool isValid = true;
 
+    // Of the plotted range, if there are any (see CurveWorker::SetPlotRange()), the values above otherwise
+    PlotSamples samples;
+
     CachedFunction(float xStride, Parameters *params);
 
     CachedFunction() {
@@ -25,16 +43,34 @@ public:
 
     float EvalFuncAt(float x) const;
 
+    /// EvalFuncAt() for n speeds at once (same results), xs and out must not overlap
+    void EvalFuncBatch(const float *xs, float *out, size_t n) const;
+
     void PreCacheConstants();
 
     void PreCacheFunc(); // Also validates settings
 
     float EvaluateFuncWithGlobalParameters(float speed) const;
 
+    /// Samples the curve (as EvaluateFuncWithGlobalParameters()) over [x_min, x_max]: starts uniformly and keeps
+    /// halving the intervals where the midpoint is off the straight line between the ends, the plot is drawn with
+    void SampleAdaptive(float x_min, float x_max, PlotSamples &out) const;
+
     // Result also saved into 'bool isValid'
     bool ValidateSettings();
 
 private:
+    template <AccelMode Mode>
+    float EvalMode(float x) const;
+
+    // Smooth capping of Linear, Power and Classic
+    struct {
+        float sign = 1;
+        float x = 0;
+        float y = 0;
+        float constant = 0;
+    } cap;
+
     // Constant parameters for Jump
     double smoothness = 0;
     double C0 = 0;
@@ -43,7 +79,23 @@ private:
     float offset_x = 0;
     float power_constant = 0;
 
+    // Natural (in double, see EvalFuncAt())
+    double natural_limit = 0;
+    double natural_auxiliar_accel = 0;
+    double natural_auxiliar_constant = 0;
+
     // Synchronous
+    struct SynchronousConstants {
+        float logMot = 0;
+        float gammaConst = 0;
+        float logSync = 0;
+        float sharpness = 0;
+        float sharpnessRecip = 0;
+        bool useClamp = false;
+        float minSens = 0;
+        float maxSens = 0;
+    } synchronous_constants;
+
     struct SynchronousData {
         static constexpr int start = -3;
         static constexpr int stop = 9;
@@ -53,6 +105,14 @@ private:
 
         std::vector<double> data;
         double xStart;
+
+        // The parameters the table was integrated for, the rest of them is applied on top of it
+        float accel = 0, exponent = 0, midpoint = 0, motivity = 0;
+
+        bool IsBuiltFor(const Parameters &params) const {
+            return !data.empty() && accel == params.accel && exponent == params.exponent &&
+                   midpoint == params.midpoint && motivity == params.motivity;
+        }
     } synchronous_data;
 
     bool SynchronousBuildLUT();
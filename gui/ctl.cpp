@@ -0,0 +1,225 @@
+// yeetmouse-ctl: imports, checks and applies the settings without the GUI, so without a display or OpenGL (e.g. from a
+// udev rule or a systemd unit at boot). The configs are the ones the GUI exports (plain text or config.h), they go
+// through the same import, validation and encoding as when applied from the GUI.
+//
+// Usage: yeetmouse-ctl COMMAND [ARGS]
+//   validate FILE...           Checks that the configs import and make a valid curve
+//   compile FILE               Prints what applying the config would write to the driver
+//   apply FILE [-s SLOT]       Applies the config (to the given profile slot, the active one by default)
+//   export [--config-h]        Prints the settings in use, as the GUI exports them
+//   dump                       Prints the driver's state as it reports it (the active profile and its slot)
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ConfigHelper.h"
+#include "DriverHelper.h"
+#include "FunctionHelper.h"
+#include "yeetaccel.h"
+
+static void PrintUsage() {
+    fprintf(stderr,
+            "Usage: yeetmouse-ctl COMMAND [ARGS]\n"
+            "  validate FILE...           Checks that the configs import and make a valid curve\n"
+            "  compile FILE               Prints what applying the config would write to the driver\n"
+            "  apply FILE [-s SLOT]       Applies the config (to the given profile slot, the active one by default)\n"
+            "  export [--config-h]        Prints the settings in use, as the GUI exports them\n"
+            "  dump                       Prints the driver's state as it reports it\n");
+}
+
+// Imports the config and prepares it the way the GUI does before applying it. Returns false (with the reason printed)
+// if it can't be applied.
+static bool LoadConfig(const char *path, Parameters &params) {
+    static char lut_data[MAX_LUT_BUF_LEN];
+
+    // Never rewrite the user's file from here
+    if (!ConfigHelper::ImportFile(path, lut_data, params, false)) {
+        fprintf(stderr, "%s: Could not import the config\n", path);
+        return false;
+    }
+
+    if (params.accelMode == AccelMode_CustomCurve) {
+        params.customCurve.ApplyCurveConstraints();
+        params.LUT_size = params.customCurve.ExportCurveToLUT(params.LUT_data_x, params.LUT_data_y);
+        params.customCurve.UpdateLUT();
+    }
+
+    if ((params.accelMode == AccelMode_Lut || params.accelMode == AccelMode_CustomCurve) && params.LUT_size == 0) {
+        fprintf(stderr, "%s: The LUT is empty\n", path);
+        return false;
+    }
+
+    // The same check that enables the GUI's Apply button (PLOT_X_RANGE is never rescaled here, so it's the base range)
+    CachedFunction function(static_cast<float>(PLOT_X_RANGE / params.preScale) / PLOT_POINTS, &params);
+    function.PreCacheFunc();
+    if (!function.isValid) {
+        fprintf(stderr, "%s: Invalid parameters (the curve isn't finite over the input range)\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// The writes that apply the config, into the given slot if it's not negative
+static bool CompileConfig(const char *path, int slot, std::vector<DriverHelper::ParameterWrite> &writes) {
+    Parameters params;
+    if (!LoadConfig(path, params))
+        return false;
+
+    if (!params.BuildWrites(writes)) {
+        fprintf(stderr, "%s: Could not encode the LUT / custom curve\n", path);
+        return false;
+    }
+
+    if (slot >= 0) {
+        // The custom curve is kept once, for the GUI, not per slot: writing it would replace the active profile's
+        writes.erase(std::remove_if(writes.begin(), writes.end(), [](const DriverHelper::ParameterWrite &write) {
+            return write.param_name != "profile";
+        }), writes.end());
+
+        std::string &profile = writes.back().value;
+        profile = "Slot=" + std::to_string(slot) + "\n" + profile;
+        if (profile.size() > MAX_PROFILE_LEN) {
+            fprintf(stderr, "%s: The profile is too long to write along with the slot\n", path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int Validate(int argc, char **argv) {
+    if (argc < 1) {
+        PrintUsage();
+        return 2;
+    }
+
+    int res = 0;
+    for (int i = 0; i < argc; i++) {
+        Parameters params;
+        if (LoadConfig(argv[i], params))
+            printf("%s: OK (%s)\n", argv[i], AccelMode2String(params.accelMode).c_str());
+        else
+            res = 1;
+    }
+    return res;
+}
+
+static int Compile(int argc, char **argv) {
+    if (argc != 1) {
+        PrintUsage();
+        return 2;
+    }
+
+    std::vector<DriverHelper::ParameterWrite> writes;
+    if (!CompileConfig(argv[0], -1, writes))
+        return 1;
+
+    for (const auto &write: writes)
+        printf("# %s\n%s\n", write.param_name.c_str(), write.value.c_str());
+    return 0;
+}
+
+static int Apply(int argc, char **argv) {
+    const char *path = nullptr;
+    int slot = -1;
+
+    for (int i = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            char *end;
+            long value = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || value < 0 || value >= PROFILE_SLOTS) {
+                fprintf(stderr, "Invalid slot '%s', there are %d of them (0-%d)\n", argv[i], PROFILE_SLOTS,
+                        PROFILE_SLOTS - 1);
+                return 2;
+            }
+            slot = static_cast<int>(value);
+        }
+        else if (!path)
+            path = argv[i];
+        else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (!path) {
+        PrintUsage();
+        return 2;
+    }
+
+    if (!DriverHelper::ValidateDirectory()) {
+        fprintf(stderr, "YeetMouse directory doesn't exist, is the driver loaded?\n");
+        return 1;
+    }
+
+    std::vector<DriverHelper::ParameterWrite> writes;
+    if (!CompileConfig(path, slot, writes))
+        return 1;
+
+    // The errors of the failed writes get printed along the way
+    if (!DriverHelper::WriteParameters(writes)) {
+        fprintf(stderr, "%s: Could not apply the config (see dmesg)\n", path);
+        return 1;
+    }
+    return 0;
+}
+
+static int Export(int argc, char **argv) {
+    bool config_h = argc == 1 && strcmp(argv[0], "--config-h") == 0;
+    if (argc > 1 || (argc == 1 && !config_h)) {
+        PrintUsage();
+        return 2;
+    }
+
+    Parameters params;
+    std::string lut_text, custom_curve_text;
+    if (!DriverHelper::ReadDriverState(params, lut_text, custom_curve_text)) {
+        fprintf(stderr, "Could not read the driver's profile, is the driver loaded?\n");
+        return 1;
+    }
+    if (!custom_curve_text.empty())
+        params.customCurve.ImportCustomCurve(custom_curve_text);
+    params.use_anisotropy = params.sensY != params.sens;
+
+    std::string exported = config_h ? ConfigHelper::ExportConfig(params, false)
+                                    : ConfigHelper::ExportPlainText(params, false);
+    fputs(exported.c_str(), stdout);
+    return exported.empty() ? 1 : 0;
+}
+
+static int Dump() {
+    std::string profile;
+    if (!DriverHelper::GetParameterS("profile", profile)) {
+        fprintf(stderr, "Could not read the driver's profile, is the driver loaded?\n");
+        return 1;
+    }
+
+    fputs(profile.c_str(), stdout);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        PrintUsage();
+        return 2;
+    }
+
+    const char *command = argv[1];
+    if (strcmp(command, "validate") == 0)
+        return Validate(argc - 2, argv + 2);
+    if (strcmp(command, "compile") == 0)
+        return Compile(argc - 2, argv + 2);
+    if (strcmp(command, "apply") == 0)
+        return Apply(argc - 2, argv + 2);
+    if (strcmp(command, "export") == 0)
+        return Export(argc - 2, argv + 2);
+    if (strcmp(command, "dump") == 0 && argc == 2)
+        return Dump();
+
+    PrintUsage();
+    return 2;
+}
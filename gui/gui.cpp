@@ -1,6 +1,9 @@
 #include "gui.h"
 #include "fonts.h"
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <thread>
 #define GL_SILENCE_DEPRECATION
 #if defined(IMGUI_IMPL_OPENGL_ES2)
 #include <GLES2/gl2.h>
@@ -19,6 +22,25 @@
 int (*MainOnGui)();
 int RenderFrame();
 
+static std::atomic<bool> redraw_requested{false};
+static double last_activity = 0; // glfwGetTime() of the last input event
+static double last_frame = 0;
+
+// Every input event, chained in front of ImGui's callbacks (which call whatever was installed before them)
+static void OnActivity() {
+    last_activity = glfwGetTime();
+}
+
+static void ActivityCursorPosCallback(GLFWwindow *, double, double) { OnActivity(); }
+static void ActivityMouseButtonCallback(GLFWwindow *, int, int, int) { OnActivity(); }
+static void ActivityScrollCallback(GLFWwindow *, double, double) { OnActivity(); }
+static void ActivityKeyCallback(GLFWwindow *, int, int, int, int) { OnActivity(); }
+static void ActivityCharCallback(GLFWwindow *, unsigned int) { OnActivity(); }
+static void ActivityWindowFocusCallback(GLFWwindow *, int) { OnActivity(); }
+static void ActivityCursorEnterCallback(GLFWwindow *, int) { OnActivity(); }
+static void ActivityWindowSizeCallback(GLFWwindow *, int, int) { OnActivity(); }
+static void ActivityWindowRefreshCallback(GLFWwindow *) { OnActivity(); }
+
 static void glfw_error_callback(int error, const char* description)
 {
     fprintf(stderr, "GLFW Error %d: %s\n", error, description);
@@ -169,6 +191,17 @@ int GUI::Setup(int (*OnGui)())
     ImGui::StyleColorsDark();
     //ImGui::StyleColorsLight();
 
+    // Before ImGui's, so that it chains them
+    glfwSetCursorPosCallback(window, ActivityCursorPosCallback);
+    glfwSetMouseButtonCallback(window, ActivityMouseButtonCallback);
+    glfwSetScrollCallback(window, ActivityScrollCallback);
+    glfwSetKeyCallback(window, ActivityKeyCallback);
+    glfwSetCharCallback(window, ActivityCharCallback);
+    glfwSetWindowFocusCallback(window, ActivityWindowFocusCallback);
+    glfwSetCursorEnterCallback(window, ActivityCursorEnterCallback);
+    glfwSetWindowSizeCallback(window, ActivityWindowSizeCallback);
+    glfwSetWindowRefreshCallback(window, ActivityWindowRefreshCallback);
+
     // Setup Platform/Renderer backends
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
@@ -205,6 +238,12 @@ void GUI::GetMousePos(double *x, double *y) {
     glfwGetCursorPos(window, x, y);
 }
 
+void GUI::RequestRedraw() {
+    redraw_requested = true;
+    if (window)
+        glfwPostEmptyEvent(); // Wakes up glfwWaitEventsTimeout()
+}
+
 void GUI::ShutDown() {
     // Cleanup
     ImGui_ImplOpenGL3_Shutdown();
@@ -225,7 +264,24 @@ int GUI::RenderFrame() {
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
     // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
     // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-    glfwPollEvents();
+    const RenderPolicy &policy = render_policy;
+
+    // Frame budget
+    if (policy.max_fps > 0) {
+        double left = last_frame + 1 / policy.max_fps - glfwGetTime();
+        if (left > 0)
+            std::this_thread::sleep_for(std::chrono::duration<double>(left));
+    }
+
+    // Nothing happened lately, sleep until something does (an input event, RequestRedraw()) or it's time to refresh
+    if (policy.on_demand && !redraw_requested.exchange(false) && glfwGetTime() - last_activity > policy.linger_s) {
+        if (policy.idle_refresh_hz > 0)
+            glfwWaitEventsTimeout(1 / policy.idle_refresh_hz);
+        else
+            glfwWaitEvents();
+    } else
+        glfwPollEvents();
+    last_frame = glfwGetTime();
 
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
@@ -5,10 +5,24 @@
 
 namespace GUI
 {
+    /// When RenderFrame() draws. By default only on input, on RequestRedraw() and at a low rate otherwise.
+    struct RenderPolicy {
+        bool on_demand = true; // Otherwise every frame, at the display's refresh rate
+        float idle_refresh_hz = 10; // Redraws when nothing happens (the live mouse speed), 0 - none
+        float max_fps = 0; // Frame cap while active, 0 - just vsync
+        float linger_s = 0.25f; // Keeps drawing for a while after the last input (hover states, animations)
+    };
+
+    inline RenderPolicy render_policy;
+
 	int Setup(int (*OnGui)());
+    /// Waits for something to draw (see RenderPolicy) and draws a frame
     int RenderFrame();
     void ShutDown();
 
+    /// Something changed outside of the input events (e.g. new curves), draws a frame as soon as it can. Thread safe.
+    void RequestRedraw();
+
     void SetWindowSize(int x, int y);
 
     inline GLFWwindow* window;
@@ -6,7 +6,9 @@
 #include "FunctionHelper.h"
 #include "ImGuiExtensions.h"
 #include "ConfigHelper.h"
+#include "CurveWorker.h"
 #include <chrono>
+#include <cstring>
 #include <vector>
 #include <unistd.h>
 
@@ -34,13 +36,73 @@ static_assert(sizeof(AccelModes) / sizeof(char *) == AccelMode_Count);
 
 Parameters params[NUM_MODES]; // Driver parameters for each mode
 CachedFunction functions[NUM_MODES]; // Driver parameters for each mode
+CurveWorker curve_worker(functions, NUM_MODES); // Recomputes the functions above in the background (but the 0th)
 AccelMode used_mode = AccelMode_Linear;
 bool was_initialized = false;
 bool has_privilege = false;
 
 static char LUT_user_data[MAX_LUT_BUF_LEN];
 
+// The modes get computed once they're first shown (selected or hovered), not all of them right at the start
+static bool mode_shown[NUM_MODES] = {true};
+
+// MarkDirty() for the shown modes, the rest just keeps the stride for when they're shown
+static void MarkModeDirty(int mode, float x_stride = 0) {
+    if (mode_shown[mode])
+        curve_worker.MarkDirty(mode, x_stride);
+    else if (x_stride > 0)
+        functions[mode].x_stride = x_stride;
+}
+
+// Returns true if the mode is shown for the first time (and only now gets computed)
+static bool ShowMode(int mode) {
+    if (mode < 0 || mode_shown[mode])
+        return false;
+
+    mode_shown[mode] = true;
+    curve_worker.MarkDirty(mode, functions[mode].x_stride);
+    return true;
+}
+
+// While the custom curve is dragged only its tessellation follows (see CustomCurve::UpdateLUT()), the LUT export and
+// the recompute wait for the mouse to be released
+static bool curve_export_pending = false;
+
+static void EditCustomCurve() {
+    params[AccelMode_CustomCurve].customCurve.ApplyCurveConstraints();
+    params[AccelMode_CustomCurve].customCurve.UpdateLUT();
+    curve_export_pending = true;
+}
+
+// The error is computed once per export, it's too slow for every frame
+static void ExportCurveLUT(Parameters &curve_params) {
+    curve_params.LUT_size = curve_params.customCurve.ExportCurveToLUT(curve_params.LUT_data_x, curve_params.LUT_data_y);
+    curve_params.LUT_error = curve_params.customCurve.LUTError(curve_params.LUT_data_x, curve_params.LUT_data_y,
+                                                               curve_params.LUT_size);
+}
+
+static void ExportCustomCurve() {
+    ExportCurveLUT(params[AccelMode_CustomCurve]);
+    MarkModeDirty(AccelMode_CustomCurve);
+    curve_export_pending = false;
+}
+
+// Mode whose parameters are being applied: the writes go out once the worker has validated them (see OnGui()), so that
+// Apply never waits for a recompute on the render thread
+static int applying_mode = -1;
+
 void ResetParameters();
+bool CacheDriverCurve(CachedFunction &function);
+
+// The adaptive samples of the visible range if there are any yet, the uniformly sampled values otherwise
+static void PlotFunction(const char *label, const CachedFunction &function, bool y_axis = false) {
+    const PlotSamples &samples = function.samples;
+    if (!samples.x.empty())
+        ImPlot::PlotLine(label, samples.x.data(), y_axis ? samples.y_aniso.data() : samples.y.data(),
+                         static_cast<int>(samples.x.size()));
+    else
+        ImPlot::PlotLine(label, y_axis ? function.values_y : function.values, PLOT_POINTS, function.x_stride);
+}
 
 #define RefreshDevices() {devices = DriverHelper::DiscoverDevices(); \
                             if(selected_device >= devices.size())    \
@@ -52,9 +114,54 @@ int OnGui() {
     ImGuiContext &g = *GImGui;
 
     static float mouse_smooth = 0.75;
-    static steady_clock::time_point last_apply_clicked;
     static bool show_custom_curve_control_points = true, move_control_points_along = false, show_custom_curve_LUT_points
             = false;
+    static int last_hovered_mode = -1;
+
+    if (curve_export_pending && !ImGui::IsMouseDown(ImGuiMouseButton_Left))
+        ExportCustomCurve();
+
+    // Whatever got recomputed since the last frame
+    curve_worker.SetPriority({selected_mode, last_hovered_mode});
+    // Don't show a newly selected mode empty
+    if (ShowMode(selected_mode))
+        curve_worker.Finish(selected_mode);
+    // Checked before publishing, so that the published result is the one of the parameters being applied
+    bool apply_ready = applying_mode >= 0 && !curve_worker.IsPending(applying_mode);
+    curve_worker.Publish();
+
+    // Applying happens in the background, the failed writes are shown until the next apply
+    static std::string apply_errors;
+    std::vector<DriverHelper::ParameterWrite> written;
+    if (DriverHelper::TakeWriteResults(written)) {
+        apply_errors.clear();
+        bool profile_written = false;
+        for (const auto &write: written) {
+            if (write.error)
+                apply_errors += "Could not write " + write.param_name + " (" + strerror(write.error) + ")\n";
+            else if (write.param_name == "profile")
+                profile_written = true;
+        }
+        // "Function in use" is the driver's curve again, not the GUI's float approximation of it
+        if (profile_written)
+            CacheDriverCurve(functions[0]);
+    }
+
+    if (apply_ready) {
+        std::vector<DriverHelper::ParameterWrite> writes;
+        if (!params[applying_mode].BuildWrites(writes))
+            apply_errors = "Could not encode the LUT / custom curve\n";
+        else if (!functions[applying_mode].isValid)
+            apply_errors = "Invalid parameters\n";
+        else {
+            DriverHelper::QueueWrites(std::move(writes));
+            functions[0] = functions[applying_mode];
+            params[0] = params[applying_mode];
+            functions[0].params = &params[0];
+            used_mode = static_cast<AccelMode>(applying_mode);
+        }
+        applying_mode = -1;
+    }
 
     if (ImGui::BeginMainMenuBar()) {
         if (ImGui::BeginMenu("File")) {
@@ -98,10 +205,15 @@ int OnGui() {
 
             ImGui::SetItemTooltip("Right click to import from clipboard");
             if (ImGui::IsItemClicked(ImGuiMouseButton_Right)) {
-                if (ConfigHelper::ImportClipboard(LUT_user_data, ImGui::GetClipboardText(), imported_params)) {
+                std::string updated;
+                if (ConfigHelper::ImportClipboard(LUT_user_data, ImGui::GetClipboardText(), imported_params,
+                                                  &updated)) {
                     changed = true;
                     ImGui::CloseCurrentPopup();
                 }
+                // It was in an old format, put it back in the current one
+                if (!updated.empty())
+                    ImGui::SetClipboardText(updated.c_str());
             }
 
             if (changed) {
@@ -113,22 +225,33 @@ int OnGui() {
                         if (imported_params.customCurve.points.size() <= 1)
                             params[i].customCurve = curve;
 
-                        params[i].LUT_size = params[i].customCurve.ExportCurveToLUT(
-                            params[i].LUT_data_x, params[i].LUT_data_y);
+                        ExportCurveLUT(params[i]);
                         params[i].customCurve.ApplyCurveConstraints();
                         params[i].customCurve.UpdateLUT();
                     } else
                         params[i] = imported_params;
 
                     params[i].accelMode = static_cast<AccelMode>(i == 0 ? used_mode : i);
-                    functions[i] = CachedFunction(((float) PLOT_X_RANGE) / PLOT_POINTS, &params[i]);
-                    functions[i].PreCacheFunc();
+                    MarkModeDirty(i, ((float) PLOT_X_RANGE) / PLOT_POINTS);
                 }
 
                 selected_mode = imported_params.accelMode;
             }
             ImGui::EndMenu();
         }
+        if (ImGui::BeginMenu("View")) {
+            GUI::RenderPolicy &policy = GUI::render_policy;
+            ImGui::MenuItem("Redraw only on changes", nullptr, &policy.on_demand);
+            ImGui::SetItemTooltip("Sleeps while nothing changes, instead of drawing at the display's refresh rate");
+
+            ImGui::BeginDisabled(!policy.on_demand);
+            ImGui::SliderFloat("##IdleRefresh", &policy.idle_refresh_hz, 0, 60, "Idle refresh %.0f Hz");
+            ImGui::SetItemTooltip("How often the mouse speed dots get updated when nothing else changes (0 - never)");
+            ImGui::EndDisabled();
+
+            ImGui::SliderFloat("##MaxFps", &policy.max_fps, 0, 240, policy.max_fps > 0 ? "Frame cap %.0f FPS" : "No frame cap");
+            ImGui::EndMenu();
+        }
         ImGui::EndMainMenuBar();
     }
 
@@ -146,8 +269,10 @@ int OnGui() {
             const char *accel = AccelModes[i];
             if (ImGui::ModeSelectable(accel, i == selected_mode, 0, {-1, 0}))
                 selected_mode = static_cast<AccelMode>(i);
-            if (ImGui::IsItemHovered())
+            if (ImGui::IsItemHovered()) {
                 hovered_mode = i;
+                ShowMode(i);
+            }
         }
     } else
         ImGui::PopStyleColor();
@@ -196,10 +321,8 @@ int OnGui() {
 #endif
         if (pre_scale_change) {
             PLOT_X_RANGE = 150 / params[selected_mode].preScale;
-            for (int i = 1; i < NUM_MODES; i++) {
-                functions[i] = CachedFunction(((float) PLOT_X_RANGE) / PLOT_POINTS, &params[i]);
-                functions[i].PreCacheFunc();
-            }
+            for (int i = 1; i < NUM_MODES; i++)
+                MarkModeDirty(i, ((float) PLOT_X_RANGE) / PLOT_POINTS);
             change |= pre_scale_change;
         }
         if (ImGui::IsItemHovered(ImGuiHoveredFlags_ForTooltip) && ImGui::BeginTooltip()) {
@@ -471,12 +594,23 @@ int OnGui() {
                 ImGui::SeparatorText("LUT Export");
                 ImGui::Checkbox("Show LUT Points", &show_custom_curve_LUT_points);
 
-                if (change) {
-                    params[selected_mode].customCurve.ApplyCurveConstraints();
-                    params[selected_mode].LUT_size = params[selected_mode].customCurve.ExportCurveToLUT(
-                        params[selected_mode].LUT_data_x, params[selected_mode].LUT_data_y);
-                    params[selected_mode].customCurve.UpdateLUT();
+                auto &curve = params[selected_mode].customCurve;
+                bool min_error = curve.LUT_placement == LUTPlacement_MinError;
+                if (ImGui::Checkbox("Minimize the error", &min_error)) {
+                    curve.LUT_placement = min_error ? LUTPlacement_MinError : LUTPlacement_Adaptive;
+                    change = true;
+                }
+                ImGui::SetItemTooltip("Places the points where the driver's interpolation strays from the curve the most");
+                if (min_error) {
+                    change |= ImGui::SliderFloat("##LUT_target_error", &curve.LUT_target_error, 0, 0.05,
+                                                 curve.LUT_target_error > 0 ? "Target Error %0.4f" : "Target Error: Lowest",
+                                                 ImGuiSliderFlags_Logarithmic);
+                    ImGui::SetItemTooltip("Fewer points if they're enough for this error (0 - as low as all the points get)");
                 }
+                ImGui::Text("%d points, max error %.5f", params[selected_mode].LUT_size, params[selected_mode].LUT_error);
+
+                if (change)
+                    EditCustomCurve();
 
                 break;
             }
@@ -498,7 +632,7 @@ int OnGui() {
             ImGui::SetItemTooltip("Rotation is applied after Angle Snapping");
 
         if (change)
-            functions[selected_mode].PreCacheFunc();
+            curve_worker.MarkDirty(selected_mode);
 
         ImGui::PopItemWidth();
     } else
@@ -567,6 +701,10 @@ int OnGui() {
     if (duration_cast<milliseconds>(steady_clock::now() - last_time_speed_record_broken).count() > 1000)
         recent_mouse_top_speed = 0;
 
+    // The dots are moving (or the mouse is, even outside the window), keep drawing until they settle
+    if (avg_speed > 0.02 || recent_mouse_top_speed > 0)
+        GUI::RequestRedraw();
+
     ImPlotPoint mousePoint_topSpeed = ImPlotPoint(recent_mouse_top_speed,
                                                   functions[selected_mode].EvaluateFuncWithGlobalParameters(
                                                       recent_mouse_top_speed));
@@ -577,6 +715,10 @@ int OnGui() {
         ImPlot::SetupAxis(ImAxis_X1, "Input Speed [counts / ms]");
         ImPlot::SetupAxis(ImAxis_Y1, "Output / Input Speed Ratio");
 
+        // Sampled for the next frames (see CurveWorker::SetPlotRange())
+        ImPlotRect limits = ImPlot::GetPlotLimits();
+        curve_worker.SetPlotRange(limits.X.Min, limits.X.Max);
+
         // Display currently applied parameters in the background
         if (was_initialized) {
             ImPlot::SetNextLineStyle(ImVec4(0.3, 0.3, 0.3, 1));
@@ -852,13 +994,8 @@ int OnGui() {
                 modified = true;
             }
 
-            if (modified) {
-                params[selected_mode].customCurve.ApplyCurveConstraints();
-                params[selected_mode].LUT_size = params[selected_mode].customCurve.ExportCurveToLUT(
-                    params[selected_mode].LUT_data_x, params[selected_mode].LUT_data_y);
-                params[selected_mode].customCurve.UpdateLUT();
-                functions[selected_mode].PreCacheFunc();
-            }
+            if (modified)
+                EditCustomCurve();
 
             // Draw the curve
             if (points.size() > 1) {
@@ -878,12 +1015,10 @@ int OnGui() {
 
                     if (params[selected_mode].use_anisotropy) {
                         ImPlot::SetNextLineStyle(ImVec4(0.3, 0.3, 0.8, 1), 1);
-                        ImPlot::PlotLine("Active Mode Y##ActivePlotY", functions[selected_mode].values_y, PLOT_POINTS,
-                                         functions[selected_mode].x_stride);
+                        PlotFunction("Active Mode Y##ActivePlotY", functions[selected_mode], true);
                     }
 
-                    ImPlot::PlotLine("##ActivePlot", functions[selected_mode].values, PLOT_POINTS,
-                                     functions[selected_mode].x_stride);
+                    PlotFunction("##ActivePlot", functions[selected_mode]);
                 }
             }
 
@@ -894,12 +1029,10 @@ int OnGui() {
         } else {
             if (params[selected_mode].use_anisotropy) {
                 ImPlot::SetNextLineStyle(ImVec4(0.3, 0.3, 0.8, 1), 2);
-                ImPlot::PlotLine("Active Mode Y##ActivePlotY", functions[selected_mode].values_y, PLOT_POINTS,
-                                 functions[selected_mode].x_stride);
+                PlotFunction("Active Mode Y##ActivePlotY", functions[selected_mode], true);
             }
 
-            ImPlot::PlotLine("##ActivePlot", functions[selected_mode].values, PLOT_POINTS,
-                             functions[selected_mode].x_stride);
+            PlotFunction("##ActivePlot", functions[selected_mode]);
         }
 
         ImPlot::PlotScatterG("Mouse Speed", [](int idx, void *data) { return *(ImPlotPoint *) data; }, &mousePoint_main,
@@ -912,14 +1045,15 @@ int OnGui() {
 
         ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 2);
 
-        if (hovered_mode != -1 && selected_mode != hovered_mode) {
+        // Not until it's computed for the first time
+        if (hovered_mode != -1 && selected_mode != hovered_mode && !curve_worker.IsPending(hovered_mode)) {
             ImPlot::SetNextLineStyle(ImVec4(0.7, 0.7, 0.3, 1));
-            ImPlot::PlotLine("##Hovered Function", functions[hovered_mode].values, PLOT_POINTS,
-                             functions[hovered_mode].x_stride);
+            PlotFunction("##Hovered Function", functions[hovered_mode]);
         }
 
         ImPlot::EndPlot();
     }
+    last_hovered_mode = hovered_mode;
 
     /* ---------------------------- BOTTOM BUTTONS ---------------------------- */
     ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.1f, 0.1f, 0.1f, 1.0f));
@@ -940,18 +1074,16 @@ int OnGui() {
 
         ImGui::SameLine();
 
-        // Disable Apply button for 1.1 second after clicking it (this is a driver "limitation")
         ImGui::BeginDisabled(!has_privilege || !was_initialized ||
-                             duration_cast<milliseconds>(steady_clock::now() - last_apply_clicked).count() < 1100 ||
                              (selected_mode == AccelMode_Lut /* LUT */ && params[selected_mode].LUT_size == 0) ||
                              !functions[selected_mode].isValid);
 
         if (ImGui::Button("Apply", {-1, -1})) {
-            params[selected_mode].SaveAll();
-            functions[0] = functions[selected_mode];
-            params[0] = params[selected_mode];
-            used_mode = selected_mode;
-            last_apply_clicked = steady_clock::now();
+            if (curve_export_pending)
+                ExportCustomCurve();
+            // The parameters may have changed since what's shown was computed, they're written once it catches up
+            applying_mode = selected_mode;
+            GUI::RequestRedraw();
         }
 
         ImGui::EndDisabled();
@@ -978,11 +1110,36 @@ int OnGui() {
                                                 ImColor::HSV(0.975, 0.9, 1).operator ImU32(),
                                                 "Could not read and initialize driver parameters, working on dummy data");
 
+    if (!apply_errors.empty())
+        ImGui::GetForegroundDrawList()->AddText(ImVec2(10, 75),
+                                                ImColor::HSV(0.975, 0.9, 1).operator ImU32(),
+                                                apply_errors.c_str());
+
     return 0;
 }
 
 Parameters start_params;
 
+// Replaces the cached values with the curve evaluated by the driver itself (the applied parameters).
+// Returns false and keeps the values untouched if the driver can't be queried.
+bool CacheDriverCurve(CachedFunction &function) {
+    double speeds[PLOT_POINTS];
+    double mults[PLOT_POINTS];
+
+    for (int i = 0; i < PLOT_POINTS; i++)
+        speeds[i] = FUNC_EVAL_START_VAL + i * function.x_stride;
+
+    if (!DriverHelper::EvaluateDriverCurve(speeds, mults, PLOT_POINTS))
+        return false;
+
+    for (int i = 0; i < PLOT_POINTS; i++) {
+        function.values[i] = static_cast<float>(mults[i]);
+        function.values_y[i] = function.values[i] * function.params->sensY;
+    }
+
+    return true;
+}
+
 void ResetParameters(void) {
     for (int mode = 0; mode < NUM_MODES; mode++) {
         params[mode] = start_params;
@@ -1012,8 +1169,7 @@ void ResetParameters(void) {
 
         if (mode == AccelMode_CustomCurve) {
             params->customCurve.ApplyCurveConstraints();
-            params[mode].LUT_size = params[mode].customCurve.ExportCurveToLUT(
-                params[mode].LUT_data_x, params[mode].LUT_data_y);
+            ExportCurveLUT(params[mode]);
             params[mode].customCurve.UpdateLUT();
         }
 
@@ -1021,14 +1177,28 @@ void ResetParameters(void) {
         //printf("stride = %f\n", functions[mode].x_stride);
         bool old_use_ani = functions[mode].params->use_anisotropy;
         functions[mode].params->use_anisotropy = true;
-        functions[mode].PreCacheFunc();
+        // The one in use is needed right away (the mouse speed indicator), the rest is left to the worker (once shown)
+        if (mode == 0)
+            functions[mode].PreCacheFunc();
+        else
+            MarkModeDirty(mode, functions[mode].x_stride);
         functions[mode].params->use_anisotropy = old_use_ani;
     }
+
+    // Plot the applied curve exactly as the driver computes it, if it lets us
+    CacheDriverCurve(functions[0]);
+
+    // Don't show the first frames empty
+    curve_worker.SetPriority({selected_mode});
+    ShowMode(selected_mode);
+    curve_worker.Finish(selected_mode);
 }
 
 int main() {
     GUI::Setup(OnGui);
     ImPlot::CreateContext();
+    curve_worker.SetNotify(GUI::RequestRedraw);
+    DriverHelper::SetWriteNotify(GUI::RequestRedraw);
 
     ImGui::GetIO().IniFilename = nullptr;
 
@@ -1046,12 +1216,12 @@ int main() {
         return 2;
     }
 
-    int fixed_num = 0;
-    if (!DriverHelper::CleanParameters(fixed_num) && fixed_num != 0 && !has_privilege) {
-        fprintf(stderr, "Could not setup driver params\n");
-    } else {
+    // Nothing gets written to the driver here, the parameters are only read (in one go if the driver can)
+    std::string Lut_dataBuf, custom_curve_data;
+    bool loaded = DriverHelper::ReadDriverState(start_params, Lut_dataBuf, custom_curve_data);
+    if (!loaded) {
         // Read driver parameters to a dummy aggregate
-        DriverHelper::GetParameterF("Sensitivity", start_params.sens);
+        loaded = DriverHelper::GetParameterF("Sensitivity", start_params.sens);
         DriverHelper::GetParameterF("SensitivityY", start_params.sensY);
         DriverHelper::GetParameterF("OutputCap", start_params.outCap);
         DriverHelper::GetParameterF("InputCap", start_params.inCap);
@@ -1071,16 +1241,20 @@ int main() {
         DriverHelper::GetParameterF("AngleSnap_Angle", start_params.as_angle);
         start_params.as_angle /= DEG2RAD;
         //DriverHelper::GetParameterF("LutStride", start_params.LUT_stride);
-        std::string Lut_dataBuf;
         DriverHelper::GetParameterS("LutDataBuf", Lut_dataBuf);
-        Lut_dataBuf.copy(LUT_user_data, sizeof(LUT_user_data), 0);
         DriverHelper::ParseDriverLutData(Lut_dataBuf.c_str(), start_params.LUT_data_x, start_params.LUT_data_y);
+        DriverHelper::GetParameterS("_CustomCurveDataAggregate", custom_curve_data);
+    }
+
+    if (!loaded) {
+        fprintf(stderr, "Could not read driver params\n");
+    } else {
+        Lut_dataBuf.copy(LUT_user_data, sizeof(LUT_user_data) - 1, 0);
 
         // Load custom curve data
-        Lut_dataBuf.clear();
-        if (DriverHelper::GetParameterS("_CustomCurveDataAggregate", Lut_dataBuf)) {
+        if (!custom_curve_data.empty()) {
             CustomCurve dummy_curve;
-            if (!dummy_curve.ImportCustomCurve(Lut_dataBuf) && start_params.accelMode == AccelMode_CustomCurve) {
+            if (!dummy_curve.ImportCustomCurve(custom_curve_data) && start_params.accelMode == AccelMode_CustomCurve) {
                 fprintf(stderr, "Could not load custom curve data\n");
                 start_params.accelMode = AccelMode_Lut;
             }
@@ -1108,6 +1282,9 @@ int main() {
             break;
     }
 
+    curve_worker.SetNotify(nullptr);
+    DriverHelper::SetWriteNotify(nullptr);
+    DriverHelper::FlushWrites();
     GUI::ShutDown();
 
     return 0;
@@ -0,0 +1,135 @@
+// Generates fixed_profile.h for the fixed profile build of the driver ('make driver_fixed'): the profile in config.h,
+// validated and compiled (update_constants()) by the driver's own code, written out as a constant initializer.
+// The module built with it has every parameter, the mode and all the constants (tables included) known at compile
+// time, so the compiler can fold them into the code of accelerate().
+//
+// accel.c is included for its (static) profile handling, the profile is the one loading the module would build.
+//
+// Usage: gen_fixed_profile [output.h]   (stdout by default)
+
+#include <stdio.h>
+
+#include "yeetaccel.h"
+#include "../driver/accel.c"
+
+static FILE *out;
+
+static void PrintFixed(const char *indent, const char *name, FP_LONG value)
+{
+    // The most negative value has no literal
+    if (value == INT64_MIN)
+        fprintf(out, "%s.%s = (-9223372036854775807ll - 1),\n", indent, name);
+    else
+        fprintf(out, "%s.%s = %lldll, // %.6f\n", indent, name, (long long)value, FP64_ToDouble(value));
+}
+
+// Only up to the last non-zero element, the rest is zero anyway
+static void PrintArray(const char *indent, const char *name, const FP_LONG *values, size_t count)
+{
+    size_t i, used = count;
+
+    while (used > 0 && values[used - 1] == 0)
+        used--;
+    if (used == 0)
+        return;
+
+    fprintf(out, "%s.%s = {", indent, name);
+    for (i = 0; i < used; i++)
+        fprintf(out, "%s%lldll,", i % 4 == 0 ? "\n    " : " ", (long long)values[i]);
+    fprintf(out, "\n%s},\n", indent);
+}
+
+#define FIXED(name) PrintFixed("    ", #name, profile->name)
+#define CONST_FIXED(name) PrintFixed("        ", #name, consts->name)
+#define CONST_BOOL(name) fprintf(out, "        .%s = %d,\n", #name, consts->name)
+#define CONST_INT(name) fprintf(out, "        .%s = %d,\n", #name, (int)consts->name)
+
+int main(int argc, char **argv)
+{
+    const struct accel_profile *profile;
+    const struct ModesConstants *consts;
+
+    out = argc > 1 ? fopen(argv[1], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Can't create %s\n", argv[1]);
+        return 1;
+    }
+
+    if (yeetaccel_init() != 0 || (profile = accel_profile_dup()) == NULL) {
+        fprintf(stderr, "Can't build the profile from config.h\n");
+        return 1;
+    }
+    consts = &profile->consts;
+
+    // The driver falls back to no acceleration, a fixed build would be stuck with that
+    if (profile->AccelerationMode != ACCELERATION_MODE) {
+        fprintf(stderr, "The profile in config.h is invalid (see the error above)\n");
+        return 1;
+    }
+
+    fprintf(out, "// Generated by lib/gen_fixed_profile from config.h, don't edit ('make driver_fixed' regenerates it).\n");
+    fprintf(out, "// Needs accel_modes.h, see accelerate() in accel.c\n");
+    fprintf(out, "#ifndef FIXED_PROFILE_H\n#define FIXED_PROFILE_H\n\n");
+    fprintf(out, "static const struct accel_profile g_fixed_profile = {\n");
+
+    FIXED(Sensitivity);
+    FIXED(SensitivityY);
+    FIXED(OutputCap);
+    FIXED(InputCap);
+    FIXED(Offset);
+    FIXED(PreScale);
+    FIXED(Acceleration);
+    FIXED(Exponent);
+    FIXED(Midpoint);
+    FIXED(Motivity);
+    FIXED(RotationAngle);
+    FIXED(AngleSnap_Angle);
+    FIXED(AngleSnap_Threshold);
+    fprintf(out, "    .AccelerationMode = %d,\n", profile->AccelerationMode);
+    fprintf(out, "    .UseSmoothing = %d,\n", profile->UseSmoothing);
+    fprintf(out, "    .LutSize = %lu,\n", profile->LutSize);
+    PrintArray("    ", "LutData_x", profile->LutData_x, profile->LutSize);
+    PrintArray("    ", "LutData_y", profile->LutData_y, profile->LutSize);
+
+    fprintf(out, "    .consts = {\n");
+    CONST_BOOL(is_init);
+    CONST_FIXED(accel_sub_1);
+    CONST_FIXED(exp_sub_1);
+    CONST_FIXED(current_func_at_0);
+    CONST_FIXED(logMot);
+    CONST_FIXED(gammaConst);
+    CONST_FIXED(logSync);
+    CONST_FIXED(sharpness);
+    CONST_FIXED(sharpnessRecip);
+    CONST_BOOL(useClamp);
+    CONST_FIXED(minSens);
+    CONST_FIXED(maxSens);
+    CONST_FIXED(sync_x_start);
+    PrintArray("        ", "sync_data", consts->sync_data, SYNC_CAPACITY);
+    CONST_FIXED(sign);
+    CONST_FIXED(gain_constant);
+    CONST_FIXED(cap_x);
+    CONST_FIXED(cap_y);
+    CONST_FIXED(narrow_limit);
+    CONST_INT(narrow_accel);
+    CONST_INT(narrow_speed_shift);
+    CONST_INT(narrow_product_shift);
+    CONST_FIXED(C0);
+    CONST_FIXED(r);
+    CONST_FIXED(offset_x);
+    CONST_FIXED(power_constant);
+    CONST_FIXED(auxiliar_accel);
+    CONST_FIXED(auxiliar_constant);
+    CONST_FIXED(sin_a);
+    CONST_FIXED(cos_a);
+    CONST_FIXED(as_sin);
+    CONST_FIXED(as_cos);
+    CONST_FIXED(as_half_threshold);
+    fprintf(out, "    },\n");
+
+    fprintf(out, "    .version = 1,\n};\n\n#endif // FIXED_PROFILE_H\n");
+
+    kfree(profile);
+    yeetaccel_exit();
+    return fclose(out) == 0 ? 0 : 1;
+}
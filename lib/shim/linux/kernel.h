@@ -0,0 +1,41 @@
+#ifndef YEETACCEL_SHIM_KERNEL_H
+#define YEETACCEL_SHIM_KERNEL_H
+
+#include <linux/types.h>
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define U64_MAX UINT64_MAX
+#define PAGE_SIZE 4096UL
+
+#define likely(x) __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define READ_ONCE(x) (*(const volatile __typeof__(x) *)&(x))
+#define WRITE_ONCE(x, val) (*(volatile __typeof__(x) *)&(x) = (val))
+
+// To stderr, unless silenced with yeetaccel_set_quiet()
+#define printk(...) yeetaccel_printk(__VA_ARGS__)
+int yeetaccel_printk(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+int scnprintf(char *buf, size_t size, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+int kstrtoull(const char *s, unsigned int base, unsigned long long *res);
+int kstrtoul(const char *s, unsigned int base, unsigned long *res);
+int kstrtouint(const char *s, unsigned int base, unsigned int *res);
+int kstrtou8(const char *s, unsigned int base, u8 *res);
+int kstrtobool(const char *s, bool *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETACCEL_SHIM_KERNEL_H
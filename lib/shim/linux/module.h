@@ -0,0 +1,11 @@
+#ifndef YEETACCEL_SHIM_MODULE_H
+#define YEETACCEL_SHIM_MODULE_H
+
+#include <linux/kernel.h>
+#include <linux/moduleparam.h>
+
+#define MODULE_AUTHOR(author) extern int yeetaccel_modinfo
+#define MODULE_DESCRIPTION(desc) extern int yeetaccel_modinfo
+#define MODULE_LICENSE(license) extern int yeetaccel_modinfo
+
+#endif //YEETACCEL_SHIM_MODULE_H
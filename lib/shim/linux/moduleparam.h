@@ -0,0 +1,74 @@
+#ifndef YEETACCEL_SHIM_MODULEPARAM_H
+#define YEETACCEL_SHIM_MODULEPARAM_H
+
+// The module parameters register themselves on startup, they are then set and read by name
+// with yeetaccel_param_set() / yeetaccel_param_get() instead of through sysfs.
+
+#include <linux/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kernel_param;
+
+struct kernel_param_ops {
+    int (*set)(const char *val, const struct kernel_param *kp);
+    int (*get)(char *buffer, const struct kernel_param *kp);
+};
+
+struct kparam_string {
+    unsigned int maxlen;
+    char *string;
+};
+
+struct kernel_param {
+    const char *name;
+    const struct kernel_param_ops *ops;
+    unsigned short perm;
+    union {
+        void *arg;
+        const struct kparam_string *str;
+    };
+    struct kernel_param *next; // Registered parameters
+};
+
+extern const struct kernel_param_ops param_ops_byte;
+extern const struct kernel_param_ops param_ops_ulong;
+extern const struct kernel_param_ops param_ops_charp;
+extern const struct kernel_param_ops param_ops_string;
+
+int param_set_byte(const char *val, const struct kernel_param *kp);
+int param_get_byte(char *buffer, const struct kernel_param *kp);
+int param_set_ulong(const char *val, const struct kernel_param *kp);
+int param_get_ulong(char *buffer, const struct kernel_param *kp);
+int param_set_charp(const char *val, const struct kernel_param *kp);
+int param_get_charp(char *buffer, const struct kernel_param *kp);
+int param_set_copystring(const char *val, const struct kernel_param *kp);
+int param_get_string(char *buffer, const struct kernel_param *kp);
+
+void yeetaccel_register_param(struct kernel_param *kp);
+
+// Ends with the definition of the parameter, so that the ';' after the macro belongs to it
+#define module_param_cb(_name, _ops, _arg, _perm)                                       \
+    static struct kernel_param __param_##_name;                                         \
+    static void __attribute__((constructor)) __param_register_##_name(void)             \
+    {                                                                                   \
+        yeetaccel_register_param(&__param_##_name);                                     \
+    }                                                                                   \
+    static struct kernel_param __param_##_name = { .name = #_name, .ops = (_ops),       \
+                                                   .perm = (_perm), .arg = (void *)(_arg) }
+
+#define module_param_named(_name, value, type, perm) module_param_cb(_name, &param_ops_##type, &(value), perm)
+
+#define module_param_string(_name, string, len, perm)                                   \
+    static const struct kparam_string __param_string_##_name = { len, string };         \
+    module_param_cb(_name, &param_ops_string, &__param_string_##_name, perm)
+
+#define MODULE_PARM_DESC(param, desc) extern int yeetaccel_modinfo
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETACCEL_SHIM_MODULEPARAM_H
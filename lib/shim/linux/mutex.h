@@ -0,0 +1,24 @@
+#ifndef YEETACCEL_SHIM_MUTEX_H
+#define YEETACCEL_SHIM_MUTEX_H
+
+#include <pthread.h>
+
+struct mutex {
+    pthread_mutex_t lock;
+};
+
+#define DEFINE_MUTEX(name) struct mutex name = { PTHREAD_MUTEX_INITIALIZER }
+
+#define lockdep_is_held(m) ((void)(m), 1)
+
+static inline void mutex_lock(struct mutex *m)
+{
+    pthread_mutex_lock(&m->lock);
+}
+
+static inline void mutex_unlock(struct mutex *m)
+{
+    pthread_mutex_unlock(&m->lock);
+}
+
+#endif //YEETACCEL_SHIM_MUTEX_H
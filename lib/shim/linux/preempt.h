@@ -0,0 +1,17 @@
+#ifndef YEETACCEL_SHIM_PREEMPT_H
+#define YEETACCEL_SHIM_PREEMPT_H
+
+#include <sched.h>
+
+// Nothing to disable in userspace, the benchmark just runs where the scheduler puts it
+#define preempt_disable() do { } while (0)
+#define preempt_enable() do { } while (0)
+#define cond_resched() do { } while (0)
+
+#ifdef _GNU_SOURCE
+#define smp_processor_id() sched_getcpu()
+#else
+#define smp_processor_id() 0
+#endif
+
+#endif //YEETACCEL_SHIM_PREEMPT_H
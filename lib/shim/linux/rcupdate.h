@@ -0,0 +1,35 @@
+#ifndef YEETACCEL_SHIM_RCUPDATE_H
+#define YEETACCEL_SHIM_RCUPDATE_H
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Readers hold a shared lock and synchronize_rcu() waits for all of them by taking it exclusively.
+// Way heavier than the real thing, but just as correct, and nothing in userspace runs in an irq.
+extern pthread_rwlock_t yeetaccel_rcu_lock;
+
+#define __rcu
+
+#define rcu_read_lock() pthread_rwlock_rdlock(&yeetaccel_rcu_lock)
+#define rcu_read_unlock() pthread_rwlock_unlock(&yeetaccel_rcu_lock)
+
+#define rcu_dereference(p) __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#define rcu_dereference_protected(p, c) (p)
+#define rcu_access_pointer(p) __atomic_load_n(&(p), __ATOMIC_RELAXED)
+#define rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+#define RCU_INIT_POINTER(p, v) ((p) = (v))
+
+static inline void synchronize_rcu(void)
+{
+    pthread_rwlock_wrlock(&yeetaccel_rcu_lock);
+    pthread_rwlock_unlock(&yeetaccel_rcu_lock);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETACCEL_SHIM_RCUPDATE_H
@@ -0,0 +1,32 @@
+#ifndef YEETACCEL_SHIM_SLAB_H
+#define YEETACCEL_SHIM_SLAB_H
+
+#include <linux/types.h>
+#include <stdlib.h>
+
+#define GFP_KERNEL 0u
+#define GFP_ATOMIC 1u
+
+static inline void *kmalloc(size_t size, gfp_t gfp)
+{
+    return malloc(size);
+}
+
+static inline void *kzalloc(size_t size, gfp_t gfp)
+{
+    return calloc(1, size);
+}
+
+static inline void *kmalloc_array(size_t n, size_t size, gfp_t gfp)
+{
+    if (size != 0 && n > SIZE_MAX / size)
+        return NULL;
+    return malloc(n * size);
+}
+
+static inline void kfree(const void *ptr)
+{
+    free((void *)ptr);
+}
+
+#endif //YEETACCEL_SHIM_SLAB_H
@@ -0,0 +1,18 @@
+#ifndef YEETACCEL_SHIM_STRING_H
+#define YEETACCEL_SHIM_STRING_H
+
+#include <linux/types.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char *strim(char *s);
+char *kstrdup(const char *s, gfp_t gfp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETACCEL_SHIM_STRING_H
@@ -0,0 +1,19 @@
+#ifndef YEETACCEL_SHIM_TIME_H
+#define YEETACCEL_SHIM_TIME_H
+
+#include <linux/types.h>
+#include <time.h>
+
+static inline u64 ktime_get_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline ktime_t ktime_get(void)
+{
+    return (ktime_t)ktime_get_ns();
+}
+
+#endif //YEETACCEL_SHIM_TIME_H
@@ -0,0 +1,23 @@
+#ifndef YEETACCEL_SHIM_TYPES_H
+#define YEETACCEL_SHIM_TYPES_H
+
+// Userspace stand-ins for the kernel APIs used by the driver's acceleration code, see lib/yeetaccel.h
+
+#include_next <linux/types.h> // The uapi one (__u64 and friends), other userspace headers rely on it
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef long long ktime_t;
+typedef unsigned int gfp_t;
+
+#endif //YEETACCEL_SHIM_TYPES_H
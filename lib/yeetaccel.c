@@ -0,0 +1,326 @@
+// Userspace implementation of the kernel APIs the driver's acceleration code uses (see shim/), and the library's API
+
+#include "yeetaccel.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <linux/kernel.h>
+#include <linux/moduleparam.h>
+#include <linux/mutex.h>
+#include <linux/rcupdate.h>
+#include <linux/slab.h>
+#include <linux/string.h>
+
+pthread_rwlock_t yeetaccel_rcu_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static bool quiet;
+
+// ########## Kernel helpers
+
+int yeetaccel_printk(const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    if (quiet)
+        return 0;
+
+    va_start(args, fmt);
+    len = vfprintf(stderr, fmt, args);
+    va_end(args);
+
+    return len;
+}
+
+int scnprintf(char *buf, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    if (size == 0)
+        return 0;
+
+    va_start(args, fmt);
+    len = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+
+    if (len < 0)
+        return 0;
+    return (size_t)len < size ? len : (int)(size - 1);
+}
+
+// Same rules as the kernel: an optional '+', no white space, except for a single trailing new line
+int kstrtoull(const char *s, unsigned int base, unsigned long long *res)
+{
+    unsigned long long value;
+    char *end;
+
+    if (*s == '+')
+        s++;
+    if (!isxdigit((unsigned char)*s))
+        return -EINVAL;
+
+    errno = 0;
+    value = strtoull(s, &end, base);
+    if (errno == ERANGE)
+        return -ERANGE;
+    if (end == s || (*end == '\n' && end[1] != '\0') || (*end != '\n' && *end != '\0'))
+        return -EINVAL;
+
+    *res = value;
+    return 0;
+}
+
+int kstrtoul(const char *s, unsigned int base, unsigned long *res)
+{
+    unsigned long long value;
+    int error = kstrtoull(s, base, &value);
+
+    if (error)
+        return error;
+    if (value > ULONG_MAX)
+        return -ERANGE;
+
+    *res = value;
+    return 0;
+}
+
+int kstrtouint(const char *s, unsigned int base, unsigned int *res)
+{
+    unsigned long long value;
+    int error = kstrtoull(s, base, &value);
+
+    if (error)
+        return error;
+    if (value > UINT_MAX)
+        return -ERANGE;
+
+    *res = value;
+    return 0;
+}
+
+int kstrtou8(const char *s, unsigned int base, u8 *res)
+{
+    unsigned long long value;
+    int error = kstrtoull(s, base, &value);
+
+    if (error)
+        return error;
+    if (value > UINT8_MAX)
+        return -ERANGE;
+
+    *res = value;
+    return 0;
+}
+
+int kstrtobool(const char *s, bool *res)
+{
+    if (!s)
+        return -EINVAL;
+
+    switch (s[0]) {
+        case 'y': case 'Y': case 't': case 'T': case '1':
+            *res = true;
+            return 0;
+        case 'n': case 'N': case 'f': case 'F': case '0':
+            *res = false;
+            return 0;
+        case 'o': case 'O':
+            if (s[1] == 'n' || s[1] == 'N') {
+                *res = true;
+                return 0;
+            }
+            if (s[1] == 'f' || s[1] == 'F') {
+                *res = false;
+                return 0;
+            }
+            break;
+    }
+
+    return -EINVAL;
+}
+
+char *strim(char *s)
+{
+    size_t len;
+
+    while (isspace((unsigned char)*s))
+        s++;
+
+    len = strlen(s);
+    while (len > 0 && isspace((unsigned char)s[len - 1]))
+        len--;
+    s[len] = '\0';
+
+    return s;
+}
+
+char *kstrdup(const char *s, gfp_t gfp)
+{
+    return s ? strdup(s) : NULL;
+}
+
+// ########## Module parameters
+
+static struct kernel_param *params;
+static DEFINE_MUTEX(params_lock); // The kernel serializes the callbacks of a module, so does this
+
+void yeetaccel_register_param(struct kernel_param *kp)
+{
+    kp->next = params;
+    params = kp;
+}
+
+static struct kernel_param *find_param(const char *name)
+{
+    struct kernel_param *kp;
+
+    for (kp = params; kp; kp = kp->next) {
+        if (strcmp(kp->name, name) == 0)
+            return kp;
+    }
+
+    return NULL;
+}
+
+int param_set_byte(const char *val, const struct kernel_param *kp)
+{
+    return kstrtou8(val, 0, kp->arg);
+}
+
+int param_get_byte(char *buffer, const struct kernel_param *kp)
+{
+    return scnprintf(buffer, PAGE_SIZE, "%hhu\n", *(unsigned char *)kp->arg);
+}
+
+int param_set_ulong(const char *val, const struct kernel_param *kp)
+{
+    return kstrtoul(val, 0, kp->arg);
+}
+
+int param_get_ulong(char *buffer, const struct kernel_param *kp)
+{
+    return scnprintf(buffer, PAGE_SIZE, "%lu\n", *(unsigned long *)kp->arg);
+}
+
+// Strings set by param_set_charp(), the initial values are literals and must not be freed (the kernel does the same)
+struct charp_alloc {
+    struct charp_alloc *next;
+    char str[];
+};
+
+static struct charp_alloc *charp_allocs;
+
+static void charp_free(char *str)
+{
+    struct charp_alloc **cur;
+
+    for (cur = &charp_allocs; *cur; cur = &(*cur)->next) {
+        if ((*cur)->str == str) {
+            struct charp_alloc *alloc = *cur;
+            *cur = alloc->next;
+            kfree(alloc);
+            return;
+        }
+    }
+}
+
+int param_set_charp(const char *val, const struct kernel_param *kp)
+{
+    size_t len = strnlen(val, 1024);
+    struct charp_alloc *alloc;
+
+    if (len >= 1024)
+        return -ENOSPC;
+
+    alloc = kmalloc(sizeof(*alloc) + len + 1, GFP_KERNEL);
+    if (!alloc)
+        return -ENOMEM;
+    memcpy(alloc->str, val, len + 1);
+
+    charp_free(*(char **)kp->arg);
+    alloc->next = charp_allocs;
+    charp_allocs = alloc;
+    *(char **)kp->arg = alloc->str;
+
+    return 0;
+}
+
+int param_get_charp(char *buffer, const struct kernel_param *kp)
+{
+    const char *str = *(const char **)kp->arg;
+    return scnprintf(buffer, PAGE_SIZE, "%s\n", str ? str : "(null)");
+}
+
+int param_set_copystring(const char *val, const struct kernel_param *kp)
+{
+    const struct kparam_string *kps = kp->str;
+
+    if (strnlen(val, kps->maxlen) == kps->maxlen)
+        return -ENOSPC;
+
+    strcpy(kps->string, val);
+    return 0;
+}
+
+int param_get_string(char *buffer, const struct kernel_param *kp)
+{
+    return scnprintf(buffer, PAGE_SIZE, "%s\n", kp->str->string);
+}
+
+const struct kernel_param_ops param_ops_byte = { .set = param_set_byte, .get = param_get_byte };
+const struct kernel_param_ops param_ops_ulong = { .set = param_set_ulong, .get = param_get_ulong };
+const struct kernel_param_ops param_ops_charp = { .set = param_set_charp, .get = param_get_charp };
+const struct kernel_param_ops param_ops_string = { .set = param_set_copystring, .get = param_get_string };
+
+// ########## Library API
+
+int yeetaccel_init(void)
+{
+    return accel_init();
+}
+
+void yeetaccel_exit(void)
+{
+    accel_exit();
+}
+
+int yeetaccel_param_set(const char *name, const char *val)
+{
+    struct kernel_param *kp = find_param(name);
+    int error;
+
+    if (!kp)
+        return -ENOENT;
+    if (!(kp->perm & 0222) || !kp->ops->set)
+        return -EACCES;
+
+    mutex_lock(&params_lock);
+    error = kp->ops->set(val, kp);
+    mutex_unlock(&params_lock);
+
+    return error;
+}
+
+int yeetaccel_param_get(const char *name, char *buf)
+{
+    struct kernel_param *kp = find_param(name);
+    int len;
+
+    if (!kp)
+        return -ENOENT;
+    if (!kp->ops->get)
+        return -EACCES;
+
+    mutex_lock(&params_lock);
+    len = kp->ops->get(buf, kp);
+    mutex_unlock(&params_lock);
+
+    return len;
+}
+
+void yeetaccel_set_quiet(bool value)
+{
+    quiet = value;
+}
@@ -0,0 +1,42 @@
+#ifndef YEETACCEL_H
+#define YEETACCEL_H
+
+///
+/// libyeetaccel - the driver's acceleration code (driver/accel.c, driver/accel_modes.c and FixedMath), compiled
+/// in place for userspace against the kernel API shim in shim/. The tests, the tools and the GUI all run the exact
+/// code the driver runs, there are no copies to keep in sync.
+///
+/// The module parameters are there as well, set and read them by name (same as the files in
+/// /sys/module/yeetmouse/parameters/) with yeetaccel_param_set() / yeetaccel_param_get().
+/// accel_eval(), accel_benchmark() and accelerate() (see accel.h) then work on that state.
+///
+
+#include <stdbool.h>
+#include "../driver/accel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define YEETACCEL_PARAM_BUF_LEN 4096 // Size of the buffer for yeetaccel_param_get() (PAGE_SIZE in the kernel)
+
+/// Loads the initial profile (the defaults from config.h) into the first slot, same as loading the module does.
+/// Returns 0, or a negative errno.
+int yeetaccel_init(void);
+void yeetaccel_exit(void);
+
+/// Same as writing 'val' to the parameter's file. Returns 0, or a negative errno (-ENOENT for an unknown parameter).
+int yeetaccel_param_set(const char *name, const char *val);
+
+/// Same as reading the parameter's file, 'buf' has to hold YEETACCEL_PARAM_BUF_LEN bytes.
+/// Returns the length, or a negative errno.
+int yeetaccel_param_get(const char *name, char *buf);
+
+/// Silences the driver's messages (printk), most useful when feeding it random profiles
+void yeetaccel_set_quiet(bool quiet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETACCEL_H
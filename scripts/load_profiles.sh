@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Loads acceleration profiles into the driver's profile slots, e.g. at boot (from a systemd unit or a udev rule).
+# Profiles are files with one 'Name=Value' per line, same as /sys/module/yeetmouse/parameters/profile.
+#
+# Usage: load_profiles.sh [-a ACTIVE_SLOT] PROFILE...
+#   The first profile goes to slot 0, the second to slot 1 and so on. Use '-' to skip a slot.
+#   Slot 0 is made active, unless told otherwise with -a.
+#
+# Switching later on is just: echo 1 > /sys/module/yeetmouse/parameters/active_profile
+
+PARAMS_DIR=/sys/module/yeetmouse/parameters
+ACTIVE=0
+
+while getopts "a:h" opt; do
+    case $opt in
+        a) ACTIVE=$OPTARG ;;
+        *) sed -n '3,10s/^# \?//p' "$0"; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+    sed -n '3,10s/^# \?//p' "$0"
+    exit 1
+fi
+
+if [ ! -w "$PARAMS_DIR/profile" ]; then
+    echo "Can't write to $PARAMS_DIR/profile (is the driver loaded, are you root?)" >&2
+    exit 1
+fi
+
+SLOT=0
+STATUS=0
+for PROFILE in "$@"; do
+    if [ "$PROFILE" != "-" ]; then
+        # Slot and Version of a saved profile would get in the way, the slot is ours to pick
+        KEYS=$(grep -v -E '^[[:space:]]*(Slot|Version)[[:space:]]*=' "$PROFILE" 2>/dev/null)
+
+        # 'Slot=N' alone would copy the active profile into the slot, so an unreadable or empty file fails the slot
+        if [ ! -r "$PROFILE" ]; then
+            echo "Failed to load $PROFILE into slot $SLOT (can't read it)" >&2
+            STATUS=1
+        elif ! grep -q -E '^[[:space:]]*[A-Za-z_][A-Za-z0-9_]*[[:space:]]*=' <<< "$KEYS"; then
+            echo "Failed to load $PROFILE into slot $SLOT (no parameters in it)" >&2
+            STATUS=1
+        # The whole profile has to arrive in a single write
+        elif printf '%s\n' "Slot=$SLOT"$'\n'"$KEYS" > "$PARAMS_DIR/profile"; then
+            echo "Loaded $PROFILE into slot $SLOT"
+        else
+            echo "Failed to load $PROFILE into slot $SLOT (see dmesg)" >&2
+            STATUS=1
+        fi
+    fi
+    SLOT=$((SLOT + 1))
+done
+
+if ! echo "$ACTIVE" > "$PARAMS_DIR/active_profile"; then
+    echo "Failed to activate slot $ACTIVE" >&2
+    STATUS=1
+fi
+
+exit $STATUS
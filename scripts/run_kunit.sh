@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# Runs the KUnit tests of the acceleration code (driver/kunit/) in a kernel source tree, under User-Mode Linux.
+# The tests are hooked into the tree as drivers/yeetmouse (a symlink to driver/kunit/), which is done only once.
+#
+# Usage: run_kunit.sh KERNEL_SOURCE [KUNIT_ARGS...]
+#   KUNIT_ARGS go to 'kunit.py run', e.g. --kconfig_add CONFIG_YEETMOUSE_KUNIT_BUDGET_NS=500 or --arch x86_64
+#
+# Needs a kernel with KUnit (5.5+), 6.1+ for --kunitconfig taking a directory.
+
+if [ $# -eq 0 ] || [ ! -x "$1/tools/testing/kunit/kunit.py" ]; then
+    sed -n '3,8s/^# \?//p' "$0"
+    exit 1
+fi
+
+KSRC=$(realpath "$1")
+ROOT=$(realpath "$(dirname "$0")/..")
+shift
+
+# The tests build the driver's sources, which need a config
+cp -n "$ROOT/driver/config.sample.h" "$ROOT/driver/config.h"
+
+if [ ! -e "$KSRC/drivers/yeetmouse" ]; then
+    ln -s "$ROOT/driver/kunit" "$KSRC/drivers/yeetmouse" || exit 1
+fi
+grep -q 'drivers/yeetmouse/Kconfig' "$KSRC/drivers/Kconfig" ||
+    sed -i 's|^endmenu|source "drivers/yeetmouse/Kconfig"\n\nendmenu|' "$KSRC/drivers/Kconfig"
+grep -q 'yeetmouse/' "$KSRC/drivers/Makefile" ||
+    echo 'obj-$(CONFIG_YEETMOUSE_KUNIT_TEST) += yeetmouse/' >> "$KSRC/drivers/Makefile"
+
+cd "$KSRC" && exec ./tools/testing/kunit/kunit.py run --kunitconfig=drivers/yeetmouse "$@"
@@ -0,0 +1,151 @@
+// Records mouse movement into a binary trace (see Trace.h), for YeetMouseReplay and friends.
+//
+// Usage: YeetMouseCapture -o trace.ymt /dev/input/eventN                    (until Ctrl+C)
+//        YeetMouseCapture -o trace.ymt [-r rate_hz] [-l x_offset,y_offset,bits] -c packet_dump.txt
+//   The first form records from an evdev node (needs read access to it, so usually root).
+//   The second one converts a text packet dump (debug/devices/packets/), see YeetMouseReplay for -r and -l.
+//   Use 'evtest' to find the right event node.
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+
+#include "Trace.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void OnSignal(int) {
+    stop = 1;
+}
+
+static int Record(const char *device, const char *out_path) {
+    int fd = open(device, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Can't open %s (%s)\n", device, strerror(errno));
+        return 1;
+    }
+
+    // Same clock as the driver sees
+    int clock = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock);
+
+    TraceHeader header{};
+    struct input_id id{};
+    if (ioctl(fd, EVIOCGID, &id) == 0) {
+        header.vendor = id.vendor;
+        header.product = id.product;
+    }
+    ioctl(fd, EVIOCGNAME(sizeof(header.name) - 1), header.name);
+
+    TraceWriter writer(header);
+    if (!writer.Open(out_path, header)) {
+        close(fd);
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    printf("Recording %s (%04x:%04x) to %s, Ctrl+C to stop\n", header.name, header.vendor, header.product, out_path);
+
+    struct input_event events[64];
+    int x = 0, y = 0;
+    while (!stop) {
+        ssize_t size = read(fd, events, sizeof(events));
+        if (size < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "Error reading %s (%s)\n", device, strerror(errno));
+            break;
+        }
+
+        for (size_t i = 0; i < size / sizeof(struct input_event); i++) {
+            const struct input_event &ev = events[i];
+
+            if (ev.type == EV_REL && ev.code == REL_X)
+                x += ev.value;
+            else if (ev.type == EV_REL && ev.code == REL_Y)
+                y += ev.value;
+            else if (ev.type == EV_SYN && ev.code == SYN_REPORT && (x != 0 || y != 0)) {
+                writer.Write(ev.input_event_sec * 1000000ull + ev.input_event_usec, x, y);
+                x = y = 0;
+            }
+        }
+    }
+
+    close(fd);
+    uint64_t count = writer.Count();
+    if (!writer.Close()) {
+        fprintf(stderr, "Error writing %s\n", out_path);
+        return 1;
+    }
+
+    printf("\nRecorded %llu events\n", (unsigned long long) count);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = nullptr, *dump_path = nullptr;
+    PacketLayout layout;
+    int rate = 1000;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:c:r:l:h")) != -1) {
+        switch (opt) {
+            case 'o':
+                out_path = optarg;
+                break;
+            case 'c':
+                dump_path = optarg;
+                break;
+            case 'r':
+                rate = std::max(1, atoi(optarg));
+                break;
+            case 'l':
+                if (sscanf(optarg, "%d,%d,%d", &layout.x_offset, &layout.y_offset, &layout.bits) != 3 ||
+                    layout.bits < 2 || layout.bits > 32) {
+                    fprintf(stderr, "Bad layout '%s', expected x_offset,y_offset,bits\n", optarg);
+                    return 1;
+                }
+                break;
+            default:
+                fprintf(stderr, "Usage: %s -o trace.ymt /dev/input/eventN\n"
+                                "       %s -o trace.ymt [-r rate_hz] [-l x_offset,y_offset,bits] -c packet_dump.txt\n",
+                        argv[0], argv[0]);
+                return 1;
+        }
+    }
+
+    if (!out_path || (!dump_path && optind >= argc)) {
+        fprintf(stderr, "Nothing to do, see -h\n");
+        return 1;
+    }
+
+    if (!dump_path)
+        return Record(argv[optind], out_path);
+
+    TraceHeader header{};
+    strncpy(header.name, dump_path, sizeof(header.name) - 1);
+
+    TraceWriter writer(header);
+    if (!writer.Open(out_path, header) || !ConvertPacketDump(dump_path, layout, rate, writer))
+        return 1;
+
+    uint64_t count = writer.Count();
+    if (!writer.Close()) {
+        fprintf(stderr, "Error writing %s\n", out_path);
+        return 1;
+    }
+
+    printf("Converted %llu events\n", (unsigned long long) count);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "FixedProfile.h"
+#include "fixed_profile.h"
+
+const struct accel_profile *fixed_profile(void) {
+    return &g_fixed_profile;
+}
+
+void fixed_profile_pipeline(struct accel_state *state, long long now_ns, int *x, int *y) {
+    accel_pipeline(&g_fixed_profile, state, now_ns, x, y);
+}
+
+void fixed_profile_eval(const FP_LONG *speeds, FP_LONG *out, unsigned int count) {
+    for (unsigned int i = 0; i < count; i++) {
+        FP_LONG delta_x = FP64_1, delta_y = FP64_1;
+        FP_LONG speed = accel_stage_speed(&g_fixed_profile, speeds[i], 0, FP64_1);
+
+        accel_stage_sensitivity(&g_fixed_profile, accel_stage_curve(&g_fixed_profile, speed), &delta_x, &delta_y);
+        out[i] = delta_x;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef YEETMOUSE_FIXED_PROFILE_TEST_H
+#define YEETMOUSE_FIXED_PROFILE_TEST_H
+
+#include "shared_definitions.h"
+#include "driver/accel_modes.h"
+#include "driver/accel_pipeline.h"
+
+///
+/// The fixed profile build of the driver ('make driver_fixed'): the profile in config.h as a constant, generated by
+/// lib/gen_fixed_profile. Compiled on its own (FixedProfile.c) so that the pipeline gets specialized for it, like
+/// accelerate() does in that build.
+///
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const struct accel_profile *fixed_profile(void);
+
+/// accel_pipeline() with the fixed profile
+void fixed_profile_pipeline(struct accel_state *state, long long now_ns, int *x, int *y);
+
+/// Same as accel_eval(), with the fixed profile
+void fixed_profile_eval(const FP_LONG *speeds, FP_LONG *out, unsigned int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //YEETMOUSE_FIXED_PROFILE_TEST_H
@@ -0,0 +1,266 @@
+// Searches the parameter and speed space for the inputs that make the driver's math the slowest.
+// accel_*() runs in interrupt context for every report, so what matters is the worst case, not the average.
+// The cost of update_constants() is searched too (it runs on every profile commit).
+//
+// Random search with restarts: every round samples random profiles and speeds, then keeps mutating the slowest one
+// found so far. The cost of a single input is the minimum over a few runs, which filters out interrupts and cache
+// misses caused by something else, so that only the cost of the path taken through the code is left.
+//
+// Inputs that make the math trap (a divide error is an oops in the kernel, in the middle of the input handler) are
+// the worst case there is, they are reported separately and make the search fail.
+//
+// Usage: YeetMouseLatencySearch [-m mode] [-t seconds_per_mode] [-s seed] [-b budget]
+//   -m  only search the given mode (AccelMode number), all of them otherwise
+//   -b  exit with an error if any accel_*() call is slower than this (in cycles, or ns without a cycle counter)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <csetjmp>
+#include <csignal>
+#include <random>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COST_UNIT "cycles"
+#else
+#define COST_UNIT "ns"
+#endif
+
+#include "shared_definitions.h"
+#include "driver/accel_modes.h"
+#include "driver/accel_pipeline.h"
+#include "yeetaccel.h"
+
+#define SEARCH_SAMPLES 256  // Random candidates per round
+#define SEARCH_MUTATIONS 512 // Mutations of the worst candidate per round
+#define MEASURE_RUNS 16     // A single input is measured this many times, the minimum is taken
+
+struct Candidate {
+    double acceleration, exponent, midpoint, motivity;
+    bool smoothing;
+    int lut_size;
+    double speed;
+
+    long long cost = 0; // accel_*() call
+};
+
+static inline unsigned long long Now() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    unsigned long long t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static const char *mode_names[AccelMode_Count] = {"Current", "Linear", "Power", "Classic", "Motivity",
+                                                  "Synchronous", "Natural", "Jump", "LUT", "Custom Curve"};
+
+static volatile FP_LONG sink;
+static sigjmp_buf trap_jump;
+
+static void TrapHandler(int) {
+    siglongjmp(trap_jump, 1);
+}
+
+static bool BuildProfile(AccelMode mode, const Candidate &c, accel_profile &profile, std::mt19937_64 &rng) {
+    profile = {};
+    profile.AccelerationMode = mode;
+    profile.Sensitivity = FP64_1;
+    profile.SensitivityY = FP64_1;
+    profile.PreScale = FP64_1;
+    profile.Acceleration = FP64_FromDouble(c.acceleration);
+    profile.Exponent = FP64_FromDouble(c.exponent);
+    profile.Midpoint = FP64_FromDouble(c.midpoint);
+    profile.Motivity = FP64_FromDouble(c.motivity);
+    profile.UseSmoothing = c.smoothing;
+
+    if (mode == AccelMode_Lut || mode == AccelMode_CustomCurve) {
+        std::uniform_real_distribution<double> y_dist(0.1, 5);
+        profile.LutSize = c.lut_size;
+        for (int i = 0; i < c.lut_size; i++) {
+            profile.LutData_x[i] = FP64_FromDouble(i * 200.0 / c.lut_size);
+            profile.LutData_y[i] = FP64_FromDouble(y_dist(rng));
+        }
+    }
+
+    return update_constants(&profile) == 0;
+}
+
+static long long MeasureAccel(const accel_profile &profile, FP_LONG speed) {
+    long long best = 0;
+    for (int i = 0; i < MEASURE_RUNS; i++) {
+        unsigned long long t0 = Now();
+        sink = accel_stage_curve(&profile, speed);
+        unsigned long long t1 = Now();
+        if (i == 0 || (long long) (t1 - t0) < best)
+            best = t1 - t0;
+    }
+    return best;
+}
+
+static long long MeasureUpdate(accel_profile &profile) {
+    long long best = 0;
+    for (int i = 0; i < MEASURE_RUNS / 4; i++) {
+        unsigned long long t0 = Now();
+        update_constants(&profile);
+        unsigned long long t1 = Now();
+        if (i == 0 || (long long) (t1 - t0) < best)
+            best = t1 - t0;
+    }
+    return best;
+}
+
+static Candidate RandomCandidate(std::mt19937_64 &rng) {
+    // Log-uniform, small values take different paths than the big ones
+    auto log_uniform = [&rng](double min, double max) {
+        return std::exp(std::uniform_real_distribution<double>(std::log(min), std::log(max))(rng));
+    };
+
+    Candidate c;
+    c.acceleration = log_uniform(1e-4, 50);
+    c.exponent = log_uniform(1e-3, 20);
+    c.midpoint = log_uniform(1e-3, 200);
+    c.motivity = 1 + log_uniform(1e-3, 20);
+    c.smoothing = rng() & 1;
+    c.lut_size = std::uniform_int_distribution<int>(2, MAX_LUT_ARRAY_SIZE)(rng);
+    c.speed = log_uniform(1e-3, 2000);
+    return c;
+}
+
+static Candidate Mutate(const Candidate &base, std::mt19937_64 &rng) {
+    std::normal_distribution<double> step(0, 0.1);
+    Candidate c = base;
+
+    switch (rng() % 6) {
+        case 0: c.acceleration *= std::exp(step(rng)); break;
+        case 1: c.exponent *= std::exp(step(rng)); break;
+        case 2: c.midpoint *= std::exp(step(rng)); break;
+        case 3: c.motivity = 1 + (c.motivity - 1) * std::exp(step(rng)); break;
+        case 4: c.lut_size = std::clamp(c.lut_size + (int) (step(rng) * 50), 2, MAX_LUT_ARRAY_SIZE); break;
+        default: break;
+    }
+    // The speed changes every time, it's the most important input
+    c.speed = std::clamp(c.speed * std::exp(step(rng)), 1e-4, 5000.0);
+    return c;
+}
+
+static void PrintProfile(AccelMode mode, const Candidate &c) {
+    printf("    AccelerationMode=%d\n    Acceleration=%.6f\n    Exponent=%.6f\n    Midpoint=%.6f\n    Motivity=%.6f\n"
+           "    UseSmoothing=%d\n", mode, c.acceleration, c.exponent, c.midpoint, c.motivity, c.smoothing);
+    if (mode == AccelMode_Lut || mode == AccelMode_CustomCurve)
+        printf("    LutSize=%d (random points)\n", c.lut_size);
+    printf("    at speed %.4f counts/ms\n", c.speed);
+}
+
+int main(int argc, char **argv) {
+    int only_mode = -1;
+    double seconds = 2;
+    unsigned long long seed = std::random_device{}();
+    long long budget = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:t:s:b:h")) != -1) {
+        switch (opt) {
+            case 'm': only_mode = atoi(optarg); break;
+            case 't': seconds = atof(optarg); break;
+            case 's': seed = strtoull(optarg, nullptr, 0); break;
+            case 'b': budget = atoll(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-m mode] [-t seconds_per_mode] [-s seed] [-b budget]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    // Most of the random profiles get rejected, the driver's error messages would bury the results
+    yeetaccel_set_quiet(true);
+
+    printf("Seed: %llu, costs in " COST_UNIT "\n", seed);
+    std::mt19937_64 rng(seed);
+    bool failed = false;
+
+    struct sigaction trap{};
+    trap.sa_handler = TrapHandler;
+    sigaction(SIGFPE, &trap, nullptr);
+
+    for (int m = AccelMode_Linear; m < AccelMode_Count; m++) {
+        if (only_mode >= 0 && m != only_mode)
+            continue;
+
+        AccelMode mode = static_cast<AccelMode>(m);
+        accel_profile profile;
+        Candidate worst{}, worst_update{}, trapped{};
+        unsigned long long trap_count = 0;
+        long long worst_update_cost = 0;
+        unsigned long long evaluated = 0;
+        bool found = false;
+
+        auto consider = [&](const Candidate &candidate) {
+            // Has to survive the jump
+            static Candidate c;
+            c = candidate;
+            if (sigsetjmp(trap_jump, 1) != 0) {
+                if (trap_count++ == 0)
+                    trapped = c;
+                return false;
+            }
+
+            if (!BuildProfile(mode, c, profile, rng))
+                return false; // The driver would reject it
+
+            c.cost = MeasureAccel(profile, FP64_FromDouble(c.speed));
+            evaluated++;
+            if (!found || c.cost > worst.cost) {
+                worst = c;
+                found = true;
+            }
+
+            long long update_cost = MeasureUpdate(profile);
+            if (update_cost > worst_update_cost) {
+                worst_update_cost = update_cost;
+                worst_update = c;
+            }
+            return true;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+            // Explore
+            for (int i = 0; i < SEARCH_SAMPLES; i++)
+                consider(RandomCandidate(rng));
+
+            // Exploit
+            for (int i = 0; found && i < SEARCH_MUTATIONS; i++)
+                consider(Mutate(worst, rng));
+        }
+
+        printf("%s: %llu inputs evaluated\n", mode_names[mode], evaluated);
+        if (trap_count) {
+            printf("  \033[31m%llu inputs trapped (SIGFPE), the first one:\033[0m\n", trap_count);
+            PrintProfile(mode, trapped);
+            failed = true;
+        }
+        if (!found) {
+            printf("  No valid profile found\n");
+            continue;
+        }
+
+        printf("  Worst accel call: %lld " COST_UNIT "\n", worst.cost);
+        PrintProfile(mode, worst);
+        printf("  Worst update_constants(): %lld " COST_UNIT "\n", worst_update_cost);
+        PrintProfile(mode, worst_update);
+
+        if (budget > 0 && worst.cost > budget) {
+            printf("  \033[31mOver the budget of %lld " COST_UNIT "\033[0m\n", budget);
+            failed = true;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
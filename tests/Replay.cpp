@@ -0,0 +1,236 @@
+// Feeds recorded mouse movement through the driver's acceleration pipeline (accelerate() without the kernel bits),
+// as fast as it can. Reports the throughput, per-event latency percentiles and a checksum of the output,
+// so that changes to the driver can be benchmarked and checked for (bit-exact) regressions on real movement.
+//
+// Usage: YeetMouseReplay [-p profile.txt] [-r rate_hz] [-l x_offset,y_offset,bits] [-n repeats] trace...
+//   Traces are either binary traces (.ymt, see Trace.h and YeetMouseCapture) or the packet dumps
+//   from debug/devices/packets/ (one raw HID report per line, as hex bytes).
+//   For the dumps, the layout (-l) is where X and Y are in the report, in bits (see debug/hid_parser/), 8,24,16 by
+//   default, and the rate (-r) is the report rate as they have no timestamps.
+//   The profile is the same format as /sys/module/yeetmouse/parameters/profile, no acceleration otherwise.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "shared_definitions.h"
+#include "driver/accel_modes.h"
+#include "driver/accel_pipeline.h"
+#include "Trace.h"
+
+// Parses the same 'Name=Value' lines the driver takes in its 'profile' parameter
+static bool LoadProfile(const char *path, accel_profile &profile) {
+    static const struct {
+        const char *name;
+        FP_LONG accel_profile::*field;
+    } fixed_keys[] = {
+        {"Sensitivity", &accel_profile::Sensitivity},
+        {"SensitivityY", &accel_profile::SensitivityY},
+        {"OutputCap", &accel_profile::OutputCap},
+        {"InputCap", &accel_profile::InputCap},
+        {"Offset", &accel_profile::Offset},
+        {"PreScale", &accel_profile::PreScale},
+        {"Acceleration", &accel_profile::Acceleration},
+        {"Exponent", &accel_profile::Exponent},
+        {"Midpoint", &accel_profile::Midpoint},
+        {"Motivity", &accel_profile::Motivity},
+        {"RotationAngle", &accel_profile::RotationAngle},
+        {"AngleSnap_Threshold", &accel_profile::AngleSnap_Threshold},
+        {"AngleSnap_Angle", &accel_profile::AngleSnap_Angle},
+    };
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos)
+            continue;
+
+        std::string name = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        bool known = false;
+
+        for (const auto &key: fixed_keys) {
+            if (name == key.name) {
+                known = FP64_FromString(value.c_str(), &(profile.*key.field)) != 0;
+                break;
+            }
+        }
+
+        if (name == "AccelerationMode")
+            profile.AccelerationMode = static_cast<char>(std::stoi(value)), known = true;
+        else if (name == "UseSmoothing")
+            profile.UseSmoothing = static_cast<char>(std::stoi(value)), known = true;
+        else if (name == "LutDataBuf") {
+            // "x,y;x,y;..."
+            const char *p = value.c_str();
+            unsigned long i = 0;
+            for (; i < MAX_LUT_ARRAY_SIZE * 2 && *p; i++) {
+                FP_LONG val;
+                int len = FP64_FromString(p, &val);
+                if (len == 0)
+                    break;
+                p += len;
+                if (*p)
+                    p++;
+                ((i % 2 == 0) ? profile.LutData_x : profile.LutData_y)[i / 2] = val;
+            }
+            profile.LutSize = i / 2;
+            known = true;
+        } else if (name == "LutSize" || name == "Version" || name == "Slot")
+            known = true; // Derived from the data / meaningless here
+
+        if (!known)
+            fprintf(stderr, "Ignoring '%s' in the profile\n", line.c_str());
+    }
+
+    return true;
+}
+
+// FNV-1a over the outputs, the same profile and trace always have to give the same checksum
+static unsigned long long Checksum(unsigned long long hash, int value) {
+    for (int i = 0; i < 4; i++) {
+        hash ^= (static_cast<unsigned int>(value) >> (i * 8)) & 0xff;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+int main(int argc, char **argv) {
+    using namespace std::chrono;
+
+    accel_profile profile{};
+    profile.Sensitivity = FP64_1;
+    profile.SensitivityY = FP64_1;
+    profile.PreScale = FP64_1;
+
+    PacketLayout layout;
+    int rate = 1000;
+    int repeats = 10;
+    const char *profile_path = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:r:l:n:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                profile_path = optarg;
+                break;
+            case 'r':
+                rate = std::max(1, std::stoi(optarg));
+                break;
+            case 'l':
+                if (sscanf(optarg, "%d,%d,%d", &layout.x_offset, &layout.y_offset, &layout.bits) != 3 ||
+                    layout.bits < 2 || layout.bits > 32) {
+                    fprintf(stderr, "Bad layout '%s', expected x_offset,y_offset,bits\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'n':
+                repeats = std::max(1, std::stoi(optarg));
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-p profile.txt] [-r rate_hz] [-l x_offset,y_offset,bits] [-n repeats] "
+                                "trace...\n", argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        fprintf(stderr, "No traces given\n");
+        return 1;
+    }
+
+    if (profile_path && !LoadProfile(profile_path, profile))
+        return 1;
+
+    if (update_constants(&profile) != 0)
+        fprintf(stderr, "Invalid profile, the driver would fall back to the 'Current' mode\n");
+
+    for (int t = optind; t < argc; t++) {
+        TraceReader trace;
+        TraceWriter converted(TraceHeader{});
+
+        if (FILE *file = fopen(argv[t], "rb")) {
+            char magic[sizeof(TRACE_MAGIC)] = {};
+            bool is_trace = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                            memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+            fclose(file);
+
+            if (is_trace ? !trace.Open(argv[t]) : !ConvertPacketDump(argv[t], layout, rate, converted) ||
+                                                   !trace.Open(converted.Data().data(), converted.Data().size()))
+                continue;
+        } else {
+            fprintf(stderr, "Can't open %s\n", argv[t]);
+            continue;
+        }
+
+        TraceEvent event{};
+        if (!trace.Next(event))
+            continue;
+        // The first event gets the nominal period
+        long long first_period_ns = 1000000000ll / rate;
+
+        // Throughput, decoding included (straight from the mapped file)
+        unsigned long long checksum = 0, count = 0;
+        auto start = steady_clock::now();
+        for (int r = 0; r < repeats; r++) {
+            unsigned long long hash = 0xcbf29ce484222325ull;
+            trace.Rewind();
+            trace.Next(event);
+            accel_state state{0, 0, event.time_ns - first_period_ns};
+
+            count = 0;
+            do {
+                int x = event.x, y = event.y;
+                accel_pipeline(&profile, &state, event.time_ns, &x, &y);
+                hash = Checksum(Checksum(hash, x), y);
+                count++;
+            } while (trace.Next(event));
+            checksum = hash;
+        }
+        double total_s = duration<double>(steady_clock::now() - start).count();
+
+        // Latency, every event on its own
+        std::vector<long long> latencies;
+        latencies.reserve(count * repeats);
+        for (int r = 0; r < repeats; r++) {
+            trace.Rewind();
+            trace.Next(event);
+            accel_state state{0, 0, event.time_ns - first_period_ns};
+
+            do {
+                int x = event.x, y = event.y;
+                auto t0 = steady_clock::now();
+                accel_pipeline(&profile, &state, event.time_ns, &x, &y);
+                auto t1 = steady_clock::now();
+                latencies.push_back(duration_cast<nanoseconds>(t1 - t0).count());
+            } while (trace.Next(event));
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        auto percentile = [&latencies](double p) {
+            return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+        };
+
+        printf("%s: %llu events, mode %d\n", argv[t], count, profile.AccelerationMode);
+        if (trace.Header().name[0])
+            printf("  recorded from %s (%04x:%04x)\n", trace.Header().name, trace.Header().vendor,
+                   trace.Header().product);
+        printf("  %.2f M events/s\n", count * repeats / total_s / 1e6);
+        printf("  latency [ns]: p50 %lld, p90 %lld, p99 %lld, p99.9 %lld, max %lld\n", percentile(0.5),
+               percentile(0.9), percentile(0.99), percentile(0.999), latencies.back());
+        printf("  checksum: %016llx\n", checksum);
+    }
+
+    return 0;
+}
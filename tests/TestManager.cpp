@@ -3,33 +3,27 @@
 #include "shared_definitions.h"
 #include "driver/accel_modes.h"
 
-// "Private" values only visible to the accel_modes
-FP_LONG g_Sensitivity = FP64_1, g_SensitivityY = FP64_1, g_OutputCap = 0, g_InputCap = 0, g_Offset = 0, g_PreScale = FP64_1, g_Acceleration = 0, g_Exponent
-                = 0, g_Midpoint = 0, g_Motivity = 0, g_RotationAngle = 0, g_AngleSnap_Angle = 0, g_AngleSnap_Threshold =
-                0, g_LutData_x[256], g_LutData_y[256];
-char g_AccelerationMode = 0, g_UseSmoothing = 0;
-unsigned long g_LutSize = 0;
-ModesConstants modesConst;
-static CachedFunction function;
+// Every thread drives its own instance, created on first use (see TestManager::Context())
+static thread_local TestContext context;
 
 // Ignores speedY (for now?)
 FP_LONG ApplyGlobalPostParameters(FP_LONG speed) {
     FP_LONG speed_Y = FP64_1;
-    if (g_SensitivityY == FP64_1) {
-        if(g_Sensitivity != FP64_1)
-            speed = FP64_Mul(speed, g_Sensitivity);
+    if (context.profile.SensitivityY == FP64_1) {
+        if(context.profile.Sensitivity != FP64_1)
+            speed = FP64_Mul(speed, context.profile.Sensitivity);
 
         // Apply Output Limit
-        if(g_OutputCap > 0)
-            speed = FP64_Min(g_OutputCap, speed);
+        if(context.profile.OutputCap > 0)
+            speed = FP64_Min(context.profile.OutputCap, speed);
     } else {
-        speed = FP64_Mul(speed, g_Sensitivity);
-        speed_Y = FP64_Mul(speed, g_SensitivityY);
+        speed = FP64_Mul(speed, context.profile.Sensitivity);
+        speed_Y = FP64_Mul(speed, context.profile.SensitivityY);
 
         // Apply Output Limit
-        if(g_OutputCap > 0) {
-            speed = FP64_Min(g_OutputCap, speed);
-            speed_Y = FP64_Min(g_OutputCap, speed_Y);
+        if(context.profile.OutputCap > 0) {
+            speed = FP64_Min(context.profile.OutputCap, speed);
+            speed_Y = FP64_Min(context.profile.OutputCap, speed_Y);
         }
     }
 
@@ -37,7 +31,7 @@ FP_LONG ApplyGlobalPostParameters(FP_LONG speed) {
 }
 
 FP_LONG ApplyGlobalPreParameters(FP_LONG speed) {
-    return FP64_Mul(speed, g_PreScale);
+    return FP64_Mul(speed, context.profile.PreScale);
 }
 
 // TestManager & TestManager::GetInstance() {
@@ -45,31 +39,51 @@ FP_LONG ApplyGlobalPreParameters(FP_LONG speed) {
 //     return instance;
 // }
 
-void TestManager::Initialize() {
-    function.params = new Parameters;
-    function.params->sens = FP64_ToFloat(g_Sensitivity);
-    function.params->sensY = FP64_ToFloat(g_SensitivityY);
-    function.params->accelMode = static_cast<AccelMode>(g_AccelerationMode);
-    function.params->preScale = FP64_ToFloat(g_PreScale);
-    function.params->accel = FP64_ToFloat(g_Acceleration);
-    function.params->exponent = FP64_ToFloat(g_Exponent);
-    function.params->midpoint = FP64_ToFloat(g_Midpoint);
-    function.params->offset = FP64_ToFloat(g_Offset);
-    function.params->useSmoothing = g_UseSmoothing;
-    function.params->rotation = FP64_ToFloat(g_RotationAngle);
-    function.params->as_angle = FP64_ToFloat(g_AngleSnap_Angle);
-    function.params->as_threshold = FP64_ToFloat(g_AngleSnap_Threshold);
-    function.params->inCap = 0;
-    function.params->outCap = 0;
+TestContext::TestContext() {
+    Reset();
+}
+
+void TestContext::Reset() {
+    profile = {};
+    profile.Sensitivity = FP64_1;
+    profile.SensitivityY = FP64_1;
+    profile.PreScale = FP64_1;
+
+    params = {};
+    params.sens = FP64_ToFloat(profile.Sensitivity);
+    params.sensY = FP64_ToFloat(profile.SensitivityY);
+    params.accelMode = static_cast<AccelMode>(profile.AccelerationMode);
+    params.preScale = FP64_ToFloat(profile.PreScale);
+    params.accel = FP64_ToFloat(profile.Acceleration);
+    params.exponent = FP64_ToFloat(profile.Exponent);
+    params.midpoint = FP64_ToFloat(profile.Midpoint);
+    params.offset = FP64_ToFloat(profile.Offset);
+    params.useSmoothing = profile.UseSmoothing;
+    params.rotation = FP64_ToFloat(profile.RotationAngle);
+    params.as_angle = FP64_ToFloat(profile.AngleSnap_Angle);
+    params.as_threshold = FP64_ToFloat(profile.AngleSnap_Threshold);
+    params.inCap = 0;
+    params.outCap = 0;
+
+    function = CachedFunction();
+    function.params = &params;
     function.PreCacheConstants();
 }
 
+void TestManager::Initialize() {
+    context.Reset();
+}
+
+TestContext &TestManager::Context() {
+    return context;
+}
+
 FP_LONG TestManager::AccelLinear(FP_LONG x, FP_LONG acceleration, FP_LONG midpoint, bool gain) {
     SetAcceleration(acceleration);
     SetUseSmoothing(gain);
     SetMidpoint(midpoint);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_linear(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_linear(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelPower(FP_LONG x, FP_LONG acceleration, FP_LONG exponent, FP_LONG midpoint, FP_LONG motivity,
@@ -80,7 +94,7 @@ FP_LONG TestManager::AccelPower(FP_LONG x, FP_LONG acceleration, FP_LONG exponen
     SetMotivity(motivity);
     SetUseSmoothing(gain);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_power(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_power(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelClassic(FP_LONG x, FP_LONG acceleration, FP_LONG exponent, FP_LONG midpoint, bool gain) {
@@ -89,7 +103,7 @@ FP_LONG TestManager::AccelClassic(FP_LONG x, FP_LONG acceleration, FP_LONG expon
     SetMidpoint(midpoint);
     SetUseSmoothing(gain);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_classic(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_classic(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelMotivity(FP_LONG x, FP_LONG acceleration, FP_LONG exponent, FP_LONG midpoint) {
@@ -97,7 +111,7 @@ FP_LONG TestManager::AccelMotivity(FP_LONG x, FP_LONG acceleration, FP_LONG expo
     SetExponent(exponent);
     SetMidpoint(midpoint);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_motivity(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_motivity(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelSynchronous(FP_LONG x, FP_LONG sync_speed, FP_LONG gamma, FP_LONG smoothness,
@@ -108,7 +122,7 @@ FP_LONG TestManager::AccelSynchronous(FP_LONG x, FP_LONG sync_speed, FP_LONG gam
     SetMotivity(motivity);
     SetUseSmoothing(gain);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_synchronous(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_synchronous(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelJump(FP_LONG x, FP_LONG acceleration, FP_LONG exponent, FP_LONG midpoint, bool gain) {
@@ -117,7 +131,7 @@ FP_LONG TestManager::AccelJump(FP_LONG x, FP_LONG acceleration, FP_LONG exponent
     SetMidpoint(midpoint);
     SetUseSmoothing(gain);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_jump(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_jump(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelLUT(FP_LONG x, FP_LONG values_x[], FP_LONG values_y[], unsigned long count) {
@@ -125,11 +139,11 @@ FP_LONG TestManager::AccelLUT(FP_LONG x, FP_LONG values_x[], FP_LONG values_y[],
     SetLutData_x(values_x, count);
     SetLutData_y(values_y, count);
     UpdateModesConstants();
-    return ApplyGlobalPostParameters(accel_lut(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_lut(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelLUT(FP_LONG x) {
-    return ApplyGlobalPostParameters(accel_lut(ApplyGlobalPreParameters(x)));
+    return ApplyGlobalPostParameters(accel_lut(&context.profile, ApplyGlobalPreParameters(x)));
 }
 
 FP_LONG TestManager::AccelLinear(float x, float acceleration, float midpoint, bool gain) {
@@ -181,47 +195,71 @@ FP_LONG TestManager::AccelLUT(float x) {
 }
 
 FP_LONG TestManager::AccelLinear(float x) {
-    return ApplyGlobalPostParameters(accel_linear(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_linear(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelPower(float x) {
-    return ApplyGlobalPostParameters(accel_power(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_power(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelClassic(float x) {
-    return ApplyGlobalPostParameters(accel_classic(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_classic(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelMotivity(float x) {
-    return ApplyGlobalPostParameters(accel_motivity(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_motivity(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelSynchronous(float x) {
-    return ApplyGlobalPostParameters(accel_synchronous(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_synchronous(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelNatural(float x) {
-    return ApplyGlobalPostParameters(accel_natural(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_natural(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
 }
 
 FP_LONG TestManager::AccelJump(float x) {
-    return ApplyGlobalPostParameters(accel_jump(ApplyGlobalPreParameters(FP64_FromFloat(x))));
+    return ApplyGlobalPostParameters(accel_jump(&context.profile, ApplyGlobalPreParameters(FP64_FromFloat(x))));
+}
+
+FP_LONG TestManager::Accel(float x) {
+    switch (context.profile.AccelerationMode) {
+        case AccelMode_Linear:
+            return AccelLinear(x);
+        case AccelMode_Power:
+            return AccelPower(x);
+        case AccelMode_Classic:
+            return AccelClassic(x);
+        case AccelMode_Motivity:
+            return AccelMotivity(x);
+        case AccelMode_Synchronous:
+            return AccelSynchronous(x);
+        case AccelMode_Natural:
+            return AccelNatural(x);
+        case AccelMode_Jump:
+            return AccelJump(x);
+        case AccelMode_Lut:
+        case AccelMode_CustomCurve:
+            return AccelLUT(x);
+        default:
+            return ApplyGlobalPostParameters(FP64_1);
+    }
 }
 
 ModesConstants &TestManager::GetModesConstants() {
-    return modesConst;
+    return context.profile.consts;
 }
 
 void TestManager::UpdateModesConstants() {
-    update_constants();
-    function.PreCacheConstants();
+    update_constants(&context.profile);
+    context.function.PreCacheConstants();
 }
 
 bool TestManager::ValidateConstants() {
-    if (g_AccelerationMode == AccelMode_Current)
+    if (context.profile.AccelerationMode == AccelMode_Current)
         return false;
 
-    // switch (g_AccelerationMode) {
+    // switch (context.profile.AccelerationMode) {
     //     case AccelMode_Linear:
     //         break;
     //     case AccelMode_Power:
@@ -240,100 +278,100 @@ bool TestManager::ValidateConstants() {
 }
 
 bool TestManager::ValidateFunctionGUI() {
-    return function.ValidateSettings();
+    return context.function.ValidateSettings();
 }
 
 void TestManager::SetAccelMode(AccelMode mode) {
-    g_AccelerationMode = mode;
-    function.params->accelMode = static_cast<AccelMode>(g_AccelerationMode);
+    context.profile.AccelerationMode = mode;
+    context.function.params->accelMode = static_cast<AccelMode>(context.profile.AccelerationMode);
 }
 
 void TestManager::SetUseSmoothing(char useSmoothing) {
-    g_UseSmoothing = useSmoothing;
-    function.params->useSmoothing = g_UseSmoothing;
+    context.profile.UseSmoothing = useSmoothing;
+    context.function.params->useSmoothing = context.profile.UseSmoothing;
 }
 
 void TestManager::SetAcceleration(FP_LONG acceleration) {
-    g_Acceleration = acceleration;
-    function.params->accel = FP64_ToFloat(g_Acceleration);
+    context.profile.Acceleration = acceleration;
+    context.function.params->accel = FP64_ToFloat(context.profile.Acceleration);
 }
 
 void TestManager::SetExponent(FP_LONG exponent) {
-    g_Exponent = exponent;
-    function.params->exponent = FP64_ToFloat(g_Exponent);
+    context.profile.Exponent = exponent;
+    context.function.params->exponent = FP64_ToFloat(context.profile.Exponent);
 }
 
 void TestManager::SetMidpoint(FP_LONG midpoint) {
-    g_Midpoint = midpoint;
-    function.params->midpoint = FP64_ToFloat(g_Midpoint);
+    context.profile.Midpoint = midpoint;
+    context.function.params->midpoint = FP64_ToFloat(context.profile.Midpoint);
 }
 
 void TestManager::SetMotivity(FP_LONG motivity) {
-    g_Motivity = motivity;
-    function.params->motivity = FP64_ToFloat(g_Motivity);
+    context.profile.Motivity = motivity;
+    context.function.params->motivity = FP64_ToFloat(context.profile.Motivity);
 }
 
 void TestManager::SetSensitivity(FP_LONG sensitivity) {
-    g_Sensitivity = sensitivity;
-    function.params->sens = FP64_ToFloat(sensitivity);
+    context.profile.Sensitivity = sensitivity;
+    context.function.params->sens = FP64_ToFloat(sensitivity);
 }
 
 void TestManager::SetSensitivityY(FP_LONG sensitivityY) {
-    g_SensitivityY = sensitivityY;
-    function.params->sensY = FP64_ToFloat(sensitivityY);
+    context.profile.SensitivityY = sensitivityY;
+    context.function.params->sensY = FP64_ToFloat(sensitivityY);
 }
 
 void TestManager::SetOutCap(FP_LONG outCap) {
-    g_OutputCap = outCap;
-    function.params->outCap = FP64_ToFloat(outCap);
+    context.profile.OutputCap = outCap;
+    context.function.params->outCap = FP64_ToFloat(outCap);
 }
 
 void TestManager::SetInCap(FP_LONG inCap) {
-    g_InputCap = inCap;
-    function.params->inCap = FP64_ToFloat(inCap);
+    context.profile.InputCap = inCap;
+    context.function.params->inCap = FP64_ToFloat(inCap);
 }
 
 void TestManager::SetOffset(FP_LONG offset) {
-    g_Offset = offset;
-    function.params->offset = FP64_ToFloat(offset);
+    context.profile.Offset = offset;
+    context.function.params->offset = FP64_ToFloat(offset);
 }
 
 void TestManager::SetPreScale(FP_LONG preScale) {
-    g_PreScale = preScale;
-    function.params->preScale = FP64_ToFloat(preScale);
+    context.profile.PreScale = preScale;
+    context.function.params->preScale = FP64_ToFloat(preScale);
 }
 
 void TestManager::SetRotationAngle(FP_LONG rotationAngle) {
-    g_RotationAngle = rotationAngle;
-    function.params->rotation = FP64_ToFloat(g_RotationAngle);
+    context.profile.RotationAngle = rotationAngle;
+    context.function.params->rotation = FP64_ToFloat(context.profile.RotationAngle);
 }
 
 void TestManager::SetAngleSnap_Angle(FP_LONG angleSnap_Angle) {
-    g_AngleSnap_Angle = angleSnap_Angle;
-    function.params->as_angle = FP64_ToFloat(g_AngleSnap_Angle);
+    context.profile.AngleSnap_Angle = angleSnap_Angle;
+    context.function.params->as_angle = FP64_ToFloat(context.profile.AngleSnap_Angle);
 }
 
 void TestManager::SetAngleSnap_Threshold(FP_LONG angleSnap_Threshold) {
-    g_AngleSnap_Threshold = angleSnap_Threshold;
-    function.params->as_threshold = FP64_ToFloat(g_AngleSnap_Threshold);
+    context.profile.AngleSnap_Threshold = angleSnap_Threshold;
+    context.function.params->as_threshold = FP64_ToFloat(context.profile.AngleSnap_Threshold);
 }
 
 void TestManager::SetUseSmoothing(bool useSmoothing) {
-    g_UseSmoothing = useSmoothing ? 1 : 0;
-    function.params->useSmoothing = g_UseSmoothing;
+    context.profile.UseSmoothing = useSmoothing ? 1 : 0;
+    context.function.params->useSmoothing = context.profile.UseSmoothing;
 }
 
 void TestManager::SetLutSize(unsigned long lutSize) {
-    g_LutSize = lutSize;
-    function.params->LUT_size = g_LutSize;
+    context.profile.LutSize = lutSize;
+    context.function.params->LUT_size = context.profile.LutSize;
 }
 
 void TestManager::SetLutData_x(FP_LONG values[], unsigned long count) {
     SetLutSize(count);
 
     for (unsigned long i = 0; i < count; i++) {
-        g_LutData_x[i] = values[i];
-        function.params->LUT_data_x[i] = FP64_ToFloat(values[i]);
+        context.profile.LutData_x[i] = values[i];
+        context.function.params->LUT_data_x[i] = FP64_ToFloat(values[i]);
     }
 }
 
@@ -341,8 +379,8 @@ void TestManager::SetLutData_y(FP_LONG values[], unsigned long count) {
     SetLutSize(count);
 
     for (unsigned long i = 0; i < count; i++) {
-        g_LutData_y[i] = values[i];
-        function.params->LUT_data_y[i] = FP64_ToFloat(values[i]);
+        context.profile.LutData_y[i] = values[i];
+        context.function.params->LUT_data_y[i] = FP64_ToFloat(values[i]);
     }
 }
 
@@ -417,6 +455,6 @@ void TestManager::SetLutData(float values_x[], float values_y[], unsigned long c
 }
 
 float TestManager::EvalFloatFunc(float x) {
-    function.params->accelMode = static_cast<AccelMode>(g_AccelerationMode);
-    return function.EvalFuncAt(x);
+    context.function.params->accelMode = static_cast<AccelMode>(context.profile.AccelerationMode);
+    return context.function.EvalFuncAt(x);
 }
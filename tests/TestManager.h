@@ -5,13 +5,31 @@
 #include "driver/accel_modes.h"
 #include "../gui/FunctionHelper.h"
 
+///
+/// One instance of the 'fake' driver: the profile it runs with, and the GUI's function to compare it against.
+/// Every thread gets its own (see TestManager::Context()), so independent sweeps can run concurrently.
+///
+struct TestContext {
+    accel_profile profile;
+    Parameters params;
+    CachedFunction function;
+
+    TestContext();
+
+    /// Back to the defaults (no acceleration)
+    void Reset();
+};
+
 ///
 /// Class for interfacing with the 'fake' driver
+/// Works on the calling thread's context
 ///
 class TestManager {
 public:
     //static TestManager& GetInstance();
+    /// Resets the calling thread's context
     static void Initialize();
+    static TestContext &Context();
 
     static FP_LONG AccelLinear(FP_LONG x, FP_LONG acceleration, FP_LONG midpoint, bool gain);
     static FP_LONG AccelPower(FP_LONG x, FP_LONG acceleration, FP_LONG exponent, FP_LONG midpoint, FP_LONG motivity,
@@ -41,6 +59,7 @@ public:
     static FP_LONG AccelNatural(float x); // Parameter values set manually!
     static FP_LONG AccelJump(float x); // Parameter values set manually!
     static FP_LONG AccelLUT(float x); // Parameter values set manually!
+    static FP_LONG Accel(float x); // Whatever mode is set, parameter values set manually!
 
     static ModesConstants &GetModesConstants();
     static void UpdateModesConstants();
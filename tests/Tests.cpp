@@ -1,13 +1,23 @@
 #include "Tests.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
 
 #include "TestManager.h"
 #include "driver/accel_modes.h"
 
 #include "../gui/FunctionHelper.h"
-#include "driver/config.h"
+#include "../gui/CurveWorker.h"
+#include "../gui/DriverHelper.h"
+#include "ThreadPool.h"
+#include "FixedProfile.h"
+#include "yeetaccel.h"
 
 //static CachedFunction functions[AccelMode_Count];
 
@@ -954,6 +964,207 @@ std::array<bool, AccelMode_Count> Tests::TestAllBasic(float range_min, float ran
     return results;
 }
 
+bool Tests::TestRegressions() {
+    TestSupervisor supervisor{"Regressions"};
+
+    // Synchronous (without the gain smoothing) straight from the driver, parameters as in the GUI
+    auto synchronous = [](float sync_speed, float gamma, float smoothness, float motivity, double x) {
+        accel_profile profile{};
+        profile.AccelerationMode = AccelMode_Synchronous;
+        profile.Sensitivity = profile.SensitivityY = profile.PreScale = FP64_1;
+        profile.Acceleration = FP64_FromFloat(sync_speed);
+        profile.Exponent = FP64_FromFloat(gamma);
+        profile.Midpoint = FP64_FromFloat(smoothness);
+        profile.Motivity = FP64_FromFloat(motivity);
+        update_constants(&profile);
+        return accel_synchronous(&profile, FP64_FromDouble(x));
+    };
+
+    try {
+        supervisor.NextTest();
+        // Sharp Synchronous (smoothness 0) is clamped to [1 / motivity, motivity] only outside of the transition,
+        // in between it's motivity^(gamma * log(x / sync_speed) / log(motivity)) = (x / sync_speed)^gamma
+        for (double x: {8.5, 10.0, 11.0, 12.0}) {
+            supervisor.Validate(IsCloseEnoughRelative(synchronous(10, 1, 0, 1.5, x), std::pow(x / 10, 1.0), 1e-4));
+        }
+        supervisor.Validate(IsCloseEnoughRelative(synchronous(10, 1, 0, 1.5, 5), 1 / 1.5, 1e-4));
+        supervisor.Validate(IsCloseEnoughRelative(synchronous(10, 1, 0, 1.5, 20), 1.5, 1e-4));
+
+        supervisor.NextTest();
+        // Smooth Synchronous close to the sync speed, where M^sharpness is below the fixed point resolution
+        for (double x: {9.9, 9.98, 10.02, 10.1, 12.0, 14.0}) {
+            double sharpness = 0.5 / 0.05, log_mot = std::log(1.5);
+            double M = std::fabs(std::log(x / 10)) / log_mot;
+            double exponent = std::copysign(std::pow(std::tanh(std::pow(M, sharpness)), 1 / sharpness), x - 10);
+            supervisor.Validate(IsCloseEnoughRelative(synchronous(10, 1, 0.05, 1.5, x), std::exp(exponent * log_mot),
+                                                      1e-4));
+        }
+
+        supervisor.NextTest();
+        // 2^x saturates once the integer part can't hold it anymore (2^31 for Q32.32), below that it's exact enough
+        for (double x: {31.0, 31.5, 31.99, 40.0}) {
+            supervisor.Validate(FP64_Exp2(FP64_FromDouble(x)) == MaxValue);
+            supervisor.Validate(FP64_Exp2Fast(FP64_FromDouble(x)) == MaxValue);
+        }
+        for (double x: {20.5, 29.0, 30.5, 30.99})
+            supervisor.Validate(IsCloseEnoughRelative(FP64_Exp2(FP64_FromDouble(x)), std::exp2(x), 1e-5));
+
+        supervisor.NextTest();
+        // tanh(x) is +-1 for large x, including the ones where 2x doesn't fit anymore
+        for (long long x: {17ll, 1000ll, 1ll << 30, 1500000000ll, 2147483647ll}) {
+            supervisor.Validate(FP64_Tanh(FP64_FromInt(x)) == FP64_1);
+            supervisor.Validate(FP64_Tanh(FP64_FromInt(-x)) == -FP64_1);
+        }
+
+        supervisor.NextTest();
+        // The GUI's smooth Natural at low speeds with a slow decay, where its terms (~1 / decay rate) cancel out
+        Parameters params;
+        params.accelMode = AccelMode_Natural;
+        params.accel = 0.0002f;
+        params.exponent = 2;
+        params.midpoint = 0;
+        params.useSmoothing = true;
+        CachedFunction natural(0.1f, &params);
+        natural.PreCacheConstants();
+        for (double x: {0.5, 1.0, 2.0, 5.0, 20.0}) {
+            double decay_rate = params.accel / (params.exponent - 1.0);
+            double expected = 1 + (params.exponent - 1.0) * (std::expm1(-decay_rate * x) / decay_rate + x) / x;
+            supervisor.Validate(std::fabs(natural.EvalFuncAt(x) - expected) / expected < 2e-6);
+        }
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the regression tests\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+namespace {
+    struct SweepAxis {
+        float min, max;
+        int steps;
+        bool log; // Log spaced, for the parameters that span a few orders of magnitude
+
+        float At(int i) const {
+            if (steps <= 1)
+                return min;
+            float t = static_cast<float>(i) / static_cast<float>(steps - 1);
+            return log ? min * std::pow(max / min, t) : min + t * (max - min);
+        }
+    };
+
+    struct SweepGrid {
+        AccelMode mode;
+        SweepAxis acceleration, exponent, midpoint, motivity;
+        bool smoothing; // Both with and without
+        float range_max;
+    };
+}
+
+bool Tests::TestSweeps(ThreadPool &pool, int density) {
+    static_assert(AccelMode_Count == 10);
+
+    // The parameter ranges people actually use, see the basic tests for what they mean in every mode
+    static const SweepGrid grids[] = {
+        {AccelMode_Linear, {0.0001f, 5, 48, true}, {1, 1, 1}, {0, 20, 16}, {1, 1, 1}, true, BASIC_TEST_RANGE_MAX},
+        // The smallest exponents overflow the offset's (and the smooth cap's) division, update_constants() rejects those
+        {AccelMode_Power, {0.01f, 50, 24, true}, {0.01f, 1, 16, true}, {0.1f, 1, 8}, {1.5f, 5, 4}, true,
+         BASIC_TEST_RANGE_MAX},
+        {AccelMode_Classic, {0.001f, 0.5f, 32, true}, {1.5f, 9, 16}, {0, 10, 8}, {1, 1, 1}, true, BASIC_TEST_RANGE_MAX},
+        {AccelMode_Motivity, {1.1f, 10, 64, true}, {1, 1, 1}, {0, 20, 16}, {1, 1, 1}, false, BASIC_TEST_RANGE_MAX},
+        {AccelMode_Synchronous, {1, 20, 16, true}, {0.5f, 20, 12, true}, {0.1f, 4, 8, true}, {1.1f, 3, 8}, true,
+         BASIC_TEST_RANGE_MAX},
+        {AccelMode_Natural, {0.01f, 1.5f, 32, true}, {1.5f, 10, 16}, {0, 10, 8}, {1, 1, 1}, true,
+         BASIC_TEST_RANGE_MAX},
+        {AccelMode_Jump, {0.5f, 10, 32, true}, {0.01f, 1, 16, true}, {0.01f, 20, 8, true}, {1, 1, 1}, true,
+         BASIC_TEST_RANGE_MAX},
+    };
+
+    bool passed = true;
+
+    for (const auto &grid: grids) {
+        const std::string name = "Sweep of " + AccelMode2String(grid.mode);
+        TestSupervisor supervisor{name.c_str()};
+        supervisor.NextTest();
+
+        auto scaled = [density](SweepAxis axis) {
+            if (axis.steps > 1)
+                axis.steps *= density;
+            return axis;
+        };
+        const SweepAxis acceleration = scaled(grid.acceleration), exponent = scaled(grid.exponent),
+                midpoint = scaled(grid.midpoint), motivity = scaled(grid.motivity);
+        const int speed_steps = SWEEP_TEST_STEPS * density;
+        const size_t profile_count = static_cast<size_t>(acceleration.steps) * exponent.steps * midpoint.steps *
+                                     motivity.steps * (grid.smoothing ? 2 : 1);
+
+        std::atomic<unsigned long long> tested{0}, rejected{0}, failed{0};
+        std::mutex report_mutex;
+
+        pool.ParallelFor(profile_count, [&](size_t job) {
+            // Unpack the grid point
+            size_t rest = job;
+            const bool smoothing = grid.smoothing && rest % 2;
+            if (grid.smoothing)
+                rest /= 2;
+            const float mot = motivity.At(static_cast<int>(rest % motivity.steps));
+            rest /= motivity.steps;
+            const float mid = midpoint.At(static_cast<int>(rest % midpoint.steps));
+            rest /= midpoint.steps;
+            const float exp = exponent.At(static_cast<int>(rest % exponent.steps));
+            rest /= exponent.steps;
+            const float acc = acceleration.At(static_cast<int>(rest));
+
+            TestManager::SetAccelMode(grid.mode);
+            TestManager::SetAcceleration(acc);
+            TestManager::SetExponent(exp);
+            TestManager::SetMidpoint(mid);
+            TestManager::SetMotivity(mot);
+            TestManager::SetUseSmoothing(smoothing);
+            TestManager::UpdateModesConstants();
+
+            // Whatever either side refuses never reaches the driver
+            if (!TestManager::ValidateConstants() || !TestManager::ValidateFunctionGUI()) {
+                rejected++;
+                return;
+            }
+
+            unsigned long long bad = 0;
+            float first_bad = -1;
+            // No movement never reaches the modes, so the sweep starts at the first step
+            for (int i = 1; i <= speed_steps; i++) {
+                float value = static_cast<float>(i) * grid.range_max / speed_steps;
+                float expected = TestManager::EvalFloatFunc(value);
+
+                // Past what the GUI lets through (the curve is steep enough to overflow the fixed point there)
+                if (!(expected >= 0 && expected < 1e5f))
+                    continue;
+
+                auto res = TestManager::Accel(value);
+                if (!IsAccelValueGood(res) || !IsCloseEnoughRelative(res, expected, SWEEP_TEST_TOLERANCE)) {
+                    if (bad++ == 0)
+                        first_bad = value;
+                }
+            }
+
+            tested++;
+            if (bad && failed++ == 0) {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                fprintf(stderr, "First mismatch: acceleration %g, exponent %g, midpoint %g, motivity %g, smoothing %d, "
+                                "at speed %g (driver %g, GUI %g)\n", acc, exp, mid, mot, smoothing, first_bad,
+                        FP64_ToFloat(TestManager::Accel(first_bad)), TestManager::EvalFloatFunc(first_bad));
+            }
+        });
+
+        printf("%llu profiles tested (%llu rejected), %llu mismatched, %d speeds each, %u threads\n",
+               tested.load(), rejected.load(), failed.load(), speed_steps, pool.Size());
+        supervisor.Validate(failed == 0);
+        passed &= supervisor.GetResult();
+    }
+
+    return passed;
+}
+
 bool Tests::TestFixedPointArithmetic() {
     TestSupervisor supervisor{"Arithmetic Test"};
 
@@ -995,6 +1206,24 @@ bool Tests::TestFixedPointArithmetic() {
                 //printf("(%f, %i), %f,%f,%f\n", x1, x2, FP64_ToFloat(val), std::scalbln(x1, x2), FP64_ToFloat(val) - std::scalbln(x1, x2));
             }
         }
+
+        supervisor.NextTest();
+        // Printed values read back exactly, with no more decimals than it takes
+        std::mt19937_64 rng(42);
+        char buf[32];
+        for (int i = 0; i < BASIC_TEST_STEPS; i++) {
+            FP_LONG val = static_cast<FP_LONG>(rng() >> (i % 40)) * (i % 2 ? -1 : 1), parsed = 0;
+            FP64_ToStringExact(val, buf);
+            supervisor.Validate(FP64_FromString(buf, &parsed) && parsed == val);
+        }
+        for (const char *text: {"0.1", "-0.1", "2.0", "0.000001", "1.000001", "123.456789", "-2147483647.5"}) {
+            FP_LONG val = 0;
+            FP64_FromString(text, &val);
+            FP64_ToStringExact(val, buf);
+            supervisor.Validate(std::string(buf) == text);
+        }
+        FP64_ToStringExact(INT64_MIN, buf);
+        supervisor.Validate(std::string(buf) == "-2147483648.0");
     } catch (std::exception &ex) {
         fprintf(stderr, "Exception: %s during arithmetic\n", ex.what());
         supervisor.result = false;
@@ -1003,6 +1232,757 @@ bool Tests::TestFixedPointArithmetic() {
     return supervisor.GetResult();
 }
 
+namespace {
+    std::string GetParam(const char *name) {
+        char buf[YEETACCEL_PARAM_BUF_LEN];
+        int len = yeetaccel_param_get(name, buf);
+        return len >= 0 ? std::string(buf, len) : std::string();
+    }
+
+    unsigned long long GetVersion() {
+        return std::stoull(GetParam("profile_version"));
+    }
+
+    // The profile as the GUI writes it back (see EvaluateProfile() in gui/DriverHelper.cpp)
+    std::string WithoutSlotAndVersion(const std::string &profile) {
+        std::string filtered, line;
+        std::stringstream lines(profile);
+        while (std::getline(lines, line)) {
+            if (line.rfind("Slot=", 0) != 0 && line.rfind("Version=", 0) != 0)
+                filtered += line + '\n';
+        }
+        return filtered;
+    }
+}
+
+bool Tests::TestParameterInterface() {
+    TestSupervisor supervisor{"Parameter Interface"};
+
+    try {
+        supervisor.NextTest();
+        yeetaccel_set_quiet(true); // The invalid writes are expected to fail
+        supervisor.Validate(yeetaccel_init() == 0);
+
+        // Whole profile in one write, keys not given keep their values
+        unsigned long long version = GetVersion();
+        supervisor.Validate(yeetaccel_param_set("profile", "AccelerationMode=1\nAcceleration=0.5\nSensitivity=2\n") == 0);
+        std::string profile = GetParam("profile");
+        supervisor.Validate(profile.find("AccelerationMode=1\n") != std::string::npos);
+        supervisor.Validate(profile.find("Acceleration=0.5\n") != std::string::npos);
+        supervisor.Validate(profile.find("Sensitivity=2.0\n") != std::string::npos);
+        supervisor.Validate(GetVersion() == version + 1);
+        // Mirrored in the legacy parameters
+        supervisor.Validate(GetParam("Acceleration").rfind("0.5", 0) == 0);
+
+        supervisor.NextTest();
+        // Rejected as a whole, nothing changes
+        version = GetVersion();
+        supervisor.Validate(yeetaccel_param_set("profile", "Acceleration=0.1\nFoo=1\n") == -EINVAL);
+        supervisor.Validate(yeetaccel_param_set("profile", "AccelerationMode=42\n") == -EINVAL);
+        supervisor.Validate(yeetaccel_param_set("profile", "LutSize=3\nLutDataBuf=1,1;2,2;\n") == -EINVAL);
+        supervisor.Validate(yeetaccel_param_set("profile", ("Version=" + std::to_string(version)).c_str()) == -EINVAL);
+        supervisor.Validate(yeetaccel_param_set("profile_version", "100") == -EACCES);
+        // Too long to arrive in a single write
+        std::string too_long = "Acceleration=0.1\n#" + std::string(YEETACCEL_PARAM_BUF_LEN, ' ');
+        supervisor.Validate(yeetaccel_param_set("profile", too_long.c_str()) == -E2BIG);
+        // Short enough to write, but not to read back (printed exactly, with 10 decimals, and a '.0' for the integers)
+        std::string lut = "LutDataBuf=";
+        for (int i = 0; i < MAX_LUT_ARRAY_SIZE; i++)
+            lut += "-1000000000.123457," + std::to_string(-1000000000 + i) + ";";
+        supervisor.Validate(lut.size() < YEETACCEL_PARAM_BUF_LEN - 1);
+        supervisor.Validate(yeetaccel_param_set("profile", lut.c_str()) == -E2BIG);
+        supervisor.Validate(GetVersion() == version);
+        supervisor.Validate(GetParam("profile") == profile);
+
+        supervisor.NextTest();
+        // Slots, switching doesn't touch the profiles
+        supervisor.Validate(yeetaccel_param_set("profile", "Slot=2\nAccelerationMode=0\nSensitivity=3\n") == 0);
+        supervisor.Validate(GetParam("profile") == profile);
+        supervisor.Validate(yeetaccel_param_set("active_profile", "5") == -ENOENT);
+        supervisor.Validate(yeetaccel_param_set("active_profile", "8") == -EINVAL);
+        supervisor.Validate(yeetaccel_param_set("active_profile", "2") == 0);
+        supervisor.Validate(GetParam("active_profile") == "2\n");
+        supervisor.Validate(GetParam("profile").rfind("Slot=2\n", 0) == 0);
+        supervisor.Validate(GetParam("Sensitivity").rfind("3", 0) == 0);
+
+        supervisor.NextTest();
+        // No curve, so the multiplier is the sensitivity at every speed
+        FP_LONG speeds[BASIC_TEST_STEPS_REDUCED], mults[BASIC_TEST_STEPS_REDUCED];
+        for (int i = 0; i < BASIC_TEST_STEPS_REDUCED; i++)
+            speeds[i] = FP64_FromInt(i * 2);
+        supervisor.Validate(accel_eval(speeds, mults, BASIC_TEST_STEPS_REDUCED) == 0);
+        for (FP_LONG mult: mults)
+            supervisor.Validate(IsCloseEnough(mult, 3));
+
+        supervisor.NextTest();
+        // The legacy interface, one parameter at a time then 'update'
+        supervisor.Validate(yeetaccel_param_set("Sensitivity", "1.5\n") == 0);
+        supervisor.Validate(GetParam("profile").find("Sensitivity=3.0\n") != std::string::npos);
+        supervisor.Validate(yeetaccel_param_set("update", "1\n") == 0);
+        supervisor.Validate(GetParam("profile").find("Sensitivity=1.5\n") != std::string::npos);
+        supervisor.Validate(accel_eval(speeds, mults, 1) == 0 && IsCloseEnough(mults[0], 1.5f));
+
+        supervisor.NextTest();
+        // A profile read back and written again is the very same profile, down to the last bit (the GUI relies on it)
+        supervisor.Validate(yeetaccel_param_set("profile", "AccelerationMode=5\nAcceleration=0.0123456789123\n"
+                                                           "Exponent=1.7777777777\nMidpoint=3.3333333333\n"
+                                                           "Sensitivity=1.1\nOffset=0.3\nUseSmoothing=1\n") == 0);
+        profile = GetParam("profile");
+        supervisor.Validate(accel_eval(speeds, mults, BASIC_TEST_STEPS_REDUCED) == 0);
+        FP_LONG reread[BASIC_TEST_STEPS_REDUCED];
+        supervisor.Validate(yeetaccel_param_set("profile", WithoutSlotAndVersion(profile).c_str()) == 0);
+        supervisor.Validate(accel_eval(speeds, reread, BASIC_TEST_STEPS_REDUCED) == 0);
+        supervisor.Validate(std::equal(mults, mults + BASIC_TEST_STEPS_REDUCED, reread));
+        supervisor.Validate(WithoutSlotAndVersion(GetParam("profile")) == WithoutSlotAndVersion(profile));
+
+        supervisor.NextTest();
+        // Every device carries its own remainder (0.4 counts a report here)
+        supervisor.Validate(yeetaccel_param_set("profile", "AccelerationMode=0\nSensitivity=0.4\n") == 0);
+        accel_state first{}, second{};
+        int x = 1, y = 0;
+        supervisor.Validate(accelerate(ACCEL_SLOT_ACTIVE, &first, &x, &y) == 0 && x == 0);
+        x = 1;
+        supervisor.Validate(accelerate(ACCEL_SLOT_ACTIVE, &second, &x, &y) == 0 && x == 0);
+        x = 1;
+        supervisor.Validate(accelerate(ACCEL_SLOT_ACTIVE, &first, &x, &y) == 0 && x == 1);
+
+        supervisor.NextTest();
+        // The GUI keeps floats and writes them with 6 decimals: applying what it read from the driver changes nothing
+        std::mt19937 gen(7);
+        auto random = [&gen](float min, float max) { return std::uniform_real_distribution<float>(min, max)(gen); };
+        for (int i = 0; i < BASIC_TEST_STEPS_REDUCED; i++) {
+            Parameters params;
+            params.accelMode = i % 2 ? AccelMode_Classic : AccelMode_Linear;
+            params.sens = random(0.1f, 5);
+            params.sensY = random(0.1f, 5);
+            params.use_anisotropy = true;
+            params.outCap = random(0, 100);
+            params.inCap = random(0, 200);
+            params.offset = random(0, 10);
+            params.preScale = random(0.1f, 5);
+            params.accel = random(0, 1);
+            params.exponent = random(2, 4);
+            params.midpoint = random(1, 20);
+            params.motivity = random(1, 3);
+            params.rotation = random(-180, 180);
+            params.as_threshold = random(0, 10);
+            params.as_angle = random(0, 90);
+            params.LUT_size = 1 + i % 16;
+            for (int j = 0; j < params.LUT_size; j++) {
+                params.LUT_data_x[j] = j + random(0, 1);
+                params.LUT_data_y[j] = random(0, 10);
+            }
+
+            std::vector<DriverHelper::ParameterWrite> writes;
+            supervisor.Validate(params.BuildWrites(writes));
+            const std::string written = writes.back().value;
+            supervisor.Validate(yeetaccel_param_set("profile", written.c_str()) == 0);
+            profile = GetParam("profile");
+
+            Parameters read;
+            std::string lut_text;
+            supervisor.Validate(DriverHelper::ParseDriverProfile(profile, read, lut_text));
+            read.use_anisotropy = read.sensY != read.sens;
+            writes.clear();
+            supervisor.Validate(read.BuildWrites(writes) && writes.back().value == written);
+        }
+
+        yeetaccel_exit();
+        yeetaccel_set_quiet(false);
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the parameter interface test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestProfileVerifier() {
+    TestSupervisor supervisor{"Profile Verifier"};
+
+    auto make = [](AccelMode mode, double acceleration, double exponent, double midpoint, double motivity,
+                   bool smoothing) {
+        accel_profile profile{};
+        profile.AccelerationMode = mode;
+        profile.Sensitivity = profile.SensitivityY = profile.PreScale = FP64_1;
+        profile.Acceleration = FP64_FromDouble(acceleration);
+        profile.Exponent = FP64_FromDouble(exponent);
+        profile.Midpoint = FP64_FromDouble(midpoint);
+        profile.Motivity = FP64_FromDouble(motivity);
+        profile.UseSmoothing = smoothing;
+        return profile;
+    };
+
+    try {
+        supervisor.NextTest();
+        // Used to be divide errors in update_constants() (found by YeetMouseLatencySearch)
+        yeetaccel_set_quiet(true);
+        accel_profile power = make(AccelMode_Power, 0.048687, 0.075147, 0.144752, 13.356428, true);
+        supervisor.Validate(update_constants(&power) == -EINVAL && power.AccelerationMode == AccelMode_Current);
+        accel_profile classic = make(AccelMode_Classic, 0.041212, 0.914908, 1.133187, 1.118240, true);
+        supervisor.Validate(update_constants(&classic) == -EINVAL && classic.AccelerationMode == AccelMode_Current);
+
+        supervisor.NextTest();
+        // A LUT extrapolated past a tiny last segment can't reach the fastest speeds
+        accel_profile lut = make(AccelMode_Lut, 0, 0, 0, 0, false);
+        lut.LutSize = 3;
+        lut.LutData_x[0] = FP64_1, lut.LutData_x[1] = FP64_10, lut.LutData_x[2] = FP64_10 + 1;
+        lut.LutData_y[0] = FP64_1, lut.LutData_y[1] = FP64_10, lut.LutData_y[2] = FP64_10;
+        supervisor.Validate(update_constants(&lut) == -EINVAL);
+        lut.AccelerationMode = AccelMode_Lut;
+        lut.LutData_x[2] = FP64_100;
+        supervisor.Validate(update_constants(&lut) == 0);
+        // Right at the first point, used to read before the table
+        supervisor.Validate(accel_lut(&lut, FP64_1) == FP64_1);
+        yeetaccel_set_quiet(false);
+
+        supervisor.NextTest();
+        // Reports at the same time (dt = 0) are taken as ACCEL_MIN_DT_NS apart
+        accel_profile linear = make(AccelMode_Linear, 0.05, 1, 0, 1, false);
+        supervisor.Validate(update_constants(&linear) == 0);
+        accel_state state{0, 0, 1000000000}, expected_state{0, 0, 1000000000 - ACCEL_MIN_DT_NS};
+        int x = 3, y = -2, expected_x = 3, expected_y = -2;
+        accel_pipeline(&linear, &state, 1000000000, &x, &y);
+        accel_pipeline(&linear, &expected_state, 1000000000, &expected_x, &expected_y);
+        supervisor.Validate(x == expected_x && y == expected_y);
+
+        supervisor.NextTest();
+        // Random profiles of every mode: the accepted ones get evaluated over every speed the pipeline can produce,
+        // a divide error would take the whole test run down
+        std::mt19937_64 rng(1234);
+        auto log_uniform = [&rng](double min, double max) {
+            return std::exp(std::uniform_real_distribution<double>(std::log(min), std::log(max))(rng));
+        };
+        const double max_speed = 46341.0 * 1000000 / ACCEL_MIN_DT_NS;
+        int accepted = 0;
+        for (int m = AccelMode_Linear; m <= AccelMode_Jump; m++) {
+            for (int i = 0; i < 2000; i++) {
+                accel_profile profile = make(static_cast<AccelMode>(m), log_uniform(1e-4, 50), log_uniform(1e-3, 20),
+                                             log_uniform(1e-3, 200), 1 + log_uniform(1e-3, 20), rng() & 1);
+                yeetaccel_set_quiet(true);
+                bool valid = update_constants(&profile) == 0;
+                yeetaccel_set_quiet(false);
+                if (!valid)
+                    continue;
+
+                accepted++;
+                for (int step = 0; step <= 64; step++) {
+                    FP_LONG speed = FP64_FromDouble(FP64_ToDouble(ACCEL_MIN_SPEED) *
+                                                    std::pow(max_speed / FP64_ToDouble(ACCEL_MIN_SPEED), step / 64.0));
+                    (void) accel_stage_curve(&profile, speed);
+                }
+            }
+        }
+        // Most of them are fine
+        supervisor.Validate(accepted > 7000);
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the profile verifier test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestNarrowKernels() {
+    TestSupervisor supervisor{"Narrow Kernels"};
+
+    auto linear = [](double acceleration, bool smoothing, double midpoint) {
+        accel_profile profile{};
+        profile.AccelerationMode = AccelMode_Linear;
+        profile.Sensitivity = profile.SensitivityY = profile.PreScale = FP64_1;
+        profile.Acceleration = FP64_FromDouble(acceleration);
+        profile.UseSmoothing = smoothing;
+        profile.Midpoint = FP64_FromDouble(midpoint);
+        if (update_constants(&profile) != 0)
+            throw std::runtime_error("Linear profile rejected");
+        return profile;
+    };
+
+    try {
+        supervisor.NextTest();
+        // Common settings get one
+        supervisor.Validate(linear(0.05, false, 0).consts.narrow_limit >= FP64_FromInt(1024));
+        supervisor.Validate(linear(0.05, true, 3).consts.narrow_limit >= FP64_FromInt(1024));
+        supervisor.Validate(linear(2, false, 0).consts.narrow_limit >= FP64_FromInt(8));
+        // No precision left for them
+        supervisor.Validate(linear(100, false, 0).consts.narrow_limit == 0);
+        supervisor.Validate(linear(0.05, true, 0.0001).consts.narrow_limit == 0);
+
+        supervisor.NextTest();
+        // Within 2^-NARROW_PRECISION_BITS of the smallest multiplier, everywhere they are used
+        for (double acceleration: {0.0001, 0.003, 0.05, 0.4, 0.5, 1.0, 2.5, 20.0}) {
+            for (double midpoint: {0.0, 0.3, 1.0, 1.5, 4.0, 40.0}) {
+                accel_profile profile = linear(acceleration, midpoint != 0, midpoint);
+                accel_profile full = profile;
+                full.consts.narrow_limit = 0;
+                if (profile.consts.narrow_limit == 0)
+                    continue;
+
+                FP_LONG min_mult = profile.consts.sign < 0 ? profile.Midpoint : FP64_1;
+                FP_LONG tolerance = std::max<FP_LONG>(min_mult >> 24, 1);
+                for (int i = 0; i < BASIC_TEST_STEPS; i++) {
+                    // Log-spaced up to the limit, the smallest speeds lose the most bits
+                    FP_LONG speed = FP64_FromDouble(FP64_ToDouble(profile.consts.narrow_limit) *
+                                                    std::pow(2.0, -20.0 * i / BASIC_TEST_STEPS));
+                    supervisor.Validate(std::abs(accel_linear(&profile, speed) - accel_linear(&full, speed)) <=
+                                        tolerance);
+                }
+            }
+        }
+
+        supervisor.NextTest();
+        // And the Q32.32 math is used from the limit on
+        accel_profile profile = linear(0.05, true, 3);
+        accel_profile full = profile;
+        full.consts.narrow_limit = 0;
+        for (FP_LONG speed: {profile.consts.narrow_limit, profile.consts.narrow_limit * 3, -FP64_1})
+            supervisor.Validate(accel_linear(&profile, speed) == accel_linear(&full, speed));
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the narrow kernel test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestFixedProfile() {
+    TestSupervisor supervisor{"Fixed Profile"};
+
+    try {
+        supervisor.NextTest();
+        // The generated constants are the ones the driver computes
+        const accel_profile *fixed = fixed_profile();
+        accel_profile profile = *fixed;
+        profile.consts = {};
+        supervisor.Validate(update_constants(&profile) == 0);
+        supervisor.Validate(profile.AccelerationMode == fixed->AccelerationMode);
+        supervisor.Validate(memcmp(&profile.consts, &fixed->consts, sizeof(profile.consts)) == 0);
+
+        supervisor.NextTest();
+        // The profile is the one in config.h, and the specialized curve matches the regular one
+        supervisor.Validate(fixed->AccelerationMode == ACCELERATION_MODE);
+        supervisor.Validate(IsCloseEnough(fixed->Sensitivity, SENSITIVITY));
+        FP_LONG speeds[BASIC_TEST_STEPS], mults[BASIC_TEST_STEPS], fixed_mults[BASIC_TEST_STEPS];
+        for (int i = 0; i < BASIC_TEST_STEPS; i++) {
+            speeds[i] = FP64_FromInt(i) * BASIC_TEST_RANGE_MAX / BASIC_TEST_STEPS;
+            FP_LONG delta_x = FP64_1, delta_y = FP64_1;
+            accel_stage_sensitivity(&profile, accel_stage_curve(&profile, accel_stage_speed(&profile, speeds[i], 0, FP64_1)),
+                                    &delta_x, &delta_y);
+            mults[i] = delta_x;
+        }
+        fixed_profile_eval(speeds, fixed_mults, BASIC_TEST_STEPS);
+        supervisor.Validate(memcmp(mults, fixed_mults, sizeof(mults)) == 0);
+
+        supervisor.NextTest();
+        // The specialized pipeline gives the exact same output, carry included
+        accel_state state{}, fixed_state{};
+        long long now_ns = 0;
+        for (int i = 0; i < BASIC_TEST_STEPS; i++) {
+            int x = (i * 7) % 61 - 30, y = (i * 3) % 23 - 11;
+            int fixed_x = x, fixed_y = y;
+            now_ns += 125000 + (i % 5) * 250000; // 8 kHz to ~1 kHz
+            accel_pipeline(&profile, &state, now_ns, &x, &y);
+            fixed_profile_pipeline(&fixed_state, now_ns, &fixed_x, &fixed_y);
+            supervisor.Validate(x == fixed_x && y == fixed_y);
+        }
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the fixed profile test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestFunctionBatch() {
+    TestSupervisor supervisor{"Function Batch"};
+
+    try {
+        supervisor.NextTest();
+        // Bit for bit the scalar evaluation, for every mode, with and without smoothing and the caps
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> speed(0, BASIC_TEST_RANGE_MAX);
+        float xs[PLOT_POINTS], out[PLOT_POINTS];
+        for (float &x: xs)
+            x = speed(rng);
+
+        for (int mode = 0; mode < AccelMode_Count; mode++) {
+            for (int variant = 0; variant < 4; variant++) {
+                Parameters params;
+                params.accelMode = static_cast<AccelMode>(mode);
+                params.accel = mode == AccelMode_Linear ? 0.05f : 2;
+                params.exponent = mode == AccelMode_Classic || mode == AccelMode_Natural ? 2 : 0.4f;
+                params.useSmoothing = variant & 1;
+                params.inCap = variant & 2 ? 60 : 0;
+                params.outCap = variant & 2 ? 2.5f : 0;
+                params.preScale = 0.8f;
+                params.LUT_size = 3;
+                params.LUT_data_x[0] = 0, params.LUT_data_x[1] = 10, params.LUT_data_x[2] = 100;
+                params.LUT_data_y[0] = 1, params.LUT_data_y[1] = 2, params.LUT_data_y[2] = 2.5;
+
+                CachedFunction function(1, &params);
+                function.PreCacheConstants();
+                function.EvalFuncBatch(xs, out, PLOT_POINTS);
+
+                bool same = true;
+                for (int i = 0; i < PLOT_POINTS; i++) {
+                    float expected = function.EvalFuncAt(xs[i]);
+                    same &= memcmp(&expected, &out[i], sizeof(float)) == 0;
+                }
+                supervisor.Validate(same);
+            }
+        }
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the function batch test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestAdaptiveSampling() {
+    TestSupervisor supervisor{"Adaptive Sampling"};
+
+    auto make = [](AccelMode mode, float accel, float exponent, float midpoint, bool smoothing) {
+        Parameters params;
+        params.accelMode = mode;
+        params.accel = accel;
+        params.exponent = exponent;
+        params.midpoint = midpoint;
+        params.motivity = 2;
+        params.useSmoothing = smoothing;
+        params.offset = 2;
+        params.sensY = 0.5f;
+        return params;
+    };
+
+    try {
+        Parameters curves[] = {
+            make(AccelMode_Jump, 2, 0.1f, 15, false), make(AccelMode_Motivity, 2, 1, 20, false),
+            make(AccelMode_Power, 2, 0.4f, 1, false), make(AccelMode_Natural, 0.1f, 2, 5, true)
+        };
+
+        supervisor.NextTest();
+        // Sorted, over the whole range, and every sample is the curve itself
+        for (auto &params: curves) {
+            CachedFunction function(1, &params);
+            function.PreCacheConstants();
+            PlotSamples samples;
+            function.SampleAdaptive(0, 150, samples);
+
+            bool exact = samples.x.size() == samples.y.size() && samples.y.size() == samples.y_aniso.size() &&
+                         samples.x.front() == 0 && samples.x.back() == 150 &&
+                         std::is_sorted(samples.x.begin(), samples.x.end());
+            for (size_t i = 0; exact && i < samples.x.size(); i++) {
+                exact = samples.y[i] == function.EvaluateFuncWithGlobalParameters(samples.x[i]) &&
+                        samples.y_aniso[i] == samples.y[i] * params.sensY;
+            }
+            supervisor.Validate(exact);
+        }
+
+        supervisor.NextTest();
+        // The straight lines between the samples stay close to the curve everywhere, not just at the samples
+        for (auto &params: curves) {
+            CachedFunction function(1, &params);
+            function.PreCacheConstants();
+            PlotSamples samples;
+            function.SampleAdaptive(0, 150, samples);
+
+            float worst = 0;
+            size_t segment = 0;
+            for (int i = 0; i <= 20000; i++) {
+                float x = 150.f * i / 20000;
+                while (segment + 2 < samples.x.size() && samples.x[segment + 1] < x)
+                    segment++;
+                float t = (x - samples.x[segment]) / (samples.x[segment + 1] - samples.x[segment]);
+                float interpolated = lerp(samples.y[segment], samples.y[segment + 1], t);
+                worst = std::max(worst, std::fabs(interpolated - function.EvaluateFuncWithGlobalParameters(x)));
+            }
+            supervisor.Validate(worst < 0.01f);
+        }
+
+        supervisor.NextTest();
+        // Dense where the curve bends, nothing added to a straight line
+        {
+            CachedFunction jump(1, &curves[0]);
+            jump.PreCacheConstants();
+            PlotSamples samples;
+            jump.SampleAdaptive(0, 150, samples);
+            // The step is at 15 + the offset
+            auto count_in = [&samples](float from, float to) {
+                return std::count_if(samples.x.begin(), samples.x.end(), [=](float x) { return x >= from && x < to; });
+            };
+            supervisor.Validate(count_in(12, 22) > 4 * count_in(100, 110));
+
+            Parameters line = make(AccelMode_Linear, 0.01f, 1, 0, false);
+            line.offset = 0;
+            CachedFunction linear(1, &line);
+            linear.PreCacheConstants();
+            linear.SampleAdaptive(10, 150, samples);
+            // The first level checks every interval
+            supervisor.Validate(samples.x.size() == 2 * ADAPTIVE_INITIAL_POINTS + 1);
+        }
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the adaptive sampling test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestCurveWorker() {
+    TestSupervisor supervisor{"Curve Worker"};
+
+    // What the GUI did on the render thread before
+    auto precached = [](const Parameters &params, float x_stride) {
+        Parameters copy = params;
+        CachedFunction function(x_stride, &copy);
+        function.PreCacheFunc();
+        function.params = nullptr;
+        return function;
+    };
+    auto same = [](const CachedFunction &a, const CachedFunction &b) {
+        return a.isValid == b.isValid && a.x_stride == b.x_stride &&
+               memcmp(a.values, b.values, sizeof(a.values)) == 0 &&
+               memcmp(a.values_y, b.values_y, sizeof(a.values_y)) == 0;
+    };
+
+    try {
+        Parameters params[AccelMode_Count];
+        CachedFunction functions[AccelMode_Count];
+        const float x_stride = static_cast<float>(BASIC_TEST_RANGE_MAX) / PLOT_POINTS;
+        for (int mode = 0; mode < AccelMode_Count; mode++) {
+            params[mode].accelMode = static_cast<AccelMode>(mode);
+            params[mode].use_anisotropy = true;
+            params[mode].sensY = 0.5f;
+            params[mode].accel = mode == AccelMode_Linear ? 0.05f : 2;
+            params[mode].exponent = mode == AccelMode_Classic || mode == AccelMode_Natural ? 2 : 0.4f;
+            params[mode].LUT_size = 3;
+            params[mode].LUT_data_x[0] = 0, params[mode].LUT_data_x[1] = 10, params[mode].LUT_data_x[2] = 100;
+            params[mode].LUT_data_y[0] = 1, params[mode].LUT_data_y[1] = 2, params[mode].LUT_data_y[2] = 2.5;
+            functions[mode] = CachedFunction(x_stride, &params[mode]);
+        }
+        CurveWorker worker(functions, AccelMode_Count);
+
+        supervisor.NextTest();
+        // Every mode, the same values as computed in place
+        for (int mode = 1; mode < AccelMode_Count; mode++)
+            worker.MarkDirty(mode);
+        for (int mode = 1; mode < AccelMode_Count; mode++) {
+            worker.Finish(mode);
+            supervisor.Validate(!worker.IsPending(mode) && functions[mode].params == &params[mode] &&
+                                same(functions[mode], precached(params[mode], x_stride)));
+        }
+        // Nothing was dirty
+        supervisor.Validate(functions[0].x_stride == x_stride && functions[0].values[PLOT_POINTS - 1] == 0);
+        // No plot range, no samples
+        supervisor.Validate(functions[AccelMode_Jump].samples.x.empty());
+
+        // The samples of the plotted range come with the function
+        worker.SetPlotRange(0, 150);
+        worker.MarkDirty(AccelMode_Jump);
+        worker.Finish(AccelMode_Jump);
+        const PlotSamples &samples = functions[AccelMode_Jump].samples;
+        supervisor.Validate(!samples.x.empty() && samples.x_min <= 0 && samples.x_max >= 150);
+
+        supervisor.NextTest();
+        // A drag: only the last parameters matter, the stride is published with the values
+        for (int i = 1; i <= 100; i++) {
+            params[AccelMode_Power].accel = 2 + i * 0.01f;
+            worker.MarkDirty(AccelMode_Power, i == 100 ? x_stride * 2 : 0);
+        }
+        worker.SetPriority({AccelMode_Power});
+        worker.Finish(AccelMode_Power);
+        supervisor.Validate(same(functions[AccelMode_Power], precached(params[AccelMode_Power], x_stride * 2)));
+        supervisor.Validate(worker.Publish() == 0);
+
+        supervisor.NextTest();
+        // The Synchronous table is reused for the parameters it doesn't depend on, and rebuilt for the rest
+        params[AccelMode_Synchronous].accel = 5;
+        params[AccelMode_Synchronous].motivity = 1.5f;
+        params[AccelMode_Synchronous].useSmoothing = true;
+        worker.MarkDirty(AccelMode_Synchronous);
+        params[AccelMode_Synchronous].sens = 2;
+        worker.MarkDirty(AccelMode_Synchronous);
+        worker.Finish(AccelMode_Synchronous);
+        supervisor.Validate(same(functions[AccelMode_Synchronous], precached(params[AccelMode_Synchronous], x_stride)));
+        params[AccelMode_Synchronous].motivity = 2;
+        worker.MarkDirty(AccelMode_Synchronous);
+        worker.Finish(AccelMode_Synchronous);
+        supervisor.Validate(same(functions[AccelMode_Synchronous], precached(params[AccelMode_Synchronous], x_stride)));
+
+        supervisor.NextTest();
+        // Every finished job wakes up the render loop
+        static std::atomic<int> notified{0};
+        worker.SetNotify([] { ++notified; });
+        worker.MarkDirty(AccelMode_Linear);
+        worker.Finish(AccelMode_Linear);
+        // Called right after the job is done, without the lock
+        for (int i = 0; i < 1000 && notified == 0; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        worker.SetNotify(nullptr);
+        supervisor.Validate(notified > 0);
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the curve worker test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestCurveLUTExport() {
+    TestSupervisor supervisor{"Curve LUT Export"};
+
+    // Increasing, apart, and within the curve
+    auto well_formed = [](const CustomCurve &curve, const double *xs, const double *ys, int size) {
+        if (size < 2 || size > MAX_LUT_ARRAY_SIZE || xs[0] != curve.points.front().x ||
+            xs[size - 1] != curve.points.back().x || ys[size - 1] != curve.points.back().y)
+            return false;
+        for (int i = 1; i < size; i++) {
+            if (xs[i] - xs[i - 1] < LUT_MIN_POINT_DIST * 0.999)
+                return false;
+        }
+        return true;
+    };
+
+    try {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> step(2, 40), value(0.3f, 4);
+        std::vector<CustomCurve> curves(1); // The default one first
+        for (int i = 0; i < 20; i++) {
+            CustomCurve curve;
+            curve.points.clear();
+            float x = 1 + step(rng) / 4;
+            for (int j = 0, n = 2 + i % 7; j < n; j++, x += step(rng))
+                curve.points.emplace_back(x, value(rng));
+            curve.SmoothBezier();
+            curve.ApplyCurveConstraints();
+            curves.push_back(curve);
+        }
+
+        double xs[MAX_LUT_ARRAY_SIZE], ys[MAX_LUT_ARRAY_SIZE];
+        double adaptive_xs[MAX_LUT_ARRAY_SIZE], adaptive_ys[MAX_LUT_ARRAY_SIZE];
+
+        supervisor.NextTest();
+        // Never worse than the adaptive placement
+        for (auto &curve: curves) {
+            int adaptive_size = curve.ExportCurveToLUT(adaptive_xs, adaptive_ys);
+            curve.LUT_placement = LUTPlacement_MinError;
+            int size = curve.ExportCurveToLUT(xs, ys);
+
+            // Down to what the export rounds off anyway, below that it takes the fewest points instead
+            double resolution = LUT_ERROR_RESOLUTION * *std::max_element(ys, ys + size);
+            supervisor.Validate(well_formed(curve, xs, ys, size));
+            supervisor.Validate(curve.LUTError(xs, ys, size) <=
+                                std::max(curve.LUTError(adaptive_xs, adaptive_ys, adaptive_size), resolution) + 1e-6);
+        }
+
+        supervisor.NextTest();
+        // A target error takes fewer points, and gets met
+        for (auto &curve: curves) {
+            curve.LUT_placement = LUTPlacement_MinError;
+            curve.LUT_target_error = 0;
+            int full_size = curve.ExportCurveToLUT(xs, ys);
+            double full_error = curve.LUTError(xs, ys, full_size);
+
+            curve.LUT_target_error = std::max(full_error * 20, 1e-3);
+            int size = curve.ExportCurveToLUT(xs, ys);
+            supervisor.Validate(well_formed(curve, xs, ys, size) && size <= full_size &&
+                                curve.LUTError(xs, ys, size) <= curve.LUT_target_error);
+        }
+
+        supervisor.NextTest();
+        // A straight line is just its ends
+        CustomCurve line;
+        line.points = {{5, 1}, {50, 2}};
+        line.control_points = {std::array<ImVec2, 2>{ImVec2{20, 1 + 15 / 45.f}, ImVec2{35, 1 + 30 / 45.f}}};
+        line.LUT_placement = LUTPlacement_MinError;
+        int size = line.ExportCurveToLUT(xs, ys);
+        supervisor.Validate(size == 2 && line.LUTError(xs, ys, size) < 1e-5);
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the curve LUT export test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
+bool Tests::TestCurveTessellation() {
+    TestSupervisor supervisor{"Curve Tessellation"};
+
+    // A new curve with the same points, nothing cached
+    auto fresh_copy = [](const CustomCurve &curve) {
+        CustomCurve copy;
+        copy.points = curve.points;
+        copy.control_points = curve.control_points;
+        return copy;
+    };
+
+    try {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> step(2, 40), value(0.3f, 4), nudge(-0.5f, 0.5f);
+        CustomCurve curve;
+        curve.points.clear();
+        float x = 2;
+        for (int j = 0; j < 12; j++, x += step(rng))
+            curve.points.emplace_back(x, value(rng));
+        curve.SmoothBezier();
+        curve.ApplyCurveConstraints();
+
+        supervisor.NextTest();
+        // All of it the first time, on the curve
+        supervisor.Validate(curve.UpdateLUT() == 11 && curve.UpdateLUT() == 0);
+        for (int i = 0; i < 11; i++) {
+            const ImVec2 &p0 = curve.points[i], &p1 = curve.control_points[i][0], &p2 = curve.control_points[i][1],
+                    &p3 = curve.points[i + 1];
+            for (int j = 0; j < BEZIER_FRAG_SEGMENTS; j++) {
+                double t = (double) j / (BEZIER_FRAG_SEGMENTS - 1), u = 1 - t;
+                double px = u * u * u * p0.x + 3 * u * u * t * p1.x + 3 * u * t * t * p2.x + t * t * t * p3.x;
+                double py = u * u * u * p0.y + 3 * u * u * t * p1.y + 3 * u * t * t * p2.y + t * t * t * p3.y;
+                const ImPlotPoint &p = curve.LUT_points[i * BEZIER_FRAG_SEGMENTS + j];
+                supervisor.Validate(std::fabs(p.x - px) < 1e-4 && std::fabs(p.y - py) < 1e-4);
+            }
+        }
+
+        supervisor.NextTest();
+        // Dragging a point only redoes the segments around it, and ends up the same as redoing all of them
+        double xs[MAX_LUT_ARRAY_SIZE], ys[MAX_LUT_ARRAY_SIZE], fresh_xs[MAX_LUT_ARRAY_SIZE], fresh_ys[MAX_LUT_ARRAY_SIZE];
+        curve.ExportCurveToLUT(xs, ys);
+        for (int drag = 0; drag < 50; drag++) {
+            int i = 1 + drag % 10;
+            curve.points[i].x += nudge(rng);
+            curve.points[i].y += nudge(rng);
+            curve.control_points[i][0].y += nudge(rng);
+            curve.ApplyCurveConstraints();
+
+            supervisor.Validate(curve.UpdateLUT() <= 2);
+            CustomCurve fresh = fresh_copy(curve);
+            fresh.UpdateLUT();
+            bool same = fresh.LUT_points.size() == curve.LUT_points.size();
+            for (size_t k = 0; same && k < fresh.LUT_points.size(); k++)
+                same = fresh.LUT_points[k].x == curve.LUT_points[k].x && fresh.LUT_points[k].y == curve.LUT_points[k].y;
+            supervisor.Validate(same);
+
+            // The cached arc lengths don't change the exported LUT either
+            int size = curve.ExportCurveToLUT(xs, ys);
+            int fresh_size = fresh.ExportCurveToLUT(fresh_xs, fresh_ys);
+            supervisor.Validate(size == fresh_size && std::equal(xs, xs + size, fresh_xs) &&
+                                std::equal(ys, ys + size, fresh_ys));
+        }
+
+        supervisor.NextTest();
+        // Adding a point redoes all of it
+        curve.points.insert(curve.points.begin() + 3, Ex_Vec2{(curve.points[2].x + curve.points[3].x) / 2, 1});
+        curve.SmoothBezier();
+        supervisor.Validate(curve.UpdateLUT() == 12 &&
+                            curve.LUT_points.size() == 12 * BEZIER_FRAG_SEGMENTS);
+    } catch (std::exception &ex) {
+        fprintf(stderr, "Exception: %s during the curve tessellation test\n", ex.what());
+        supervisor.result = false;
+    }
+
+    return supervisor.GetResult();
+}
+
 void Tests::TestSupervisor::Validate(bool res) {
     if (result && !res) // Prints only on the first occurrence
         printf(RED "Test failed!\n" RESET);
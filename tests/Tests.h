@@ -2,15 +2,19 @@
 #define TESTS_H
 
 
+#include <array>
 #include <vector>
 #include "../shared_definitions.h"
-#include "driver/config.h"
 #include "driver/FixedMath/Fixed64.h"
 #include <chrono>
 
 #define BASIC_TEST_STEPS 1000
 #define BASIC_TEST_STEPS_REDUCED 100
 #define BASIC_TEST_RANGE_MAX 150
+#define SWEEP_TEST_STEPS 512 // Speeds per profile of a sweep
+#define SWEEP_TEST_TOLERANCE 0.002f // Relative, the sweeps reach parameters the fixed point math is less precise for
+
+class ThreadPool;
 
 #define RESET   "\033[0m"
 #define RED     "\033[31m" // Red
@@ -46,6 +50,41 @@ public:
 
     static bool TestFixedPointArithmetic();
 
+    /// Regression tests of the math bugs fixed so far, one test per fix
+    static bool TestRegressions();
+    /// Dense parameter-grid sweeps of every parametric mode, compared against the GUI's implementation.
+    /// Every profile of the grid is an independent job on the pool (each worker has its own driver context).
+    /// @param density multiplies the number of steps along every axis of the grid
+    static bool TestSweeps(ThreadPool &pool, int density = 1);
+
+    /// The module parameters ('profile', slots, the legacy interface) and accel_eval(), running the driver's own accel.c
+    static bool TestParameterInterface();
+
+    /// The commit-time verification of the profiles: what can't be evaluated everywhere gets rejected, what gets through
+    /// can't trap at any speed the pipeline can produce
+    static bool TestProfileVerifier();
+
+    /// The narrow (64 bit) kernels picked by update_constants() against the Q32.32 math they replace
+    static bool TestNarrowKernels();
+
+    /// The fixed profile build (the profile in config.h generated as a constant) against the regular one
+    static bool TestFixedProfile();
+
+    /// The GUI's batch evaluation of the curves (CachedFunction::EvalFuncBatch()) against the scalar one
+    static bool TestFunctionBatch();
+
+    /// The plot's sampling of the curves (CachedFunction::SampleAdaptive())
+    static bool TestAdaptiveSampling();
+
+    /// The GUI's background curve evaluation against evaluating the curves in place
+    static bool TestCurveWorker();
+
+    /// The custom curve's LUT export (CustomCurve::ExportCurveToLUT()) with the error minimizing placement
+    static bool TestCurveLUTExport();
+
+    /// The custom curve's incremental tessellation (CustomCurve::UpdateLUT()) against tessellating it from scratch
+    static bool TestCurveTessellation();
+
 private:
     //static CachedFunction functions[AccelMode_Count];
 
@@ -0,0 +1,69 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#include "TestManager.h"
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto &worker: workers)
+        worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t job_count, const std::function<void(size_t)> &batch_job) {
+    if (job_count == 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &batch_job;
+    count = job_count;
+    next = 0;
+    busy = Size();
+    generation++;
+    wake.notify_all();
+
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::WorkerLoop() {
+    unsigned long long seen = 0;
+
+    while (true) {
+        const std::function<void(size_t)> *current;
+        size_t current_count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            current = job;
+            current_count = count;
+        }
+
+        // Every batch starts from a clean driver state, whatever the previous one left behind
+        TestManager::Initialize();
+
+        for (size_t i = next++; i < current_count; i = next++)
+            (*current)(i);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            done.notify_one();
+    }
+}
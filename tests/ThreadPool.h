@@ -0,0 +1,45 @@
+#ifndef YEETMOUSE_THREADPOOL_H
+#define YEETMOUSE_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// Fixed set of workers for running independent jobs (parameter sweeps) concurrently.
+/// Every worker has its own TestManager context, so jobs can freely use TestManager.
+///
+class ThreadPool {
+public:
+    /// 0 - one worker per hardware thread
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Runs job(i) for every i in [0, count), spread over the workers. Returns once all of them are done.
+    void ParallelFor(size_t count, const std::function<void(size_t)> &job);
+
+    unsigned Size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // The current batch
+    const std::function<void(size_t)> *job = nullptr;
+    size_t count = 0;
+    std::atomic<size_t> next{0};
+    unsigned busy = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
+
+#endif //YEETMOUSE_THREADPOOL_H
@@ -0,0 +1,210 @@
+#include "Trace.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TRACE_FLUSH_SIZE (1 << 16)
+
+static uint64_t ZigZagEncode(long long value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+TraceWriter::TraceWriter(const TraceHeader &header) : header(header), last_us(header.start_us) {
+    memcpy(this->header.magic, TRACE_MAGIC, sizeof(this->header.magic));
+    this->header.version = TRACE_VERSION;
+    this->header.header_size = sizeof(TraceHeader);
+    this->header.event_count = 0;
+
+    // In memory the header goes first, and is kept up to date by Data()
+    buffer.resize(sizeof(TraceHeader));
+}
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const char *path, const TraceHeader &header) {
+    Close();
+    *this = TraceWriter(header);
+    buffer.clear();
+    file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Can't create %s\n", path);
+        return false;
+    }
+
+    // Rewritten at the end, with the right count
+    return fwrite(&this->header, sizeof(TraceHeader), 1, file) == 1;
+}
+
+bool TraceWriter::Close() {
+    if (!file)
+        return true;
+
+    bool ok = Flush() && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(TraceHeader), 1, file) == 1;
+    ok &= fclose(file) == 0;
+    file = nullptr;
+    return ok;
+}
+
+bool TraceWriter::Flush() {
+    if (!file || buffer.empty())
+        return true;
+
+    bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    buffer.clear();
+    return ok;
+}
+
+void TraceWriter::PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<unsigned char>(value));
+}
+
+void TraceWriter::Write(uint64_t time_us, int x, int y) {
+    if (header.event_count++ == 0 && header.start_us == 0)
+        header.start_us = last_us = time_us;
+
+    // Clocks don't go back, but bunched up reports can come with the same timestamp
+    long long dt = time_us > last_us ? static_cast<long long>(time_us - last_us) : 0;
+    bool packed = x >= -8 && x <= 7 && y >= -8 && y <= 7;
+
+    PutVarint(ZigZagEncode(dt - last_dt) << 1 | packed);
+    if (packed)
+        buffer.push_back(static_cast<unsigned char>((x & 0x0f) | ((y & 0x0f) << 4)));
+    else {
+        PutVarint(ZigZagEncode(x));
+        PutVarint(ZigZagEncode(y));
+    }
+
+    last_us += dt;
+    last_dt = dt;
+
+    if (file && buffer.size() >= TRACE_FLUSH_SIZE)
+        Flush();
+}
+
+const std::vector<unsigned char> &TraceWriter::Data() {
+    if (!file)
+        memcpy(buffer.data(), &header, sizeof(TraceHeader));
+    return buffer;
+}
+
+TraceReader::~TraceReader() {
+    if (mapping)
+        munmap(mapping, mapping_size);
+}
+
+bool TraceReader::Open(const char *path) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(TraceHeader)) {
+        close(fd);
+        fprintf(stderr, "%s is not a trace\n", path);
+        return false;
+    }
+
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Can't map %s\n", path);
+        return false;
+    }
+    // Read front to back, once or a few times
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    if (mapping)
+        munmap(mapping, mapping_size);
+    mapping = map;
+    mapping_size = st.st_size;
+
+    return Open(static_cast<const unsigned char *>(map), st.st_size);
+}
+
+bool TraceReader::Open(const unsigned char *trace, size_t size) {
+    if (size < sizeof(TraceHeader))
+        return false;
+
+    memcpy(&header, trace, sizeof(TraceHeader));
+    if (memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != TRACE_VERSION ||
+        header.header_size < sizeof(TraceHeader) || header.header_size > size) {
+        fprintf(stderr, "Not a trace, or an unsupported version\n");
+        return false;
+    }
+    header.name[sizeof(header.name) - 1] = '\0';
+
+    data = trace;
+    end = trace + size;
+    Rewind();
+    return true;
+}
+
+void TraceReader::Rewind() {
+    cur = data + header.header_size;
+    time_us = header.start_us;
+    last_dt = 0;
+}
+
+static int ExtractSigned(const std::vector<unsigned char> &packet, int offset, int bits) {
+    long long value = 0;
+    for (int i = 0; i < bits; i++) {
+        int bit = offset + i;
+        if (bit / 8 < (int) packet.size() && (packet[bit / 8] >> (bit % 8)) & 1)
+            value |= 1ll << i;
+    }
+
+    // Sign extend
+    if (value & (1ll << (bits - 1)))
+        value -= 1ll << bits;
+
+    return static_cast<int>(value);
+}
+
+bool ConvertPacketDump(const char *path, const PacketLayout &layout, int rate, TraceWriter &writer) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+
+    uint64_t time_us = 1;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::vector<unsigned char> packet;
+        std::stringstream ss(line);
+        std::string byte;
+
+        try {
+            while (std::getline(ss, byte, ',')) {
+                if (byte.find_first_not_of(" \t\r") == std::string::npos)
+                    continue;
+                packet.push_back(static_cast<unsigned char>(std::stoul(byte, nullptr, 16)));
+            }
+        } catch (std::exception &ex) {
+            fprintf(stderr, "Bad packet in %s: %s\n", path, line.c_str());
+            return false;
+        }
+
+        if (packet.empty())
+            continue;
+
+        writer.Write(time_us, ExtractSigned(packet, layout.x_offset, layout.bits),
+                     ExtractSigned(packet, layout.y_offset, layout.bits));
+        time_us += 1000000 / rate;
+    }
+
+    return true;
+}
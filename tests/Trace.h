@@ -0,0 +1,157 @@
+#ifndef YEETMOUSE_TRACE_H
+#define YEETMOUSE_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+///
+/// Compact binary format for recorded mouse movement (.ymt)
+///
+/// A fixed header (TraceHeader) followed by the events, one per report (SYN_REPORT):
+///   varint  head  - zigzag(dt - previous dt) << 1 | packed, dt being the time since the previous event in µs
+///   packed == 1:  one byte, X in the low and Y in the high nibble (both in [-8, 7])
+///   packed == 0:  two zigzag varints, X and Y
+/// At a steady report rate with slow movement that's 2 bytes per event, 3-4 bytes for fast flicks,
+/// so an hour at 8 kHz stays well under 100 MB (and way less in practice, mice don't report when they don't move).
+///
+
+#define TRACE_MAGIC "YMTRACE"
+#define TRACE_VERSION 1
+
+struct TraceHeader {
+    char magic[8];          // TRACE_MAGIC
+    uint16_t version;       // TRACE_VERSION
+    uint16_t header_size;   // sizeof(TraceHeader), for forward compatibility
+    uint16_t vendor;
+    uint16_t product;
+    uint64_t start_us;      // Time of the first event (dt of the first event is relative to this)
+    uint64_t event_count;
+    char name[64];          // Device name, zero terminated
+};
+
+static_assert(sizeof(TraceHeader) == 96, "The trace header is a part of the file format");
+
+struct TraceEvent {
+    long long time_ns;
+    int x;
+    int y;
+};
+
+/// Where X and Y are in a raw HID report (see debug/hid_parser/)
+struct PacketLayout {
+    int x_offset = 8;   // In bits
+    int y_offset = 24;  // In bits
+    int bits = 16;
+};
+
+///
+/// Encodes events, either to a file (streamed out in chunks) or to memory
+///
+class TraceWriter {
+public:
+    /// Memory only, see Data()
+    explicit TraceWriter(const TraceHeader &header);
+    ~TraceWriter();
+
+    /// Streams the trace to 'path', returns false if the file can't be created
+    bool Open(const char *path, const TraceHeader &header);
+    /// Writes out the rest and fixes up the event count in the header
+    bool Close();
+
+    void Write(uint64_t time_us, int x, int y);
+
+    /// The whole trace (header included), when not writing to a file
+    const std::vector<unsigned char> &Data();
+    uint64_t Count() const { return header.event_count; }
+
+private:
+    void PutVarint(uint64_t value);
+    bool Flush();
+
+    TraceHeader header;
+    std::vector<unsigned char> buffer;
+    FILE *file = nullptr;
+    uint64_t last_us;
+    long long last_dt = 0;
+};
+
+///
+/// Decodes a trace straight from the (mmapped) file or from memory, no copies
+///
+class TraceReader {
+public:
+    TraceReader() = default;
+    ~TraceReader();
+    TraceReader(const TraceReader &) = delete;
+    TraceReader &operator=(const TraceReader &) = delete;
+
+    bool Open(const char *path);
+    bool Open(const unsigned char *data, size_t size);
+
+    const TraceHeader &Header() const { return header; }
+
+    /// Returns false at the end of the trace (or if it's corrupted)
+    inline bool Next(TraceEvent &event);
+    /// Back to the first event
+    void Rewind();
+
+private:
+    inline bool GetVarint(uint64_t &value);
+
+    TraceHeader header{};
+    const unsigned char *data = nullptr;
+    const unsigned char *cur = nullptr;
+    const unsigned char *end = nullptr;
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    uint64_t time_us = 0;
+    long long last_dt = 0;
+};
+
+/// Converts a text packet dump (debug/devices/packets/, one raw HID report per line as hex bytes).
+/// The dumps have no timestamps, so the reports are assumed to come at 'rate' Hz.
+bool ConvertPacketDump(const char *path, const PacketLayout &layout, int rate, TraceWriter &writer);
+
+inline long long ZigZagDecode(uint64_t value) {
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+inline bool TraceReader::GetVarint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; cur < end && shift < 64; shift += 7) {
+        unsigned char byte = *cur++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline bool TraceReader::Next(TraceEvent &event) {
+    uint64_t head, x, y;
+
+    if (cur >= end || !GetVarint(head))
+        return false;
+
+    last_dt += ZigZagDecode(head >> 1);
+    time_us += last_dt;
+    event.time_ns = static_cast<long long>(time_us) * 1000;
+
+    if (head & 1) {
+        if (cur >= end)
+            return false;
+        event.x = static_cast<signed char>(*cur << 4) >> 4;
+        event.y = static_cast<signed char>(*cur++) >> 4;
+        return true;
+    }
+
+    if (!GetVarint(x) || !GetVarint(y))
+        return false;
+    event.x = static_cast<int>(ZigZagDecode(x));
+    event.y = static_cast<int>(ZigZagDecode(y));
+    return true;
+}
+
+#endif //YEETMOUSE_TRACE_H
@@ -0,0 +1,403 @@
+// End-to-end benchmark of the loaded driver: creates a virtual mouse (uinput), injects motion into it at a fixed rate
+// (or replays a trace with its own timing) and reads the reports back from the mouse's evdev node, after the driver
+// had its go at them. Reports the latency (from the write into uinput to the read from evdev), the throughput and
+// how many reports got lost, first with the driver leaving the mouse alone (a 'passthrough' binding) and then with
+// the acceleration on, so the difference is what the driver adds. No physical mouse is needed, a VM is enough.
+//
+// Usage: YeetMouseUinputBench [-r rate_hz] [-t seconds] [-a amplitude] [-T trace.ymt] [-B]
+//   -r  report rate, 1000 Hz by default, up to 8000
+//   -t  how long every phase runs, in seconds (5 by default)
+//   -a  peak movement in a single report, in counts (20 by default), the motion goes around in circles of varying speed
+//   -T  replay a trace (see Trace.h and YeetMouseCapture) instead, the rate and amplitude come from the trace
+//   -B  skip the passthrough phase
+//   Needs root (uinput, and the driver's 'match_virtual' and 'bindings' parameters, restored at the end).
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <linux/input.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <sys/prctl.h>
+
+#include "Trace.h"
+
+#define PARAMS_DIR "/sys/module/yeetmouse/parameters/"
+#define MAX_RATE 8000
+
+// pid.codes test IDs, only used to bind the virtual mouse
+#define BENCH_VENDOR 0x1209
+#define BENCH_PRODUCT 0x0001
+#define BENCH_BINDING "1209:0001"
+#define BENCH_NAME "YeetMouse uinput bench"
+
+struct Report {
+    long long time_ns; // Sent (CLOCK_MONOTONIC, just before the write), or the evdev timestamp
+    long long read_ns; // Read back, received reports only
+    int x, y;
+};
+
+struct PhaseResult {
+    std::vector<Report> sent, received;
+    unsigned long long sync_dropped = 0; // SYN_DROPPED, the evdev buffer overflowed
+    long long max_lag_ns = 0;            // How late the writer got behind the schedule
+};
+
+static volatile sig_atomic_t stop = 0;
+
+static void OnSignal(int) {
+    stop = 1;
+}
+
+static long long Now() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static bool ReadParam(const char *name, std::string &value) {
+    std::ifstream file(std::string(PARAMS_DIR) + name);
+    if (!file.is_open())
+        return false;
+    std::stringstream ss;
+    ss << file.rdbuf();
+    value = ss.str();
+    return true;
+}
+
+// The driver parses the whole value at once, so it has to arrive in a single write
+static bool WriteParam(const char *name, const std::string &value) {
+    int fd = open((std::string(PARAMS_DIR) + name).c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    bool ok = write(fd, value.data(), value.size()) == (ssize_t) value.size();
+    close(fd);
+    if (!ok)
+        fprintf(stderr, "Can't write '%s' (%s, see dmesg)\n", name, strerror(errno));
+    return ok;
+}
+
+static int CreateMouse() {
+    int fd = open("/dev/uinput", O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fprintf(stderr, "Can't open /dev/uinput (%s), is the module loaded, are you root?\n", strerror(errno));
+        return -1;
+    }
+
+    // Has to look like a mouse to the driver (see driver_match())
+    ioctl(fd, UI_SET_EVBIT, EV_KEY);
+    ioctl(fd, UI_SET_KEYBIT, BTN_LEFT);
+    ioctl(fd, UI_SET_KEYBIT, BTN_RIGHT);
+    ioctl(fd, UI_SET_KEYBIT, BTN_MIDDLE);
+    ioctl(fd, UI_SET_EVBIT, EV_REL);
+    ioctl(fd, UI_SET_RELBIT, REL_X);
+    ioctl(fd, UI_SET_RELBIT, REL_Y);
+    ioctl(fd, UI_SET_RELBIT, REL_WHEEL);
+
+    uinput_setup setup{};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = BENCH_VENDOR;
+    setup.id.product = BENCH_PRODUCT;
+    strncpy(setup.name, BENCH_NAME, sizeof(setup.name) - 1);
+
+    if (ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+        fprintf(stderr, "Can't create the virtual mouse (%s)\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// The evdev node of the virtual mouse, from /sys/devices/virtual/input/inputN/
+static std::string FindEventNode(int uinput_fd) {
+    char sysname[64] = {};
+    if (ioctl(uinput_fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0)
+        return {};
+
+    std::string dir = std::string("/sys/devices/virtual/input/") + sysname;
+    std::string node;
+    // udev may still be creating it
+    for (int tries = 0; tries < 100 && node.empty(); tries++) {
+        if (DIR *d = opendir(dir.c_str())) {
+            while (dirent *entry = readdir(d)) {
+                if (strncmp(entry->d_name, "event", 5) == 0)
+                    node = std::string("/dev/input/") + entry->d_name;
+            }
+            closedir(d);
+        }
+        if (node.empty() || access(node.c_str(), R_OK) != 0) {
+            node.clear();
+            usleep(10000);
+        }
+    }
+    return node;
+}
+
+// The driver's handle shows up in the device's handlers
+static bool IsBound() {
+    std::ifstream file("/proc/bus/input/devices");
+    std::string line;
+    bool ours = false;
+
+    while (std::getline(file, line)) {
+        if (line.rfind("N: Name=", 0) == 0)
+            ours = line.find(BENCH_NAME) != std::string::npos;
+        else if (ours && line.rfind("H: Handlers=", 0) == 0)
+            return line.find("yeetmouse") != std::string::npos;
+    }
+    return false;
+}
+
+static void Reader(int fd, std::atomic<bool> &done, PhaseResult &result) {
+    input_event events[64];
+    Report report{};
+
+    while (!done.load(std::memory_order_relaxed)) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 20) <= 0)
+            continue;
+
+        ssize_t size = read(fd, events, sizeof(events));
+        long long read_ns = Now();
+        if (size < 0)
+            continue;
+
+        for (size_t i = 0; i < size / sizeof(input_event); i++) {
+            const input_event &ev = events[i];
+
+            if (ev.type == EV_REL && ev.code == REL_X)
+                report.x += ev.value;
+            else if (ev.type == EV_REL && ev.code == REL_Y)
+                report.y += ev.value;
+            else if (ev.type == EV_SYN && ev.code == SYN_DROPPED)
+                result.sync_dropped++;
+            else if (ev.type == EV_SYN && ev.code == SYN_REPORT) {
+                report.time_ns = ev.input_event_sec * 1000000000ll + ev.input_event_usec * 1000ll;
+                report.read_ns = read_ns;
+                result.received.push_back(report);
+                report = {};
+            }
+        }
+    }
+}
+
+static bool Send(int fd, int x, int y) {
+    input_event events[3]{};
+    events[0].type = EV_REL, events[0].code = REL_X, events[0].value = x;
+    events[1].type = EV_REL, events[1].code = REL_Y, events[1].value = y;
+    events[2].type = EV_SYN, events[2].code = SYN_REPORT;
+    // A single write, so the whole report is processed (and timestamped) in one go
+    return write(fd, events, sizeof(events)) == sizeof(events);
+}
+
+// Runs one phase: the motion goes out on this thread, the reports are read back on another one
+static PhaseResult RunPhase(int uinput_fd, int event_fd, const std::vector<Report> &motion) {
+    PhaseResult result;
+    result.sent.reserve(motion.size());
+    result.received.reserve(motion.size());
+
+    // Drop whatever is still queued
+    input_event flush[64];
+    while (read(event_fd, flush, sizeof(flush)) > 0);
+
+    std::atomic<bool> done{false};
+    std::thread reader(Reader, event_fd, std::ref(done), std::ref(result));
+
+    long long start = Now() + 10000000; // Give the reader a moment
+    for (const Report &m: motion) {
+        if (stop)
+            break;
+
+        long long due = start + m.time_ns;
+        timespec ts{static_cast<time_t>(due / 1000000000), static_cast<long>(due % 1000000000)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR && !stop);
+
+        long long now = Now();
+        result.max_lag_ns = std::max(result.max_lag_ns, now - due);
+        if (!Send(uinput_fd, m.x, m.y)) {
+            fprintf(stderr, "Can't write into uinput (%s)\n", strerror(errno));
+            break;
+        }
+        result.sent.push_back({now, 0, m.x, m.y});
+    }
+
+    // Stragglers
+    usleep(100000);
+    done = true;
+    reader.join();
+    return result;
+}
+
+static bool PrintPhase(const char *name, const PhaseResult &result, std::vector<long long> &latencies) {
+    const auto &sent = result.sent;
+    latencies.clear();
+    if (sent.empty() || result.received.empty()) {
+        printf("%s: %zu reports sent, nothing received\n", name, sent.size());
+        return false;
+    }
+
+    // The evdev timestamp is taken in the middle of the write, so a report belongs to the last one sent before it
+    double in = 0, out = 0;
+    for (const Report &r: result.received) {
+        auto it = std::upper_bound(sent.begin(), sent.end(), r.time_ns,
+                                   [](long long t, const Report &s) { return t < s.time_ns; });
+        if (it == sent.begin())
+            continue;
+        --it;
+        latencies.push_back(r.read_ns - it->time_ns);
+        in += std::hypot(it->x, it->y);
+        out += std::hypot(r.x, r.y);
+    }
+    if (latencies.empty()) {
+        printf("%s: no report could be matched\n", name);
+        return false;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))] / 1000.0;
+    };
+    double seconds = (result.received.back().read_ns - sent.front().time_ns) / 1e9;
+    long long lost = static_cast<long long>(sent.size()) - static_cast<long long>(result.received.size());
+
+    printf("%s: %zu reports sent, %zu received (%lld lost, %llu evdev overflows)\n", name, sent.size(),
+           result.received.size(), std::max(0ll, lost), result.sync_dropped);
+    printf("  %.0f reports/s, writer at most %.1f us behind, output/input movement %.3f\n",
+           result.received.size() / seconds, result.max_lag_ns / 1000.0, in > 0 ? out / in : 0.0);
+    printf("  latency [us]: p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n", percentile(0.5), percentile(0.9),
+           percentile(0.99), percentile(0.999), latencies.back() / 1000.0);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int rate = 1000;
+    double seconds = 5;
+    int amplitude = 20;
+    const char *trace_path = nullptr;
+    bool baseline = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:t:a:T:Bh")) != -1) {
+        switch (opt) {
+            case 'r': rate = std::clamp(atoi(optarg), 1, MAX_RATE); break;
+            case 't': seconds = std::max(0.1, atof(optarg)); break;
+            case 'a': amplitude = std::max(1, atoi(optarg)); break;
+            case 'T': trace_path = optarg; break;
+            case 'B': baseline = false; break;
+            default:
+                fprintf(stderr, "Usage: %s [-r rate_hz] [-t seconds] [-a amplitude] [-T trace.ymt] [-B]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    // The motion, with the times relative to the start
+    std::vector<Report> motion;
+    if (trace_path) {
+        TraceReader trace;
+        TraceEvent event{};
+        if (!trace.Open(trace_path) || !trace.Next(event))
+            return 1;
+        long long first = event.time_ns;
+        do {
+            if (event.x != 0 || event.y != 0)
+                motion.push_back({event.time_ns - first, 0, event.x, event.y});
+        } while (trace.Next(event));
+    } else {
+        // Circles, speeding up and slowing down every second, so the whole curve gets used
+        long long count = static_cast<long long>(seconds * rate);
+        for (long long i = 0; i < count; i++) {
+            double t = static_cast<double>(i) / rate;
+            double speed = amplitude * (0.55 + 0.45 * std::sin(2 * M_PI * t));
+            int x = static_cast<int>(std::lround(speed * std::cos(2 * M_PI * 3 * t)));
+            int y = static_cast<int>(std::lround(speed * std::sin(2 * M_PI * 3 * t)));
+            if (x == 0 && y == 0)
+                x = 1;
+            motion.push_back({i * 1000000000ll / rate, 0, x, y});
+        }
+    }
+
+    std::string match_virtual, bindings;
+    if (!ReadParam("match_virtual", match_virtual) || !ReadParam("bindings", bindings)) {
+        fprintf(stderr, "The driver is not loaded (or too old, it needs 'match_virtual')\n");
+        return 1;
+    }
+    // Sleeps have to be precise at 8 kHz
+    prctl(PR_SET_TIMERSLACK, 1);
+
+    struct sigaction sa{};
+    sa.sa_handler = OnSignal;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    // Checked when the device connects
+    if (!WriteParam("match_virtual", "1"))
+        return 1;
+
+    int status = 1;
+    int uinput_fd = CreateMouse();
+    int event_fd = -1;
+    std::string node = uinput_fd >= 0 ? FindEventNode(uinput_fd) : std::string();
+
+    if (uinput_fd >= 0 && node.empty())
+        fprintf(stderr, "Can't find the event node of the virtual mouse\n");
+    else if (uinput_fd >= 0 && (event_fd = open(node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0)
+        fprintf(stderr, "Can't open %s (%s)\n", node.c_str(), strerror(errno));
+    else if (event_fd >= 0 && !IsBound())
+        fprintf(stderr, "The driver didn't bind to the virtual mouse (see dmesg)\n");
+    else if (event_fd >= 0) {
+        // Same clock as the writer
+        int clock = CLOCK_MONOTONIC;
+        ioctl(event_fd, EVIOCSCLOCKID, &clock);
+
+        printf("Virtual mouse %04x:%04x at %s, %zu reports per phase\n", BENCH_VENDOR, BENCH_PRODUCT, node.c_str(),
+               motion.size());
+
+        // The first matching binding wins, the others stay as they were
+        std::vector<long long> base_latencies, latencies;
+        bool have_base = false;
+        if (baseline && WriteParam("bindings", BENCH_BINDING "=off\n" + bindings))
+            have_base = PrintPhase("passthrough", RunPhase(uinput_fd, event_fd, motion), base_latencies);
+
+        if (!stop && WriteParam("bindings", BENCH_BINDING "=active\n" + bindings) &&
+            PrintPhase("accelerated", RunPhase(uinput_fd, event_fd, motion), latencies)) {
+            status = 0;
+
+            if (have_base) {
+                auto diff = [&](double p) {
+                    auto at = [p](const std::vector<long long> &l) {
+                        return l[std::min(l.size() - 1, static_cast<size_t>(p * l.size()))];
+                    };
+                    return (at(latencies) - at(base_latencies)) / 1000.0;
+                };
+                printf("added by the driver [us]: p50 %+.1f, p90 %+.1f, p99 %+.1f, p99.9 %+.1f\n", diff(0.5), diff(0.9),
+                       diff(0.99), diff(0.999));
+            }
+        }
+    }
+
+    if (event_fd >= 0)
+        close(event_fd);
+    if (uinput_fd >= 0) {
+        ioctl(uinput_fd, UI_DEV_DESTROY);
+        close(uinput_fd);
+    }
+    // An empty write clears the bindings
+    WriteParam("bindings", bindings.empty() ? "\n" : bindings);
+    WriteParam("match_virtual", match_virtual);
+
+    return status;
+}
@@ -1,9 +1,29 @@
 #include <iostream>
+#include <unistd.h>
 
 #include "TestManager.h"
 #include "Tests.h"
+#include "ThreadPool.h"
+
+int main(int argc, char **argv) {
+    unsigned threads = 0; // One per hardware thread
+    int density = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:d:h")) != -1) {
+        switch (opt) {
+            case 'j':
+                threads = std::max(0, atoi(optarg));
+                break;
+            case 'd':
+                density = std::max(1, atoi(optarg));
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-j threads] [-d sweep_density]\n", argv[0]);
+                return 1;
+        }
+    }
 
-int main() {
     Tests::Initialize();
     TestManager::Initialize();
 
@@ -17,8 +37,64 @@ int main() {
         }
     }
 
+    if (!Tests::TestRegressions()) {
+        fprintf(stderr, "Regression test failed\n");
+        bad_sum++;
+    }
+
     bool arithmetic_test = Tests::TestFixedPointArithmetic();
 
+    if (!Tests::TestParameterInterface()) {
+        fprintf(stderr, "Parameter interface test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestProfileVerifier()) {
+        fprintf(stderr, "Profile verifier test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestNarrowKernels()) {
+        fprintf(stderr, "Narrow kernel test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestFixedProfile()) {
+        fprintf(stderr, "Fixed profile test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestFunctionBatch()) {
+        fprintf(stderr, "Function batch test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestAdaptiveSampling()) {
+        fprintf(stderr, "Adaptive sampling test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestCurveWorker()) {
+        fprintf(stderr, "Curve worker test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestCurveLUTExport()) {
+        fprintf(stderr, "Curve LUT export test failed\n");
+        bad_sum++;
+    }
+
+    if (!Tests::TestCurveTessellation()) {
+        fprintf(stderr, "Curve tessellation test failed\n");
+        bad_sum++;
+    }
+
+    ThreadPool pool(threads);
+    if (!Tests::TestSweeps(pool, density)) {
+        fprintf(stderr, "Parameter sweeps failed\n");
+        bad_sum++;
+    }
+
     if (bad_sum == 0 && arithmetic_test) {
         printf(GREEN"All tests passed!\n\n" RESET);
     } else {